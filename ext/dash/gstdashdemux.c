@@ -492,7 +492,6 @@ gst_dash_demux_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GstClockTime current_pos, target_pos;
       guint current_sequence, current_period;
       GstActiveStream *active_stream;
-      GstMediaSegment *chunk;
       GstStreamPeriod *period;
       GSList *iter;
       gboolean update;
@@ -579,30 +578,16 @@ gst_dash_demux_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         /* Update the current sequence on all streams */
         for (iter = demux->streams; iter; iter = g_slist_next (iter)) {
           GstDashDemuxStream *stream = iter->data;
-          gint seg_i;
 
           active_stream =
               gst_mpdparser_get_active_stream_by_index (demux->client,
               stream->index);
-          current_pos = 0;
-          current_sequence = 0;
-          for (seg_i = 0; seg_i < active_stream->segments->len; seg_i++) {
-            chunk = g_ptr_array_index (active_stream->segments, seg_i);
-            current_pos = chunk->start_time;
-            /* current_sequence = chunk->number; */
-            GST_DEBUG_OBJECT (demux, "current_pos:%" GST_TIME_FORMAT
-                " <= target_pos:%" GST_TIME_FORMAT " duration:%"
-                GST_TIME_FORMAT, GST_TIME_ARGS (current_pos),
-                GST_TIME_ARGS (target_pos), GST_TIME_ARGS (chunk->duration));
-            if (current_pos <= target_pos
-                && target_pos < current_pos + chunk->duration) {
-              GST_DEBUG_OBJECT (demux,
-                  "selecting sequence %d for stream %" GST_PTR_FORMAT,
-                  current_sequence, stream);
-              break;
-            }
-            current_sequence++;
-          }
+          current_sequence =
+              gst_mpd_client_get_segment_index_for_timestamp (active_stream,
+              target_pos);
+          GST_DEBUG_OBJECT (demux,
+              "selecting sequence %d for stream %" GST_PTR_FORMAT,
+              current_sequence, stream);
           gst_mpd_client_set_segment_index (active_stream, current_sequence);
         }
 
@@ -1512,6 +1497,14 @@ gst_dash_demux_refresh_mpd (GstDashDemux * demux)
 
           GST_DEBUG_OBJECT (demux, "Updating manifest");
 
+          /* merge the new manifest into the current one, only appending the
+           * new segments to the active streams */
+          if (gst_mpd_client_update (demux->client, new_client)) {
+            GST_DEBUG_OBJECT (demux, "Manifest merged into the current one");
+            gst_mpd_client_free (new_client);
+            goto updated;
+          }
+
           period_id = gst_mpd_client_get_period_id (demux->client);
           period_idx = gst_mpd_client_get_period_index (demux->client);
 
@@ -1567,6 +1560,7 @@ gst_dash_demux_refresh_mpd (GstDashDemux * demux)
           gst_mpd_client_free (demux->client);
           demux->client = new_client;
 
+        updated:
           /* Send an updated duration message */
           duration =
               gst_mpd_client_get_media_presentation_duration (demux->client);
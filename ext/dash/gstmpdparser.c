@@ -131,8 +131,14 @@ static const gchar *gst_mpdparser_get_initializationURL (
 static gchar *gst_mpdparser_build_URL_from_template (const gchar * url_template,
     const gchar * id, guint number, guint bandwidth, guint64 time);
 static gboolean gst_mpd_client_add_media_segment (GstActiveStream * stream,
-    GstSegmentURLNode * url_node, guint number, guint64 start,
-    GstClockTime start_time, GstClockTime duration);
+    GstSegmentURLNode * url_node, guint number, gint repeat, guint64 start,
+    guint64 scale_duration, GstClockTime start_time, GstClockTime duration);
+static gint gst_mpdparser_find_segment_run (GstActiveStream * stream,
+    guint index);
+static gboolean gst_mpdparser_get_segment (GstActiveStream * stream,
+    guint index, GstMediaSegment * segment);
+static void gst_mpdparser_clip_last_segment (GstActiveStream * stream,
+    GstClockTime PeriodEnd);
 static const gchar *gst_mpdparser_mimetype_to_caps (const gchar * mimeType);
 static GstClockTime gst_mpd_client_get_segment_duration (GstMpdClient * client,
     GstActiveStream * stream);
@@ -168,9 +174,20 @@ static GstSegmentBaseType *gst_mpdparser_get_segment_base (GstPeriodNode *
 static GstSegmentListNode *gst_mpdparser_get_segment_list (GstPeriodNode *
     Period, GstAdaptationSetNode * AdaptationSet,
     GstRepresentationNode * Representation);
+static GstSegmentTemplateNode *gst_mpdparser_get_segment_template (GstPeriodNode
+    * Period, GstAdaptationSetNode * AdaptationSet,
+    GstRepresentationNode * Representation);
+static GstStreamPeriod *gst_mpdparser_find_matching_period (GList * periods,
+    GstStreamPeriod * old_period, guint * period_idx);
+static GstRepresentationNode *gst_mpdparser_find_matching_representation (GList
+    * Representations, GstRepresentationNode * old_rep, gint old_idx);
+static gboolean gst_mpd_client_merge_segment_timeline (GstActiveStream * stream,
+    GstStreamPeriod * stream_period);
 
 /* Segments */
 static guint gst_mpd_client_get_segments_counts (GstActiveStream * stream);
+static gboolean gst_mpd_client_stream_seek_unlocked (GstMpdClient * client,
+    GstActiveStream * stream, GstClockTime ts);
 
 /* Memory management */
 static GstSegmentTimelineNode *
@@ -3013,17 +3030,9 @@ gst_mpdparser_get_chunk_by_index (GstMpdClient * client, guint indexStream,
   g_return_val_if_fail (stream != NULL, FALSE);
 
   if (stream->segments) {
-    GstMediaSegment *list_segment;
     /* fixed list of segments */
-    if (indexChunk >= stream->segments->len)
+    if (!gst_mpdparser_get_segment (stream, indexChunk, segment))
       return FALSE;
-
-    list_segment = g_ptr_array_index (stream->segments, indexChunk);
-    segment->SegmentURL = list_segment->SegmentURL;
-    segment->number = list_segment->number;
-    segment->start = list_segment->start;
-    segment->start_time = list_segment->start_time;
-    segment->duration = list_segment->duration;
   } else {
     GstClockTime duration;
     guint timescale =
@@ -3038,6 +3047,7 @@ gst_mpdparser_get_chunk_by_index (GstMpdClient * client, guint indexStream,
     /* TODO check PeriodEnd for segment beyond end of period */
 
     segment->number = indexChunk;
+    segment->repeat = 0;
     segment->start_time = duration * indexChunk;
     segment->start_time = segment->start_time * timescale / GST_SECOND;
     segment->duration = duration;
@@ -3048,8 +3058,8 @@ gst_mpdparser_get_chunk_by_index (GstMpdClient * client, guint indexStream,
 
 static gboolean
 gst_mpd_client_add_media_segment (GstActiveStream * stream,
-    GstSegmentURLNode * url_node, guint number, guint64 start,
-    GstClockTime start_time, GstClockTime duration)
+    GstSegmentURLNode * url_node, guint number, gint repeat, guint64 start,
+    guint64 scale_duration, GstClockTime start_time, GstClockTime duration)
 {
   GstMediaSegment *media_segment;
 
@@ -3063,7 +3073,9 @@ gst_mpd_client_add_media_segment (GstActiveStream * stream,
 
   media_segment->SegmentURL = url_node;
   media_segment->number = number;
+  media_segment->repeat = repeat;
   media_segment->start = start;
+  media_segment->scale_duration = scale_duration;
   media_segment->start_time = start_time;
   media_segment->duration = duration;
 
@@ -3072,6 +3084,106 @@ gst_mpd_client_add_media_segment (GstActiveStream * stream,
   return TRUE;
 }
 
+/* The segments of a stream are stored run-length encoded: each
+ * GstMediaSegment stands for repeat + 1 consecutive segments of the same
+ * duration, like the S nodes of a SegmentTimeline. Segment numbers are
+ * contiguous over the whole array, so the run holding a segment index is
+ * found by bisection on the numbers. */
+static gint
+gst_mpdparser_find_segment_run (GstActiveStream * stream, guint index)
+{
+  GstMediaSegment *first, *run;
+  guint number, low, high, mid;
+
+  if (stream->segments == NULL || stream->segments->len == 0)
+    return -1;
+
+  first = g_ptr_array_index (stream->segments, 0);
+  number = first->number + index;
+  low = 0;
+  high = stream->segments->len;
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    run = g_ptr_array_index (stream->segments, mid);
+
+    if (number < run->number)
+      high = mid;
+    else if (number > run->number + run->repeat)
+      low = mid + 1;
+    else
+      return mid;
+  }
+
+  return -1;
+}
+
+/* expands the segment at @index into @segment */
+static gboolean
+gst_mpdparser_get_segment (GstActiveStream * stream, guint index,
+    GstMediaSegment * segment)
+{
+  GstMediaSegment *first, *run;
+  guint offset;
+  gint run_idx;
+
+  run_idx = gst_mpdparser_find_segment_run (stream, index);
+  if (run_idx < 0)
+    return FALSE;
+
+  first = g_ptr_array_index (stream->segments, 0);
+  run = g_ptr_array_index (stream->segments, run_idx);
+  offset = first->number + index - run->number;
+
+  segment->SegmentURL = run->SegmentURL;
+  segment->number = run->number + offset;
+  segment->repeat = 0;
+  segment->start = run->start + offset * run->scale_duration;
+  segment->scale_duration = run->scale_duration;
+  segment->start_time = run->start_time + offset * run->duration;
+  segment->duration = run->duration;
+
+  return TRUE;
+}
+
+/* cuts the last segment so that it doesn't go beyond the Period end */
+static void
+gst_mpdparser_clip_last_segment (GstActiveStream * stream,
+    GstClockTime PeriodEnd)
+{
+  GstMediaSegment *last_media_segment;
+  GstClockTime start_time;
+
+  if (!GST_CLOCK_TIME_IS_VALID (PeriodEnd) || stream->segments == NULL
+      || stream->segments->len == 0)
+    return;
+
+  last_media_segment =
+      g_ptr_array_index (stream->segments, stream->segments->len - 1);
+  start_time = last_media_segment->start_time +
+      last_media_segment->repeat * last_media_segment->duration;
+  if (start_time + last_media_segment->duration <= PeriodEnd)
+    return;
+
+  if (last_media_segment->repeat > 0) {
+    /* split the last segment out of its run */
+    last_media_segment->repeat--;
+    if (!gst_mpd_client_add_media_segment (stream,
+            last_media_segment->SegmentURL,
+            last_media_segment->number + last_media_segment->repeat + 1, 0,
+            last_media_segment->start + (last_media_segment->repeat + 1) *
+            last_media_segment->scale_duration,
+            last_media_segment->scale_duration, start_time,
+            last_media_segment->duration))
+      return;
+    last_media_segment =
+        g_ptr_array_index (stream->segments, stream->segments->len - 1);
+  }
+
+  last_media_segment->duration = PeriodEnd - start_time;
+  GST_LOG ("Fixed duration of last segment: %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (last_media_segment->duration));
+}
+
 gboolean
 gst_mpd_client_setup_representation (GstMpdClient * client,
     GstActiveStream * stream, GstRepresentationNode * representation)
@@ -3079,7 +3191,6 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
   GstStreamPeriod *stream_period;
   GList *rep_list;
   GstClockTime PeriodStart, PeriodEnd, start_time, duration;
-  GstMediaSegment *last_media_segment;
   guint i;
   guint64 start;
 
@@ -3132,8 +3243,8 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
                 stream->cur_adapt_set, representation)) == NULL) {
       GST_DEBUG ("No useful SegmentList node for the current Representation");
       /* here we should have a single segment for each representation, whose URL is encoded in the baseURL element */
-      if (!gst_mpd_client_add_media_segment (stream, NULL, 1, 0, PeriodStart,
-              PeriodEnd)) {
+      if (!gst_mpd_client_add_media_segment (stream, NULL, 1, 0, 0, 0,
+              PeriodStart, PeriodEnd)) {
         return FALSE;
       }
     } else {
@@ -3177,7 +3288,7 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
 
           for (j = 0; j <= S->r && SegmentURL != NULL; j++) {
             if (!gst_mpd_client_add_media_segment (stream, SegmentURL->data, i,
-                    start, start_time, duration)) {
+                    0, start, S->d, start_time, duration)) {
               return FALSE;
             }
             i++;
@@ -3193,7 +3304,7 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
 
         while (SegmentURL) {
           if (!gst_mpd_client_add_media_segment (stream, SegmentURL->data, i, 0,
-                  start_time, duration)) {
+                  0, 0, start_time, duration)) {
             return FALSE;
           }
           i++;
@@ -3216,7 +3327,8 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
 
       gst_mpdparser_init_active_stream_segments (stream);
       /* here we should have a single segment for each representation, whose URL is encoded in the baseURL element */
-      if (!gst_mpd_client_add_media_segment (stream, NULL, 1, 0, 0, PeriodEnd)) {
+      if (!gst_mpd_client_add_media_segment (stream, NULL, 1, 0, 0, 0, 0,
+              PeriodEnd)) {
         return FALSE;
       }
     } else {
@@ -3235,7 +3347,7 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
         timeline = stream->cur_seg_template->MultSegBaseType->SegmentTimeline;
         gst_mpdparser_init_active_stream_segments (stream);
         for (list = g_queue_peek_head_link (&timeline->S); list; list = g_list_next (list)) {
-          guint j, timescale;
+          guint timescale;
 
           S = (GstSNode *) list->data;
           GST_LOG ("Processing S node: d=%" G_GUINT64_FORMAT " r=%u t=%"
@@ -3252,15 +3364,14 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
               start_time /= timescale;
           }
 
-          for (j = 0; j <= S->r; j++) {
-            if (!gst_mpd_client_add_media_segment (stream, NULL, i, start,
-                    start_time, duration)) {
-              return FALSE;
-            }
-            i++;
-            start += S->d;
-            start_time += duration;
+          /* one run per S node, the segments are expanded on demand */
+          if (!gst_mpd_client_add_media_segment (stream, NULL, i, S->r, start,
+                  S->d, start_time, duration)) {
+            return FALSE;
           }
+          i += S->r + 1;
+          start += (guint64) (S->r + 1) * S->d;
+          start_time += (S->r + 1) * duration;
         }
       } else {
         /* NOP - The segment is created on demand with the template, no need
@@ -3270,17 +3381,10 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
   }
 
   /* check duration of last segment */
-  last_media_segment = (stream->segments && stream->segments->len) ?
-      g_ptr_array_index (stream->segments, stream->segments->len - 1) : NULL;
-
-  if (last_media_segment && GST_CLOCK_TIME_IS_VALID (PeriodEnd)) {
-    if (last_media_segment->start_time + last_media_segment->duration >
-        PeriodEnd) {
-      last_media_segment->duration = PeriodEnd - last_media_segment->start_time;
-      GST_LOG ("Fixed duration of last segment: %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (last_media_segment->duration));
-    }
-    GST_LOG ("Built a list of %d segments", last_media_segment->number);
+  if (stream->segments && GST_CLOCK_TIME_IS_VALID (PeriodEnd)) {
+    gst_mpdparser_clip_last_segment (stream, PeriodEnd);
+    GST_LOG ("Built a list of %u segments",
+        gst_mpd_client_get_segments_counts (stream));
   }
 
   g_free (stream->baseURL);
@@ -3291,6 +3395,372 @@ gst_mpd_client_setup_representation (GstMpdClient * client,
   return TRUE;
 }
 
+static GstSegmentTemplateNode *
+gst_mpdparser_get_segment_template (GstPeriodNode * Period,
+    GstAdaptationSetNode * AdaptationSet,
+    GstRepresentationNode * Representation)
+{
+  if (Representation && Representation->SegmentTemplate)
+    return Representation->SegmentTemplate;
+  if (AdaptationSet && AdaptationSet->SegmentTemplate)
+    return AdaptationSet->SegmentTemplate;
+  if (Period)
+    return Period->SegmentTemplate;
+
+  return NULL;
+}
+
+static GstStreamPeriod *
+gst_mpdparser_find_matching_period (GList * periods,
+    GstStreamPeriod * old_period, guint * period_idx)
+{
+  GList *list;
+  guint idx;
+
+  /* in a live presentation old Periods disappear from the head of the list,
+   * so match by id first, then by start time */
+  for (list = periods, idx = 0; list; list = g_list_next (list), idx++) {
+    GstStreamPeriod *stream_period = list->data;
+
+    if (old_period->period->id) {
+      if (g_strcmp0 (stream_period->period->id, old_period->period->id) != 0)
+        continue;
+    } else if (stream_period->start != old_period->start) {
+      continue;
+    }
+    *period_idx = idx;
+    return stream_period;
+  }
+
+  return NULL;
+}
+
+static GstRepresentationNode *
+gst_mpdparser_find_matching_representation (GList * Representations,
+    GstRepresentationNode * old_rep, gint old_idx)
+{
+  GList *list;
+
+  if (old_rep->id == NULL)
+    return g_list_nth_data (Representations, old_idx);
+
+  for (list = Representations; list; list = g_list_next (list)) {
+    GstRepresentationNode *rep = list->data;
+
+    if (g_strcmp0 (rep->id, old_rep->id) == 0)
+      return rep;
+  }
+
+  return NULL;
+}
+
+/* appends the S entries of the new SegmentTimeline that are later than the
+ * last known segment and drops the segments that fell out of the window;
+ * the segments that are still valid are kept as they are, so the stream
+ * position is preserved */
+static gboolean
+gst_mpd_client_merge_segment_timeline (GstActiveStream * stream,
+    GstStreamPeriod * stream_period)
+{
+  GstMultSegmentBaseType *base = stream->cur_seg_template->MultSegBaseType;
+  GstMediaSegment *last_media_segment, *run;
+  GstClockTime start_time, duration;
+  guint64 start, first_start, last_start, skip;
+  guint number, timescale, runs, removed = 0, added = 0;
+  GList *list;
+
+  if (base->SegBaseType == NULL || stream->segments == NULL
+      || stream->segments->len == 0)
+    return FALSE;
+
+  last_media_segment =
+      g_ptr_array_index (stream->segments, stream->segments->len - 1);
+  last_start = last_media_segment->start +
+      (guint64) last_media_segment->repeat * last_media_segment->scale_duration;
+  /* keep the numbering contiguous, whatever the startNumber of the update */
+  number = last_media_segment->number + last_media_segment->repeat + 1;
+  timescale = base->SegBaseType->timescale;
+
+  start = 0;
+  first_start = G_MAXUINT64;
+  start_time = stream_period->start;
+
+  for (list = g_queue_peek_head_link (&base->SegmentTimeline->S); list;
+      list = g_list_next (list)) {
+    GstSNode *S = (GstSNode *) list->data;
+
+    duration = S->d * GST_SECOND;
+    if (timescale > 1)
+      duration /= timescale;
+    if (S->t > 0) {
+      start = S->t;
+      start_time = S->t * GST_SECOND;
+      if (timescale > 1)
+        start_time /= timescale;
+    }
+    if (first_start == G_MAXUINT64)
+      first_start = start;
+
+    if (start + (guint64) S->r * S->d > last_start) {
+      /* skip the part of the run that is already known */
+      skip = 0;
+      if (start <= last_start)
+        skip = (last_start - start) / S->d + 1;
+
+      if (!gst_mpd_client_add_media_segment (stream, NULL, number,
+              S->r - skip, start + skip * S->d, S->d,
+              start_time + skip * duration, duration))
+        return FALSE;
+      number += S->r + 1 - skip;
+      added += S->r + 1 - skip;
+    }
+
+    start += (guint64) (S->r + 1) * S->d;
+    start_time += (S->r + 1) * duration;
+  }
+
+  /* drop the segments that are no longer part of the timeline */
+  for (runs = 0; runs < stream->segments->len; runs++) {
+    run = g_ptr_array_index (stream->segments, runs);
+    if (run->start + (guint64) run->repeat * run->scale_duration >= first_start)
+      break;
+    removed += run->repeat + 1;
+  }
+  if (runs)
+    g_ptr_array_remove_range (stream->segments, 0, runs);
+  if (stream->segments->len) {
+    run = g_ptr_array_index (stream->segments, 0);
+    if (run->start < first_start) {
+      skip = (first_start - run->start + run->scale_duration - 1) /
+          run->scale_duration;
+      run->number += skip;
+      run->repeat -= skip;
+      run->start += skip * run->scale_duration;
+      run->start_time += skip * run->duration;
+      removed += skip;
+    }
+  }
+  if (removed) {
+    if (stream->segment_idx > removed)
+      stream->segment_idx -= removed;
+    else
+      stream->segment_idx = 0;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (stream_period->duration))
+    gst_mpdparser_clip_last_segment (stream,
+        stream_period->start + stream_period->duration);
+
+  GST_LOG ("Merged SegmentTimeline: %u segments added, %u removed, %u total",
+      added, removed, gst_mpd_client_get_segments_counts (stream));
+
+  return TRUE;
+}
+
+/* an active stream mapped onto the nodes of an updated MPD */
+typedef struct
+{
+  GstActiveStream *stream;
+  GstAdaptationSetNode *adapt_set;
+  GstRepresentationNode *representation;
+  /* the segments are merged into the ones of the stream */
+  gboolean merge;
+  /* the segments built from scratch, NULL if they are merged or kept */
+  GstActiveStream *rebuilt;
+  /* the position to seek back to in the rebuilt segments */
+  GstClockTime ts;
+} GstMpdStreamUpdate;
+
+/* Moves the tree of a freshly parsed @new_client into @client, keeping the
+ * active streams, their selected representations and their segment lists.
+ * On success @new_client is left empty and only has to be freed; on failure
+ * @client is untouched and the caller has to set up a new client instead */
+gboolean
+gst_mpd_client_update (GstMpdClient * client, GstMpdClient * new_client)
+{
+  GstStreamPeriod *old_period, *new_period;
+  GstMpdStreamUpdate *updates;
+  guint new_period_idx = 0;
+  guint i, n_streams;
+  GList *list;
+
+  g_return_val_if_fail (client != NULL, FALSE);
+  g_return_val_if_fail (new_client != NULL, FALSE);
+  g_return_val_if_fail (new_client->mpd_node != NULL, FALSE);
+
+  if (client->active_streams == NULL)
+    return FALSE;
+
+  if (!gst_mpd_client_setup_media_presentation (new_client))
+    return FALSE;
+
+  GST_MPD_CLIENT_LOCK (client);
+  old_period = gst_mpdparser_get_stream_period (client);
+  if (old_period == NULL || old_period->period == NULL)
+    goto no_match;
+
+  new_period = gst_mpdparser_find_matching_period (new_client->periods,
+      old_period, &new_period_idx);
+  if (new_period == NULL) {
+    GST_DEBUG ("Current Period not found in the updated MPD");
+    goto no_match;
+  }
+  /* the segments that can not be merged are built from the new tree */
+  new_client->period_idx = new_period_idx;
+
+  n_streams = g_list_length (client->active_streams);
+  updates = g_new0 (GstMpdStreamUpdate, n_streams);
+
+  /* first map every active stream onto the new tree and build the segments
+   * that can not be merged, so that nothing is modified if we need to fall
+   * back to a full setup */
+  for (list = client->active_streams, i = 0; list;
+      list = g_list_next (list), i++) {
+    GstActiveStream *stream = list->data;
+    GstMpdStreamUpdate *update = &updates[i];
+    GstSegmentTemplateNode *seg_template = NULL;
+    gboolean had_timeline, has_timeline;
+    gint adapt_set_idx;
+
+    update->stream = stream;
+    if (stream->cur_adapt_set == NULL || stream->cur_representation == NULL)
+      goto failed;
+    adapt_set_idx = g_list_index (old_period->period->AdaptationSets,
+        stream->cur_adapt_set);
+    update->adapt_set = g_list_nth_data (new_period->period->AdaptationSets,
+        adapt_set_idx);
+    if (update->adapt_set == NULL
+        || update->adapt_set->id != stream->cur_adapt_set->id)
+      goto failed;
+    update->representation =
+        gst_mpdparser_find_matching_representation (update->adapt_set->
+        Representations, stream->cur_representation,
+        stream->representation_idx);
+    if (update->representation == NULL)
+      goto failed;
+
+    if (stream->cur_seg_template)
+      seg_template =
+          gst_mpdparser_get_segment_template (new_period->period,
+          update->adapt_set, update->representation);
+    had_timeline = stream->cur_seg_template != NULL
+        && stream->cur_seg_template->MultSegBaseType != NULL
+        && stream->cur_seg_template->MultSegBaseType->SegmentTimeline != NULL;
+    has_timeline = seg_template != NULL
+        && seg_template->MultSegBaseType != NULL
+        && seg_template->MultSegBaseType->SegmentTimeline != NULL;
+
+    if (stream->cur_segment_list == NULL && had_timeline && has_timeline
+        && seg_template->MultSegBaseType->SegBaseType != NULL
+        && stream->segments != NULL && stream->segments->len > 0) {
+      update->merge = TRUE;
+    } else if (stream->cur_segment_list || had_timeline || has_timeline) {
+      /* the segments of a SegmentList reference the SegmentURL nodes of the
+       * old tree, and switching between template modes changes the kind of
+       * segments: these streams are set up again from scratch */
+      update->rebuilt = g_slice_dup (GstActiveStream, stream);
+      update->rebuilt->cur_adapt_set = update->adapt_set;
+      update->rebuilt->cur_segment_base = NULL;
+      update->rebuilt->cur_segment_list = NULL;
+      update->rebuilt->cur_seg_template = NULL;
+      update->rebuilt->segments = NULL;
+      update->rebuilt->baseURL = NULL;
+      update->rebuilt->queryURL = NULL;
+      if (!gst_mpd_client_setup_representation (new_client, update->rebuilt,
+              update->representation)) {
+        GST_WARNING ("Failed to set up the segments of an updated stream");
+        goto failed;
+      }
+    }
+  }
+
+  for (i = 0; i < n_streams; i++) {
+    GstMpdStreamUpdate *update = &updates[i];
+    GstActiveStream *stream = update->stream;
+    GstActiveStream *rebuilt = update->rebuilt;
+
+    if (rebuilt) {
+      GstMediaSegment segment;
+
+      update->ts = GST_CLOCK_TIME_NONE;
+      if (stream->segments
+          && gst_mpdparser_get_segment (stream, stream->segment_idx, &segment))
+        update->ts = segment.start_time;
+
+      /* take over the segments built from the new tree */
+      if (stream->segments)
+        g_ptr_array_unref (stream->segments);
+      stream->segments = rebuilt->segments;
+      rebuilt->segments = NULL;
+      g_free (stream->baseURL);
+      stream->baseURL = rebuilt->baseURL;
+      rebuilt->baseURL = NULL;
+      g_free (stream->queryURL);
+      stream->queryURL = rebuilt->queryURL;
+      rebuilt->queryURL = NULL;
+      stream->cur_adapt_set = update->adapt_set;
+      stream->cur_representation = update->representation;
+      stream->representation_idx = rebuilt->representation_idx;
+      stream->cur_segment_base = rebuilt->cur_segment_base;
+      stream->cur_segment_list = rebuilt->cur_segment_list;
+      stream->cur_seg_template = rebuilt->cur_seg_template;
+      stream->segment_idx = 0;
+      continue;
+    }
+
+    /* re-point the stream to the nodes of the new tree */
+    stream->cur_adapt_set = update->adapt_set;
+    stream->cur_representation = update->representation;
+    stream->representation_idx =
+        g_list_index (update->adapt_set->Representations,
+        update->representation);
+    if (stream->cur_segment_base)
+      stream->cur_segment_base =
+          gst_mpdparser_get_segment_base (new_period->period,
+          update->adapt_set, update->representation);
+    if (stream->cur_seg_template)
+      stream->cur_seg_template =
+          gst_mpdparser_get_segment_template (new_period->period,
+          update->adapt_set, update->representation);
+
+    /* can only fail on the conditions checked above */
+    if (update->merge)
+      gst_mpd_client_merge_segment_timeline (stream, new_period);
+  }
+
+  /* take over the new tree */
+  gst_mpdparser_free_mpd_node (client->mpd_node);
+  client->mpd_node = new_client->mpd_node;
+  new_client->mpd_node = NULL;
+  g_list_free_full (client->periods,
+      (GDestroyNotify) gst_mpdparser_free_stream_period);
+  client->periods = new_client->periods;
+  new_client->periods = NULL;
+  client->period_idx = new_period_idx;
+
+  /* seek the rebuilt streams back to their previous position */
+  for (i = 0; i < n_streams; i++) {
+    if (updates[i].rebuilt == NULL)
+      continue;
+    if (GST_CLOCK_TIME_IS_VALID (updates[i].ts))
+      gst_mpd_client_stream_seek_unlocked (client, updates[i].stream,
+          updates[i].ts);
+    gst_mpdparser_free_active_stream (updates[i].rebuilt);
+  }
+  g_free (updates);
+  GST_MPD_CLIENT_UNLOCK (client);
+
+  return TRUE;
+
+failed:
+  for (i = 0; i < n_streams; i++)
+    gst_mpdparser_free_active_stream (updates[i].rebuilt);
+  g_free (updates);
+no_match:
+  GST_MPD_CLIENT_UNLOCK (client);
+  return FALSE;
+}
+
 gboolean
 gst_mpd_client_setup_media_presentation (GstMpdClient * client)
 {
@@ -3522,48 +3992,51 @@ gst_mpd_client_setup_streaming (GstMpdClient * client,
   return TRUE;
 }
 
-gboolean
-gst_mpd_client_stream_seek (GstMpdClient * client, GstActiveStream * stream,
-    GstClockTime ts)
+static gboolean
+gst_mpd_client_stream_seek_unlocked (GstMpdClient * client,
+    GstActiveStream * stream, GstClockTime ts)
 {
   gint segment_idx = 0;
-  GstMediaSegment *selectedChunk = NULL;
-  gint i;
-
-  g_return_val_if_fail (stream != NULL, 0);
+  GstMediaSegment segment;
 
-  GST_MPD_CLIENT_LOCK (client);
   if (stream->segments) {
-    for (i = 0; i < stream->segments->len; i++, segment_idx++) {
-      GstMediaSegment *segment = g_ptr_array_index (stream->segments, i);
-      GST_DEBUG ("Looking at fragment sequence chunk %d", segment_idx);
-      if (segment->start_time >= ts) {
-        selectedChunk = segment;
-        break;
-      }
-    }
-
-    if (selectedChunk == NULL) {
-      GST_MPD_CLIENT_UNLOCK (client);
+    /* select the first segment starting at or after ts */
+    segment_idx = gst_mpd_client_get_segment_index_for_timestamp (stream, ts);
+    if (gst_mpdparser_get_segment (stream, segment_idx, &segment)
+        && segment.start_time < ts)
+      segment_idx++;
+    GST_DEBUG ("Selected fragment sequence chunk %d", segment_idx);
+
+    if (segment_idx >= gst_mpd_client_get_segments_counts (stream))
       return FALSE;
-    }
   } else {
     GstClockTime duration =
         gst_mpd_client_get_segment_duration (client, stream);
     g_return_val_if_fail (stream->cur_seg_template->MultSegBaseType->
         SegmentTimeline == NULL, FALSE);
-    if (!GST_CLOCK_TIME_IS_VALID (duration)) {
-      GST_MPD_CLIENT_UNLOCK (client);
+    if (!GST_CLOCK_TIME_IS_VALID (duration))
       return FALSE;
-    }
     segment_idx = ts / duration;
   }
 
   gst_mpd_client_set_segment_index (stream, segment_idx);
 
+  return TRUE;
+}
+
+gboolean
+gst_mpd_client_stream_seek (GstMpdClient * client, GstActiveStream * stream,
+    GstClockTime ts)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (stream != NULL, 0);
+
+  GST_MPD_CLIENT_LOCK (client);
+  ret = gst_mpd_client_stream_seek_unlocked (client, stream, ts);
   GST_MPD_CLIENT_UNLOCK (client);
 
-  return TRUE;
+  return ret;
 }
 
 static gint64
@@ -3628,6 +4101,14 @@ gst_mpd_client_get_segment_index_at_time (GstMpdClient * client,
   if (diff > gst_mpd_client_get_media_presentation_duration (client))
     return -3;
 
+  if (stream->segments && stream->segments->len) {
+    guint count = gst_mpd_client_get_segments_counts (stream);
+    guint idx = gst_mpd_client_get_segment_index_for_timestamp (stream, diff);
+
+    /* the latest segment if we are beyond the end of the timeline */
+    return MIN (idx, count - 1);
+  }
+
   /* TODO: Assumes all fragments are roughly the same duration */
   seg_duration = gst_mpd_client_get_next_fragment_duration (client, stream);
   if (seg_duration == 0)
@@ -3923,7 +4404,7 @@ GstClockTime
 gst_mpd_client_get_next_fragment_duration (GstMpdClient * client,
     GstActiveStream * stream)
 {
-  GstMediaSegment *media_segment = NULL;
+  GstMediaSegment media_segment;
   guint seg_idx;
 
   g_return_val_if_fail (stream != NULL, 0);
@@ -3931,10 +4412,10 @@ gst_mpd_client_get_next_fragment_duration (GstMpdClient * client,
   seg_idx = gst_mpd_client_get_segment_index (stream);
 
   if (stream->segments) {
-    if (seg_idx < stream->segments->len)
-      media_segment = g_ptr_array_index (stream->segments, seg_idx);
+    if (!gst_mpdparser_get_segment (stream, seg_idx, &media_segment))
+      return 0;
 
-    return media_segment == NULL ? 0 : media_segment->duration;
+    return media_segment.duration;
   } else {
     GstClockTime duration =
         gst_mpd_client_get_segment_duration (client, stream);
@@ -4091,13 +4572,56 @@ gst_mpd_client_get_segment_index (GstActiveStream * stream)
   return stream->segment_idx;
 }
 
+guint
+gst_mpd_client_get_segment_index_for_timestamp (GstActiveStream * stream,
+    GstClockTime ts)
+{
+  GstMediaSegment *first, *run;
+  guint low, high, mid, offset;
+
+  g_return_val_if_fail (stream != NULL, 0);
+
+  if (stream->segments == NULL || stream->segments->len == 0)
+    return 0;
+
+  /* find the last run starting at or before ts */
+  low = 0;
+  high = stream->segments->len;
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    run = g_ptr_array_index (stream->segments, mid);
+    if (run->start_time <= ts)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low == 0)
+    return 0;
+
+  first = g_ptr_array_index (stream->segments, 0);
+  run = g_ptr_array_index (stream->segments, low - 1);
+  offset = run->duration ? (ts - run->start_time) / run->duration : 0;
+  /* ts falls into a gap after this run, take the next segment */
+  if (offset > run->repeat)
+    offset = run->repeat + 1;
+
+  return run->number - first->number + offset;
+}
+
 static guint
 gst_mpd_client_get_segments_counts (GstActiveStream * stream)
 {
   g_return_val_if_fail (stream != NULL, 0);
 
-  if (stream->segments)
-    return stream->segments->len;
+  if (stream->segments) {
+    GstMediaSegment *first, *last;
+
+    if (stream->segments->len == 0)
+      return 0;
+    first = g_ptr_array_index (stream->segments, 0);
+    last = g_ptr_array_index (stream->segments, stream->segments->len - 1);
+    return last->number + last->repeat + 1 - first->number;
+  }
   g_return_val_if_fail (stream->cur_seg_template->MultSegBaseType->
       SegmentTimeline == NULL, 0);
   return 0;
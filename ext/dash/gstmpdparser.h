@@ -407,13 +407,16 @@ struct _GstStreamPeriod
 /**
  * GstMediaSegment:
  *
- * Media segment data structure
+ * Media segment data structure, covering @repeat + 1 consecutive segments
+ * of the same duration
  */
 struct _GstMediaSegment
 {
   GstSegmentURLNode *SegmentURL;              /* this is NULL when using a SegmentTemplate */
   guint number;                               /* segment number */
+  gint repeat;                                /* number of following segments with the same duration */
   guint64 start;                                /* segment start time in timescale units */
+  guint64 scale_duration;                     /* segment duration in timescale units */
   GstClockTime start_time;                    /* segment start time */
   GstClockTime duration;                      /* segment duration */
 };
@@ -454,7 +457,7 @@ struct _GstActiveStream
   GstSegmentListNode *cur_segment_list;       /* active segment list */
   GstSegmentTemplateNode *cur_seg_template;   /* active segment template */
   guint segment_idx;                          /* index of next sequence chunk */
-  GPtrArray *segments;                        /* array of GstMediaSegment */
+  GPtrArray *segments;                        /* array of run-length encoded GstMediaSegment */
 };
 
 struct _GstMpdClient
@@ -479,6 +482,7 @@ void gst_media_fragment_info_clear (GstMediaFragmentInfo * fragment);
 
 /* MPD file parsing */
 gboolean gst_mpd_parse (GstMpdClient *client, const gchar *data, gint size);
+gboolean gst_mpd_client_update (GstMpdClient *client, GstMpdClient *new_client);
 
 /* Streaming management */
 gboolean gst_mpd_client_setup_media_presentation (GstMpdClient *client);
@@ -523,6 +527,7 @@ guint gst_mpdparser_get_nb_adaptationSet (GstMpdClient *client);
 /* Segment */
 void gst_mpd_client_set_segment_index_for_all_streams (GstMpdClient * client, guint segment_idx);
 guint gst_mpd_client_get_segment_index (GstActiveStream * stream);
+guint gst_mpd_client_get_segment_index_for_timestamp (GstActiveStream * stream, GstClockTime ts);
 void gst_mpd_client_set_segment_index (GstActiveStream * stream, guint segment_idx);
 
 /* Get audio/video stream parameters (mimeType, width, height, rate, number of channels) */
@@ -28,6 +28,15 @@
  * gst-launch-1.0 videotestsrc is-live=true ! x264enc ! mpegtsmux ! hlssink max-files=5
  * ]|
  * </refsect2>
+ *
+ * When #GstHlsSink:in-memory is enabled, the fragments are not written to
+ * disk but kept in a ring of #GstHlsSink:max-files fragments, that the
+ * application can retrieve with the #GstHlsSink::get-fragment action signal
+ * to serve them, together with the playlist from the
+ * #GstHlsSink::get-playlist action signal. In this mode the segment being
+ * written can be announced in the playlist as partial segments of
+ * #GstHlsSink:part-duration, so that clients can start fetching it before
+ * it is complete.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -50,6 +59,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_hls_sink_debug);
 #define DEFAULT_MAX_FILES 10
 #define DEFAULT_TARGET_DURATION 15
 #define DEFAULT_PLAYLIST_LENGTH 5
+#define DEFAULT_IN_MEMORY FALSE
+#define DEFAULT_PART_DURATION 0
 
 enum
 {
@@ -59,9 +70,20 @@ enum
   PROP_PLAYLIST_ROOT,
   PROP_MAX_FILES,
   PROP_TARGET_DURATION,
-  PROP_PLAYLIST_LENGTH
+  PROP_PLAYLIST_LENGTH,
+  PROP_IN_MEMORY,
+  PROP_PART_DURATION
+};
+
+enum
+{
+  SIGNAL_GET_FRAGMENT,
+  SIGNAL_GET_PLAYLIST,
+  LAST_SIGNAL
 };
 
+static guint gst_hls_sink_signals[LAST_SIGNAL] = { 0 };
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -83,6 +105,17 @@ static void gst_hls_sink_reset (GstHlsSink * sink);
 static GstStateChangeReturn
 gst_hls_sink_change_state (GstElement * element, GstStateChange trans);
 static gboolean schedule_next_key_unit (GstHlsSink * sink);
+static GstBufferList *gst_hls_sink_get_fragment (GstHlsSink * sink,
+    guint index);
+static gchar *gst_hls_sink_get_playlist (GstHlsSink * sink);
+
+static void
+gst_hls_sink_fragment_free (GstHlsSinkFragment * fragment)
+{
+  g_free (fragment->location);
+  gst_buffer_list_unref (fragment->buffers);
+  g_free (fragment);
+}
 
 static void
 gst_hls_sink_dispose (GObject * object)
@@ -100,6 +133,13 @@ gst_hls_sink_finalize (GObject * object)
   g_free (sink->location);
   g_free (sink->playlist_location);
   g_free (sink->playlist_root);
+  g_free (sink->playlist_content);
+  if (sink->playlist)
+    gst_m3u8_playlist_free (sink->playlist);
+  if (sink->current_fragment)
+    gst_hls_sink_fragment_free (sink->current_fragment);
+  g_queue_foreach (&sink->fragments, (GFunc) gst_hls_sink_fragment_free, NULL);
+  g_queue_clear (&sink->fragments);
 
   G_OBJECT_CLASS (parent_class)->finalize ((GObject *) sink);
 }
@@ -162,6 +202,53 @@ gst_hls_sink_class_init (GstHlsSinkClass * klass)
           "of the HLS specification, this should be at least 3.",
           1, G_MAXUINT, DEFAULT_PLAYLIST_LENGTH,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_IN_MEMORY,
+      g_param_spec_boolean ("in-memory", "In memory",
+          "Keep the last max-files fragments in memory instead of writing "
+          "them to disk, they can be retrieved with the get-fragment signal. "
+          "Must be set before going to READY.", DEFAULT_IN_MEMORY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PART_DURATION,
+      g_param_spec_uint ("part-duration", "Part duration",
+          "The target duration in milliseconds of the partial segments "
+          "announced in the playlist while a fragment is being written. "
+          "Only used in in-memory mode (0 - disabled)",
+          0, G_MAXUINT, DEFAULT_PART_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstHlsSink::get-fragment:
+   * @hlssink: the #GstHlsSink
+   * @index: the index of the fragment, as used in the location pattern
+   *
+   * Get the data of a fragment kept in memory in in-memory mode. The fragment
+   * being written can be retrieved too, with the data written so far.
+   *
+   * Returns: (transfer full): the buffers of the fragment or %NULL if the
+   * fragment is not available.
+   */
+  gst_hls_sink_signals[SIGNAL_GET_FRAGMENT] =
+      g_signal_new ("get-fragment", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHlsSinkClass, get_fragment), NULL, NULL,
+      g_cclosure_marshal_generic, GST_TYPE_BUFFER_LIST, 1, G_TYPE_UINT);
+
+  /**
+   * GstHlsSink::get-playlist:
+   * @hlssink: the #GstHlsSink
+   *
+   * Get the current playlist.
+   *
+   * Returns: (transfer full): the playlist or %NULL if none was written yet.
+   */
+  gst_hls_sink_signals[SIGNAL_GET_PLAYLIST] =
+      g_signal_new ("get-playlist", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHlsSinkClass, get_playlist), NULL, NULL,
+      g_cclosure_marshal_generic, G_TYPE_STRING, 0, G_TYPE_NONE);
+
+  klass->get_fragment = gst_hls_sink_get_fragment;
+  klass->get_playlist = gst_hls_sink_get_playlist;
 }
 
 static void
@@ -182,6 +269,9 @@ gst_hls_sink_init (GstHlsSink * sink)
   sink->playlist_length = DEFAULT_PLAYLIST_LENGTH;
   sink->max_files = DEFAULT_MAX_FILES;
   sink->target_duration = DEFAULT_TARGET_DURATION;
+  sink->in_memory = DEFAULT_IN_MEMORY;
+  sink->part_duration = DEFAULT_PART_DURATION;
+  g_queue_init (&sink->fragments);
 
   gst_hls_sink_reset (sink);
 }
@@ -204,25 +294,46 @@ gst_hls_sink_reset (GstHlsSink * sink)
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
   sink->playlist = gst_m3u8_playlist_new (6, sink->playlist_length, FALSE);
+
+  GST_OBJECT_LOCK (sink);
+  g_free (sink->playlist_content);
+  sink->playlist_content = NULL;
+  if (sink->current_fragment)
+    gst_hls_sink_fragment_free (sink->current_fragment);
+  sink->current_fragment = NULL;
+  g_queue_foreach (&sink->fragments, (GFunc) gst_hls_sink_fragment_free, NULL);
+  g_queue_clear (&sink->fragments);
+  GST_OBJECT_UNLOCK (sink);
+
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->part_offset = 0;
+  sink->part_independent = FALSE;
 }
 
 static gboolean
 gst_hls_sink_create_elements (GstHlsSink * sink)
 {
   GstPad *pad = NULL;
+  const gchar *factory;
 
   GST_DEBUG_OBJECT (sink, "Creating internal elements");
 
   if (sink->elements_created)
     return TRUE;
 
-  sink->multifilesink = gst_element_factory_make ("multifilesink", NULL);
+  /* in memory the fragments are split and stored from the pad probes */
+  factory = sink->in_memory ? "fakesink" : "multifilesink";
+  sink->multifilesink = gst_element_factory_make (factory, NULL);
   if (sink->multifilesink == NULL)
     goto missing_element;
 
-  g_object_set (sink->multifilesink, "location", sink->location,
-      "next-file", 3, "post-messages", TRUE, "max-files", sink->max_files,
-      NULL);
+  if (sink->in_memory) {
+    g_object_set (sink->multifilesink, "sync", FALSE, "async", FALSE, NULL);
+  } else {
+    g_object_set (sink->multifilesink, "location", sink->location,
+        "next-file", 3, "post-messages", TRUE, "max-files", sink->max_files,
+        NULL);
+  }
 
   gst_bin_add (GST_BIN_CAST (sink), sink->multifilesink);
 
@@ -235,14 +346,199 @@ gst_hls_sink_create_elements (GstHlsSink * sink)
 
 missing_element:
   gst_element_post_message (GST_ELEMENT_CAST (sink),
-      gst_missing_element_message_new (GST_ELEMENT_CAST (sink),
-          "multifilesink"));
+      gst_missing_element_message_new (GST_ELEMENT_CAST (sink), factory));
   GST_ELEMENT_ERROR (sink, CORE, MISSING_PLUGIN,
       (("Missing element '%s' - check your GStreamer installation."),
-          "multifilesink"), (NULL));
+          factory), (NULL));
   return FALSE;
 }
 
+static gchar *
+gst_hls_sink_get_entry_location (GstHlsSink * sink, const gchar * filename)
+{
+  gchar *name, *entry_location;
+
+  name = g_path_get_basename (filename);
+  if (sink->playlist_root == NULL)
+    return name;
+
+  entry_location = g_build_filename (sink->playlist_root, name, NULL);
+  g_free (name);
+  return entry_location;
+}
+
+static void
+gst_hls_sink_write_playlist (GstHlsSink * sink)
+{
+  GError *error = NULL;
+  gchar *playlist_content;
+
+  playlist_content = gst_m3u8_playlist_render (sink->playlist);
+
+  /* g_file_set_contents() replaces the playlist atomically, clients never
+   * see a partially written playlist */
+  if (sink->playlist_location && !g_file_set_contents (sink->playlist_location,
+          playlist_content, -1, &error)) {
+    GST_WARNING_OBJECT (sink, "Failed to write playlist: %s", error->message);
+    g_clear_error (&error);
+  }
+
+  GST_OBJECT_LOCK (sink);
+  g_free (sink->playlist_content);
+  sink->playlist_content = playlist_content;
+  GST_OBJECT_UNLOCK (sink);
+}
+
+static void
+gst_hls_sink_add_entry (GstHlsSink * sink, const gchar * entry_location,
+    GFile * file, GstClockTime running_time)
+{
+  GstClockTime duration;
+  const gchar *title;
+  gboolean discont = FALSE;
+
+  duration = running_time - sink->last_running_time;
+  sink->last_running_time = running_time;
+
+  title = "ciao";
+  GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
+
+  gst_m3u8_playlist_add_entry (sink->playlist, entry_location, file,
+      title, duration, sink->index, discont);
+  gst_hls_sink_write_playlist (sink);
+
+  /* a new fragment is starting. It means that upstream sent a key
+   * unit and we can schedule the next key unit now.
+   */
+  sink->waiting_fku = FALSE;
+  schedule_next_key_unit (sink);
+}
+
+/* announces the data of the current fragment since the last part as a new
+ * partial segment */
+static void
+gst_hls_sink_finish_part (GstHlsSink * sink, GstClockTime running_time)
+{
+  GstHlsSinkFragment *fragment = sink->current_fragment;
+
+  if (sink->part_duration == 0 || fragment == NULL
+      || fragment->size == sink->part_offset
+      || !GST_CLOCK_TIME_IS_VALID (sink->part_start)
+      || !GST_CLOCK_TIME_IS_VALID (running_time)
+      || running_time < sink->part_start)
+    return;
+
+  gst_m3u8_playlist_add_part (sink->playlist, fragment->location,
+      running_time - sink->part_start, sink->part_offset,
+      fragment->size - sink->part_offset, sink->part_independent);
+  sink->part_offset = fragment->size;
+  sink->part_start = running_time;
+}
+
+static void
+gst_hls_sink_finish_fragment (GstHlsSink * sink, GstClockTime running_time)
+{
+  GstHlsSinkFragment *fragment = sink->current_fragment;
+
+  if (fragment == NULL)
+    return;
+
+  gst_hls_sink_finish_part (sink, running_time);
+
+  GST_OBJECT_LOCK (sink);
+  sink->current_fragment = NULL;
+  g_queue_push_tail (&sink->fragments, fragment);
+  while (sink->max_files > 0 && sink->fragments.length > sink->max_files)
+    gst_hls_sink_fragment_free (g_queue_pop_head (&sink->fragments));
+  GST_OBJECT_UNLOCK (sink);
+
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->part_offset = 0;
+
+  /* only the streaming thread removes fragments, so it's still valid */
+  gst_hls_sink_add_entry (sink, fragment->location, NULL, running_time);
+}
+
+static void
+gst_hls_sink_store_buffer (GstHlsSink * sink, GstBuffer * buffer)
+{
+  GstClockTime running_time = GST_CLOCK_TIME_NONE;
+  gboolean independent;
+
+  if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer))
+    running_time = gst_segment_to_running_time (&sink->segment,
+        GST_FORMAT_TIME, GST_BUFFER_TIMESTAMP (buffer));
+  independent = !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  if (sink->current_fragment == NULL) {
+    GstHlsSinkFragment *fragment;
+    gchar *filename;
+
+    fragment = g_new0 (GstHlsSinkFragment, 1);
+    fragment->index = sink->count++;
+    filename = g_strdup_printf (sink->location, fragment->index);
+    fragment->location = gst_hls_sink_get_entry_location (sink, filename);
+    g_free (filename);
+    fragment->buffers = gst_buffer_list_new ();
+
+    GST_OBJECT_LOCK (sink);
+    sink->current_fragment = fragment;
+    GST_OBJECT_UNLOCK (sink);
+
+    sink->part_start = running_time;
+    sink->part_offset = 0;
+    sink->part_independent = independent;
+  } else if (sink->part_duration > 0 && GST_CLOCK_TIME_IS_VALID (running_time)
+      && GST_CLOCK_TIME_IS_VALID (sink->part_start)
+      && running_time >= sink->part_start + sink->part_duration * GST_MSECOND) {
+    gst_hls_sink_finish_part (sink, running_time);
+    gst_hls_sink_write_playlist (sink);
+    sink->part_independent = independent;
+  }
+
+  if (!GST_CLOCK_TIME_IS_VALID (sink->part_start))
+    sink->part_start = running_time;
+
+  GST_OBJECT_LOCK (sink);
+  gst_buffer_list_add (sink->current_fragment->buffers,
+      gst_buffer_ref (buffer));
+  sink->current_fragment->size += gst_buffer_get_size (buffer);
+  GST_OBJECT_UNLOCK (sink);
+}
+
+static GstBufferList *
+gst_hls_sink_get_fragment (GstHlsSink * sink, guint index)
+{
+  GstBufferList *buffers = NULL;
+  GList *l;
+
+  GST_OBJECT_LOCK (sink);
+  if (sink->current_fragment && sink->current_fragment->index == index)
+    buffers = gst_buffer_list_copy (sink->current_fragment->buffers);
+
+  for (l = sink->fragments.tail; l && buffers == NULL; l = l->prev) {
+    GstHlsSinkFragment *fragment = l->data;
+
+    if (fragment->index == index)
+      buffers = gst_buffer_list_copy (fragment->buffers);
+  }
+  GST_OBJECT_UNLOCK (sink);
+
+  return buffers;
+}
+
+static gchar *
+gst_hls_sink_get_playlist (GstHlsSink * sink)
+{
+  gchar *playlist_content;
+
+  GST_OBJECT_LOCK (sink);
+  playlist_content = g_strdup (sink->playlist_content);
+  GST_OBJECT_UNLOCK (sink);
+
+  return playlist_content;
+}
+
 static void
 gst_hls_sink_handle_message (GstBin * bin, GstMessage * message)
 {
@@ -252,11 +548,8 @@ gst_hls_sink_handle_message (GstBin * bin, GstMessage * message)
     case GST_MESSAGE_ELEMENT:
     {
       GFile *file;
-      const char *filename, *title;
-      char *playlist_content;
-      GstClockTime running_time, duration;
-      gboolean discont = FALSE;
-      GError *error = NULL;
+      const char *filename;
+      GstClockTime running_time;
       gchar *entry_location;
       const GstStructure *structure;
 
@@ -266,33 +559,12 @@ gst_hls_sink_handle_message (GstBin * bin, GstMessage * message)
 
       filename = gst_structure_get_string (structure, "filename");
       gst_structure_get_clock_time (structure, "running-time", &running_time);
-      duration = running_time - sink->last_running_time;
-      sink->last_running_time = running_time;
 
+      /* multifilesink is starting a new file */
       file = g_file_new_for_path (filename);
-      title = "ciao";
-      GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
-      if (sink->playlist_root == NULL)
-        entry_location = g_path_get_basename (filename);
-      else {
-        gchar *name = g_path_get_basename (filename);
-        entry_location = g_build_filename (sink->playlist_root, name, NULL);
-        g_free (name);
-      }
-
-      gst_m3u8_playlist_add_entry (sink->playlist, entry_location, file,
-          title, duration, sink->index, discont);
+      entry_location = gst_hls_sink_get_entry_location (sink, filename);
+      gst_hls_sink_add_entry (sink, entry_location, file, running_time);
       g_free (entry_location);
-      playlist_content = gst_m3u8_playlist_render (sink->playlist);
-      g_file_set_contents (sink->playlist_location,
-          playlist_content, -1, &error);
-      g_free (playlist_content);
-
-      /* multifilesink is starting a new file. It means that upstream sent a key
-       * unit and we can schedule the next key unit now.
-       */
-      sink->waiting_fku = FALSE;
-      schedule_next_key_unit (sink);
 
       /* multifilesink is an internal implementation detail. If applications
        * need a notification, we should probably do our own message */
@@ -321,6 +593,10 @@ gst_hls_sink_change_state (GstElement * element, GstStateChange trans)
         return GST_STATE_CHANGE_FAILURE;
       }
       break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      gst_m3u8_playlist_set_part_target (sink->playlist,
+          sink->in_memory ? sink->part_duration * GST_MSECOND : 0);
+      break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
     default:
@@ -355,7 +631,7 @@ gst_hls_sink_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       g_free (sink->location);
       sink->location = g_value_dup_string (value);
-      if (sink->multifilesink)
+      if (sink->multifilesink && !sink->in_memory)
         g_object_set (sink->multifilesink, "location", sink->location, NULL);
       break;
     case PROP_PLAYLIST_LOCATION:
@@ -368,7 +644,7 @@ gst_hls_sink_set_property (GObject * object, guint prop_id,
       break;
     case PROP_MAX_FILES:
       sink->max_files = g_value_get_uint (value);
-      if (sink->multifilesink) {
+      if (sink->multifilesink && !sink->in_memory) {
         g_object_set (sink->multifilesink, "location", sink->location,
             "next-file", 3, "post-messages", TRUE, "max-files", sink->max_files,
             NULL);
@@ -381,6 +657,12 @@ gst_hls_sink_set_property (GObject * object, guint prop_id,
       sink->playlist_length = g_value_get_uint (value);
       sink->playlist->window_size = sink->playlist_length;
       break;
+    case PROP_IN_MEMORY:
+      sink->in_memory = g_value_get_boolean (value);
+      break;
+    case PROP_PART_DURATION:
+      sink->part_duration = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -412,6 +694,12 @@ gst_hls_sink_get_property (GObject * object, guint prop_id,
     case PROP_PLAYLIST_LENGTH:
       g_value_set_uint (value, sink->playlist_length);
       break;
+    case PROP_IN_MEMORY:
+      g_value_set_boolean (value, sink->in_memory);
+      break;
+    case PROP_PART_DURATION:
+      g_value_set_uint (value, sink->part_duration);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -449,6 +737,10 @@ gst_hls_sink_ghost_event_probe (GstPad * pad, GstPadProbeInfo * info,
           &timestamp, &stream_time, &running_time, &all_headers, &count);
       GST_INFO_OBJECT (sink, "setting index %d", count);
       sink->index = count;
+
+      /* like multifilesink, start a new fragment on each key unit event */
+      if (sink->in_memory)
+        gst_hls_sink_finish_fragment (sink, running_time);
       break;
     }
     default:
@@ -499,6 +791,9 @@ gst_hls_sink_ghost_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
   GstBuffer *buffer = gst_pad_probe_info_get_buffer (info);
   GstClockTime timestamp;
 
+  if (sink->in_memory)
+    gst_hls_sink_store_buffer (sink, buffer);
+
   timestamp = GST_BUFFER_TIMESTAMP (buffer);
   if (sink->target_duration == 0 || !GST_CLOCK_TIME_IS_VALID (timestamp)
       || sink->waiting_fku)
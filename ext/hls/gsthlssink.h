@@ -33,6 +33,15 @@ G_BEGIN_DECLS
 
 typedef struct _GstHlsSink GstHlsSink;
 typedef struct _GstHlsSinkClass GstHlsSinkClass;
+typedef struct _GstHlsSinkFragment GstHlsSinkFragment;
+
+struct _GstHlsSinkFragment
+{
+  guint index;
+  gchar *location;
+  GstBufferList *buffers;
+  guint64 size;
+};
 
 struct _GstHlsSink
 {
@@ -56,11 +65,28 @@ struct _GstHlsSink
   GstSegment segment;
   gboolean waiting_fku;
   GstClockTime last_running_time;
+
+  gboolean in_memory;
+  guint part_duration;
+  gchar *playlist_content;
+
+  /* in-memory fragments, protected by the object lock */
+  GQueue fragments;
+  GstHlsSinkFragment *current_fragment;
+
+  /* partial segment being written */
+  GstClockTime part_start;
+  guint64 part_offset;
+  gboolean part_independent;
 };
 
 struct _GstHlsSinkClass
 {
   GstBinClass bin_class;
+
+  /* actions */
+  GstBufferList * (*get_fragment) (GstHlsSink * sink, guint index);
+  gchar * (*get_playlist) (GstHlsSink * sink);
 };
 
 GType gst_hls_sink_get_type (void);
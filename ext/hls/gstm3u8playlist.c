@@ -35,6 +35,20 @@
 #define M3U8_INT_INF_TAG "#EXTINF:%d,%s\n%s\n"
 #define M3U8_FLOAT_INF_TAG "#EXTINF:%.2f,%s\n%s\n"
 #define M3U8_ENDLIST_TAG "#EXT-X-ENDLIST"
+#define M3U8_PART_INF_TAG "#EXT-X-PART-INF:PART-TARGET=%s\n"
+#define M3U8_SERVER_CONTROL_TAG "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=%s\n"
+#define M3U8_PART_TAG "#EXT-X-PART:DURATION=%s,URI=\"%s\",BYTERANGE=\"%" \
+    G_GUINT64_FORMAT "@%" G_GUINT64_FORMAT "\"%s\n"
+#define M3U8_PART_INDEPENDENT_ATTR ",INDEPENDENT=YES"
+
+/* partial segments are only listed for the last segments of the playlist */
+#define M3U8_PART_SEGMENTS 3
+
+/* lowest protocol version announced with partial segments */
+#define M3U8_PART_VERSION 9
+
+/* clients stay at least this many part targets behind the live edge */
+#define M3U8_PART_HOLD_BACK 3
 
 enum
 {
@@ -67,6 +81,8 @@ gst_m3u8_entry_free (GstM3U8Entry * entry)
 
   g_free (entry->url);
   g_free (entry->title);
+  g_free (entry->rendered);
+  g_free (entry->parts);
   if (entry->file != NULL)
     g_object_unref (entry->file);
   g_free (entry);
@@ -103,6 +119,7 @@ gst_m3u8_playlist_new (guint version, guint window_size, gboolean allow_cache)
   playlist->type = GST_M3U8_PLAYLIST_TYPE_EVENT;
   playlist->end_list = FALSE;
   playlist->entries = g_queue_new ();
+  playlist->parts = g_string_new ("");
 
   return playlist;
 }
@@ -114,9 +131,25 @@ gst_m3u8_playlist_free (GstM3U8Playlist * playlist)
 
   g_queue_foreach (playlist->entries, (GFunc) gst_m3u8_entry_free, NULL);
   g_queue_free (playlist->entries);
+  g_string_free (playlist->parts, TRUE);
   g_free (playlist);
 }
 
+static guint
+gst_m3u8_playlist_target_duration (GstM3U8Playlist * playlist)
+{
+  GList *l;
+  GstM3U8Entry *entry;
+  guint64 target_duration = 0;
+
+  for (l = playlist->entries->head; l; l = l->next) {
+    entry = (GstM3U8Entry *) l->data;
+    if (entry->duration > target_duration)
+      target_duration = entry->duration;
+  }
+
+  return (guint) ((target_duration + 500 * GST_MSECOND) / GST_SECOND);
+}
 
 gboolean
 gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
@@ -133,6 +166,14 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
     return FALSE;
 
   entry = gst_m3u8_entry_new (url, file, title, duration, discontinuous);
+  /* entries never change once added, render them only once */
+  entry->rendered = gst_m3u8_entry_render (entry, playlist->version);
+
+  /* the partial segments announced so far belong to this entry */
+  if (playlist->parts->len > 0) {
+    entry->parts = g_strdup (playlist->parts->str);
+    g_string_truncate (playlist->parts, 0);
+  }
 
   if (playlist->window_size != -1) {
     /* Delete old entries from the playlist */
@@ -146,50 +187,64 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
 
   playlist->sequence_number = index + 1;
   g_queue_push_tail (playlist->entries, entry);
+  playlist->target_duration = gst_m3u8_playlist_target_duration (playlist);
 
   return TRUE;
 }
 
-static guint
-gst_m3u8_playlist_target_duration (GstM3U8Playlist * playlist)
+gboolean
+gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist, const gchar * url,
+    guint64 duration, guint64 offset, guint64 length, gboolean independent)
 {
-  gint i;
-  GstM3U8Entry *entry;
-  guint64 target_duration = 0;
+  gchar dur_str[G_ASCII_DTOSTR_BUF_SIZE];
 
-  for (i = 0; i < playlist->entries->length; i++) {
-    entry = (GstM3U8Entry *) g_queue_peek_nth (playlist->entries, i);
-    if (entry->duration > target_duration)
-      target_duration = entry->duration;
-  }
+  g_return_val_if_fail (playlist != NULL, FALSE);
+  g_return_val_if_fail (url != NULL, FALSE);
 
-  return (guint) ((target_duration + 500 * GST_MSECOND) / GST_SECOND);
+  if (playlist->type == GST_M3U8_PLAYLIST_TYPE_VOD)
+    return FALSE;
+
+  /* always use a '.' as radix, whatever the locale */
+  g_ascii_formatd (dur_str, sizeof (dur_str), "%.3f",
+      (gdouble) duration / GST_SECOND);
+  g_string_append_printf (playlist->parts, M3U8_PART_TAG, dur_str, url,
+      length, offset, independent ? M3U8_PART_INDEPENDENT_ATTR : "");
+
+  return TRUE;
 }
 
-static void
-render_entry (GstM3U8Entry * entry, GstM3U8Playlist * playlist)
+void
+gst_m3u8_playlist_set_part_target (GstM3U8Playlist * playlist,
+    guint64 part_target)
 {
-  gchar *entry_str;
+  g_return_if_fail (playlist != NULL);
 
-  entry_str = gst_m3u8_entry_render (entry, playlist->version);
-  g_string_append_printf (playlist->playlist_str, "%s", entry_str);
-  g_free (entry_str);
+  playlist->part_target = part_target;
 }
 
+
 gchar *
 gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
 {
+  GList *l;
+  guint n;
   gchar *pl;
 
   g_return_val_if_fail (playlist != NULL, NULL);
 
-  playlist->playlist_str = g_string_new ("");
+  playlist->playlist_str = g_string_sized_new (256 +
+      playlist->entries->length * 64 + playlist->parts->len);
 
   /* #EXTM3U */
   g_string_append_printf (playlist->playlist_str, M3U8_HEADER_TAG);
   /* #EXT-X-VERSION */
 //  g_string_append_printf (playlist->playlist_str, M3U8_VERSION_TAG,
 //      playlist->version);
+  if (playlist->part_target > 0) {
+    /* clients that don't know partial segments must not load the playlist */
+    g_string_append_printf (playlist->playlist_str, M3U8_VERSION_TAG,
+        MAX (playlist->version, M3U8_PART_VERSION));
+  }
   /* #EXT-X-ALLOW_CACHE */
   g_string_append_printf (playlist->playlist_str, M3U8_ALLOW_CACHE_TAG,
       playlist->allow_cache ? "YES" : "NO");
@@ -198,11 +253,36 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
       playlist->sequence_number - playlist->entries->length);
   /* #EXT-X-TARGETDURATION */
   g_string_append_printf (playlist->playlist_str, M3U8_TARGETDURATION_TAG,
-      gst_m3u8_playlist_target_duration (playlist));
+      playlist->target_duration);
+  if (playlist->part_target > 0) {
+    gchar target_str[G_ASCII_DTOSTR_BUF_SIZE];
+
+    /* #EXT-X-SERVER-CONTROL */
+    g_ascii_formatd (target_str, sizeof (target_str), "%.3f",
+        (gdouble) playlist->part_target * M3U8_PART_HOLD_BACK / GST_SECOND);
+    g_string_append_printf (playlist->playlist_str, M3U8_SERVER_CONTROL_TAG,
+        target_str);
+    /* #EXT-X-PART-INF */
+    g_ascii_formatd (target_str, sizeof (target_str), "%.3f",
+        (gdouble) playlist->part_target / GST_SECOND);
+    g_string_append_printf (playlist->playlist_str, M3U8_PART_INF_TAG,
+        target_str);
+  }
   g_string_append_printf (playlist->playlist_str, "\n");
 
-  /* Entries */
-  g_queue_foreach (playlist->entries, (GFunc) render_entry, playlist);
+  /* Entries, with the partial segments of the most recent ones */
+  for (l = playlist->entries->head, n = playlist->entries->length; l;
+      l = l->next, n--) {
+    GstM3U8Entry *entry = (GstM3U8Entry *) l->data;
+
+    if (entry->parts && n <= M3U8_PART_SEGMENTS)
+      g_string_append (playlist->playlist_str, entry->parts);
+    g_string_append (playlist->playlist_str, entry->rendered);
+  }
+
+  /* Partial segments of the segment being written */
+  g_string_append_len (playlist->playlist_str, playlist->parts->str,
+      playlist->parts->len);
 
   if (playlist->end_list)
     g_string_append_printf (playlist->playlist_str, M3U8_ENDLIST_TAG);
@@ -219,6 +299,8 @@ gst_m3u8_playlist_clear (GstM3U8Playlist * playlist)
 
   g_queue_foreach (playlist->entries, (GFunc) gst_m3u8_entry_free, NULL);
   g_queue_clear (playlist->entries);
+  g_string_truncate (playlist->parts, 0);
+  playlist->target_duration = 0;
 }
 
 guint
@@ -38,6 +38,10 @@ struct _GstM3U8Entry
   gchar *url;
   GFile *file;
   gboolean discontinuous;
+
+  /*< Private >*/
+  gchar *rendered;
+  gchar *parts;
 };
 
 struct _GstM3U8Playlist
@@ -52,6 +56,9 @@ struct _GstM3U8Playlist
   /*< Private >*/
   GQueue *entries;
   GString *playlist_str;
+  guint target_duration;
+  guint64 part_target;
+  GString *parts;
 };
 
 
@@ -66,6 +73,14 @@ gboolean gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
 				     gfloat duration,
 				     guint index,
 				     gboolean discontinuous);
+gboolean gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist,
+                                     const gchar * url,
+                                     guint64 duration,
+                                     guint64 offset,
+                                     guint64 length,
+                                     gboolean independent);
+void gst_m3u8_playlist_set_part_target (GstM3U8Playlist * playlist,
+                                        guint64 part_target);
 gchar * gst_m3u8_playlist_render (GstM3U8Playlist * playlist); 
 void gst_m3u8_playlist_clear (GstM3U8Playlist * playlist); 
 guint gst_m3u8_playlist_n_entries (GstM3U8Playlist * playlist); 
@@ -31,6 +31,8 @@
 
 #define GST_CAT_DEFAULT fragmented_debug
 
+#define M3U8_HAS_TAG(data,tag) (strncmp ((data), (tag), sizeof (tag) - 1) == 0)
+
 static GstM3U8 *gst_m3u8_new (void);
 static void gst_m3u8_free (GstM3U8 * m3u8);
 static gboolean gst_m3u8_update (GstM3U8 * m3u8, gchar * data,
@@ -46,6 +48,9 @@ gst_m3u8_new (void)
   GstM3U8 *m3u8;
 
   m3u8 = g_new0 (GstM3U8, 1);
+  m3u8->files =
+      g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_m3u8_media_file_free);
 
   return m3u8;
 }
@@ -70,8 +75,7 @@ gst_m3u8_free (GstM3U8 * self)
   g_free (self->codecs);
   g_free (self->key);
 
-  g_list_foreach (self->files, (GFunc) gst_m3u8_media_file_free, NULL);
-  g_list_free (self->files);
+  g_ptr_array_free (self->files, TRUE);
 
   g_free (self->last_data);
   g_list_foreach (self->lists, (GFunc) gst_m3u8_free, NULL);
@@ -217,6 +221,13 @@ gst_m3u8_compare_playlist_by_bitrate (gconstpointer a, gconstpointer b)
 
 /*
  * @data: a m3u8 playlist text data, taking ownership
+ *
+ * Once a live playlist has been loaded, refreshes only create media files
+ * for the entries that follow the last known media sequence. The entries
+ * that are still in the window are kept as is and the ones that slid out
+ * of it are dropped from the head of the files array. The segments a
+ * delta playlist leaves out with EXT-X-SKIP are taken from the files we
+ * already have.
  */
 static gboolean
 gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
@@ -226,6 +237,10 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
   gchar *title, *end;
 //  gboolean discontinuity;
   GstM3U8 *list;
+  gboolean delta = FALSE;
+  gboolean first_file = TRUE;
+  guint last_sequence = 0;
+  guint skipped = 0;
 
   g_return_val_if_fail (self != NULL, FALSE);
   g_return_val_if_fail (data != NULL, FALSE);
@@ -251,18 +266,23 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
   g_free (self->last_data);
   self->last_data = data;
 
-  if (self->files) {
-    g_list_foreach (self->files, (GFunc) gst_m3u8_media_file_free, NULL);
-    g_list_free (self->files);
-    self->files = NULL;
+  if (self->files->len > 0 && !self->endlist) {
+    GstM3U8MediaFile *last =
+        g_ptr_array_index (self->files, self->files->len - 1);
+
+    delta = TRUE;
+    last_sequence = last->sequence;
+  } else {
+    g_ptr_array_set_size (self->files, 0);
   }
 
   list = NULL;
   duration = 0;
+  /* points into last_data, only copied for the files that are created */
   title = NULL;
   data += 7;
   while (TRUE) {
-    end = g_utf8_strchr (data, -1, '\n');
+    end = strchr (data, '\n');
     if (end)
       *end = '\0';
 
@@ -274,15 +294,15 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
         goto next_line;
       }
 
-      data = uri_join (self->uri, data);
-      if (data == NULL)
-        goto next_line;
-
-      r = g_utf8_strchr (data, -1, '\r');
+      r = strchr (data, '\r');
       if (r)
         *r = '\0';
 
       if (list != NULL) {
+        data = uri_join (self->uri, data);
+        if (data == NULL)
+          goto next_line;
+
         if (g_list_find_custom (self->lists, data,
                 (GCompareFunc) _m3u8_compare_uri)) {
           GST_DEBUG ("Already have a list with this URI");
@@ -295,9 +315,44 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
         list = NULL;
       } else {
         GstM3U8MediaFile *file;
-        file =
-            gst_m3u8_media_file_new (data, title, duration,
-            self->mediasequence++);
+        guint sequence = self->mediasequence++;
+
+        if (delta && first_file) {
+          GstM3U8MediaFile *head = g_ptr_array_index (self->files, 0);
+          /* the window starts with the skipped segments, if any */
+          guint first = sequence - skipped;
+
+          if (first < head->sequence || sequence > last_sequence + 1) {
+            GST_DEBUG ("Media sequence %u is outside of the known window, "
+                "reloading all files", first);
+            g_ptr_array_set_size (self->files, 0);
+            delta = FALSE;
+          } else if (first > head->sequence) {
+            g_ptr_array_remove_range (self->files, 0, first - head->sequence);
+          }
+        }
+        first_file = FALSE;
+
+        if (delta && sequence <= last_sequence) {
+          /* still in the window, we already have it */
+          duration = 0;
+          title = NULL;
+          goto next_line;
+        }
+
+        data = uri_join (self->uri, data);
+        if (data == NULL)
+          goto next_line;
+
+        file = gst_m3u8_media_file_new (data, g_strdup (title), duration,
+            sequence);
+
+        if (self->files->len > 0) {
+          GstM3U8MediaFile *prev =
+              g_ptr_array_index (self->files, self->files->len - 1);
+
+          file->timestamp = prev->timestamp + prev->duration;
+        }
 
         /* set encryption params */
         file->key = g_strdup (self->key);
@@ -308,15 +363,29 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
 
         duration = 0;
         title = NULL;
-        self->files = g_list_append (self->files, file);
+        g_ptr_array_add (self->files, file);
       }
 
-    } else if (g_str_has_prefix (data, "#EXT-X-ENDLIST")) {
+    } else if (M3U8_HAS_TAG (data, "#EXTINF:")) {
+      gdouble fval;
+      if (!double_from_string (data + 8, &data, &fval)) {
+        GST_WARNING ("Can't read EXTINF duration");
+        goto next_line;
+      }
+      duration = fval * (gdouble) GST_SECOND;
+      if (duration > self->targetduration)
+        GST_WARNING ("EXTINF duration > TARGETDURATION");
+      if (!data || *data != ',')
+        goto next_line;
+      data = g_utf8_next_char (data);
+      if (data != end)
+        title = data;
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-ENDLIST")) {
       self->endlist = TRUE;
-    } else if (g_str_has_prefix (data, "#EXT-X-VERSION:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-VERSION:")) {
       if (int_from_string (data + 15, &data, &val))
         self->version = val;
-    } else if (g_str_has_prefix (data, "#EXT-X-STREAM-INF:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-STREAM-INF:")) {
       gchar *v, *a;
 
       if (list != NULL) {
@@ -348,21 +417,35 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
           }
         }
       }
-    } else if (g_str_has_prefix (data, "#EXT-X-TARGETDURATION:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-TARGETDURATION:")) {
       if (int_from_string (data + 22, &data, &val))
         self->targetduration = val * GST_SECOND;
-    } else if (g_str_has_prefix (data, "#EXT-X-MEDIA-SEQUENCE:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-MEDIA-SEQUENCE:")) {
       if (int_from_string (data + 22, &data, &val))
         self->mediasequence = val;
-    } else if (g_str_has_prefix (data, "#EXT-X-DISCONTINUITY")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-SKIP:")) {
+      gchar *v, *a;
+
+      data = data + 12;
+      while (data && parse_attributes (&data, &a, &v)) {
+        if (g_str_equal (a, "SKIPPED-SEGMENTS")) {
+          if (int_from_string (v, NULL, &val) && val >= 0) {
+            skipped = val;
+            self->mediasequence += val;
+          } else {
+            GST_WARNING ("Error while reading SKIPPED-SEGMENTS");
+          }
+        }
+      }
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-DISCONTINUITY")) {
       /* discontinuity = TRUE; */
-    } else if (g_str_has_prefix (data, "#EXT-X-PROGRAM-DATE-TIME:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-PROGRAM-DATE-TIME:")) {
       /* <YYYY-MM-DDThh:mm:ssZ> */
       GST_DEBUG ("FIXME parse date");
-    } else if (g_str_has_prefix (data, "#EXT-X-ALLOW-CACHE:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-ALLOW-CACHE:")) {
       g_free (self->allowcache);
       self->allowcache = g_strdup (data + 19);
-    } else if (g_str_has_prefix (data, "#EXT-X-KEY:")) {
+    } else if (M3U8_HAS_TAG (data, "#EXT-X-KEY:")) {
       gchar *v, *a;
 
       data = data + 11;
@@ -378,26 +461,11 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
           if (key[0] == '"')
             key += 1;
 
+          g_free (self->key);
           self->key = uri_join (self->uri, key);
           g_free (keyp);
         }
       }
-    } else if (g_str_has_prefix (data, "#EXTINF:")) {
-      gdouble fval;
-      if (!double_from_string (data + 8, &data, &fval)) {
-        GST_WARNING ("Can't read EXTINF duration");
-        goto next_line;
-      }
-      duration = fval * (gdouble) GST_SECOND;
-      if (duration > self->targetduration)
-        GST_WARNING ("EXTINF duration > TARGETDURATION");
-      if (!data || *data != ',')
-        goto next_line;
-      data = g_utf8_next_char (data);
-      if (data != end) {
-        g_free (title);
-        title = g_strdup (data);
-      }
     } else {
       GST_LOG ("Ignored line: %s", data);
     }
@@ -405,7 +473,7 @@ gst_m3u8_update (GstM3U8 * self, gchar * data, gboolean * updated)
   next_line:
     if (!end)
       break;
-    data = g_utf8_next_char (end);      /* skip \n */
+    data = end + 1;             /* skip \n */
   }
 
   /* redorder playlists by bitrate */
@@ -498,9 +566,9 @@ gst_m3u8_client_update (GstM3U8Client * self, gchar * data)
     }
   }
 
-  if (m3u8->files && self->sequence == -1) {
+  if (m3u8->files->len > 0 && self->sequence == -1) {
     self->sequence =
-        GST_M3U8_MEDIA_FILE (g_list_first (m3u8->files)->data)->sequence;
+        GST_M3U8_MEDIA_FILE (g_ptr_array_index (m3u8->files, 0))->sequence;
     GST_DEBUG ("Setting first sequence at %d", self->sequence);
   }
 
@@ -510,31 +578,96 @@ out:
   return ret;
 }
 
-static gboolean
-_find_next (GstM3U8MediaFile * file, GstM3U8Client * client)
+/* returns the index of the first file with a sequence >= @sequence, or the
+ * number of files if there is none */
+static guint
+_find_file_index (GPtrArray * files, gint sequence)
 {
-  GST_DEBUG ("Found fragment %d", file->sequence);
-  if (file->sequence >= client->sequence)
-    return FALSE;
-  return TRUE;
+  guint lo = 0, hi = files->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if ((gint) GST_M3U8_MEDIA_FILE (g_ptr_array_index (files,
+                mid))->sequence < sequence)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* running time from the first file of the playlist up to the file at @idx,
+ * or the total duration if @idx is the number of files */
+static GstClockTime
+_get_file_position (GPtrArray * files, guint idx)
+{
+  GstM3U8MediaFile *first, *file;
+
+  if (files->len == 0)
+    return 0;
+
+  first = g_ptr_array_index (files, 0);
+  if (idx < files->len) {
+    file = g_ptr_array_index (files, idx);
+    return file->timestamp - first->timestamp;
+  }
+
+  file = g_ptr_array_index (files, files->len - 1);
+  return file->timestamp + file->duration - first->timestamp;
 }
 
 void
 gst_m3u8_client_get_current_position (GstM3U8Client * client,
     GstClockTime * timestamp)
 {
-  GList *l;
-  GList *walk;
+  GPtrArray *files = client->current->files;
 
-  l = g_list_find_custom (client->current->files, client,
-      (GCompareFunc) _find_next);
+  *timestamp = _get_file_position (files,
+      _find_file_index (files, client->sequence));
+}
 
-  *timestamp = 0;
-  for (walk = client->current->files; walk; walk = walk->next) {
-    if (walk == l)
-      break;
-    *timestamp += GST_M3U8_MEDIA_FILE (walk->data)->duration;
+gboolean
+gst_m3u8_client_get_sequence_at_time (GstM3U8Client * client,
+    GstClockTime time, gint * sequence)
+{
+  GPtrArray *files;
+  GstM3U8MediaFile *first, *file;
+  guint lo, hi;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (client != NULL, FALSE);
+  g_return_val_if_fail (client->current != NULL, FALSE);
+  g_return_val_if_fail (sequence != NULL, FALSE);
+
+  GST_M3U8_CLIENT_LOCK (client);
+  files = client->current->files;
+  if (files->len == 0)
+    goto out;
+
+  /* last file starting at or before time */
+  first = g_ptr_array_index (files, 0);
+  lo = 0;
+  hi = files->len;
+  while (hi - lo > 1) {
+    guint mid = lo + (hi - lo) / 2;
+
+    file = g_ptr_array_index (files, mid);
+    if (file->timestamp - first->timestamp > time)
+      hi = mid;
+    else
+      lo = mid;
   }
+
+  file = g_ptr_array_index (files, lo);
+  if (time < file->timestamp - first->timestamp + file->duration) {
+    *sequence = file->sequence;
+    ret = TRUE;
+  }
+
+out:
+  GST_M3U8_CLIENT_UNLOCK (client);
+  return ret;
 }
 
 gboolean
@@ -542,8 +675,9 @@ gst_m3u8_client_get_next_fragment (GstM3U8Client * client,
     gboolean * discontinuity, const gchar ** uri, GstClockTime * duration,
     GstClockTime * timestamp, const gchar ** key, const guint8 ** iv)
 {
-  GList *l;
+  GPtrArray *files;
   GstM3U8MediaFile *file;
+  guint idx;
 
   g_return_val_if_fail (client != NULL, FALSE);
   g_return_val_if_fail (client->current != NULL, FALSE);
@@ -551,16 +685,17 @@ gst_m3u8_client_get_next_fragment (GstM3U8Client * client,
 
   GST_M3U8_CLIENT_LOCK (client);
   GST_DEBUG ("Looking for fragment %d", client->sequence);
-  l = g_list_find_custom (client->current->files, client,
-      (GCompareFunc) _find_next);
-  if (l == NULL) {
+  files = client->current->files;
+  idx = _find_file_index (files, client->sequence);
+  if (idx >= files->len) {
     GST_M3U8_CLIENT_UNLOCK (client);
     return FALSE;
   }
 
-  gst_m3u8_client_get_current_position (client, timestamp);
+  file = GST_M3U8_MEDIA_FILE (g_ptr_array_index (files, idx));
+  GST_DEBUG ("Found fragment %d", file->sequence);
 
-  file = GST_M3U8_MEDIA_FILE (l->data);
+  *timestamp = _get_file_position (files, idx);
 
   *discontinuity = client->sequence != file->sequence;
   client->sequence = file->sequence + 1;
@@ -574,12 +709,6 @@ gst_m3u8_client_get_next_fragment (GstM3U8Client * client,
   return TRUE;
 }
 
-static void
-_sum_duration (GstM3U8MediaFile * self, GstClockTime * duration)
-{
-  *duration += self->duration;
-}
-
 GstClockTime
 gst_m3u8_client_get_duration (GstM3U8Client * client)
 {
@@ -594,7 +723,8 @@ gst_m3u8_client_get_duration (GstM3U8Client * client)
     return GST_CLOCK_TIME_NONE;
   }
 
-  g_list_foreach (client->current->files, (GFunc) _sum_duration, &duration);
+  duration = _get_file_position (client->current->files,
+      client->current->files->len);
   GST_M3U8_CLIENT_UNLOCK (client);
   return duration;
 }
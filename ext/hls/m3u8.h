@@ -50,7 +50,7 @@ struct _GstM3U8
   gchar *codecs;
   gint width;
   gint height;
-  GList *files;
+  GPtrArray *files;             /* GstM3U8MediaFile ordered by sequence */
 
   /*< private > */
   gchar *last_data;
@@ -66,6 +66,7 @@ struct _GstM3U8MediaFile
   GstClockTime duration;
   gchar *uri;
   guint sequence;               /* the sequence nb of this file */
+  GstClockTime timestamp;       /* sum of the durations of the previous files */
   gchar *key;
   guint8 iv[16];
 };
@@ -89,6 +90,8 @@ gboolean gst_m3u8_client_get_next_fragment (GstM3U8Client * client,
     GstClockTime * timestamp, const gchar ** key, const guint8 ** iv);
 void gst_m3u8_client_get_current_position (GstM3U8Client * client,
     GstClockTime * timestamp);
+gboolean gst_m3u8_client_get_sequence_at_time (GstM3U8Client * client,
+    GstClockTime time, gint * sequence);
 GstClockTime gst_m3u8_client_get_duration (GstM3U8Client * client);
 GstClockTime gst_m3u8_client_get_target_duration (GstM3U8Client * client);
 const gchar *gst_m3u8_client_get_uri(GstM3U8Client * client);
@@ -58,6 +58,10 @@ typedef struct _GstMssStreamQuality
 
   gchar *bitrate_str;
   guint64 bitrate;
+
+  /* the stream url template with the bitrate already substituted, split
+   * around the start time placeholders */
+  gchar **url_parts;
 } GstMssStreamQuality;
 
 struct _GstMssStream
@@ -67,17 +71,16 @@ struct _GstMssStream
   gboolean active;              /* if the stream is currently being used */
   gint selectedQualityIndex;
 
-  GList *fragments;
+  /* table of GstMssStreamFragment sorted by time, compiled from the
+   * manifest once and extended on live reloads */
+  GArray *fragments;
   GList *qualities;
 
   gchar *url;
+  guint64 timescale;
 
-  GList *current_fragment;
+  guint current_fragment;       /* index in fragments, == len at EOS */
   GList *current_quality;
-
-  /* TODO move this to somewhere static */
-  GRegex *regex_bitrate;
-  GRegex *regex_position;
 };
 
 struct _GstMssManifest
@@ -99,7 +102,8 @@ node_has_type (xmlNodePtr node, const gchar * name)
 }
 
 static GstMssStreamQuality *
-gst_mss_stream_quality_new (xmlNodePtr node)
+gst_mss_stream_quality_new (xmlNodePtr node, const gchar * url,
+    GRegex * regex_bitrate, GRegex * regex_position)
 {
   GstMssStreamQuality *q = g_slice_new (GstMssStreamQuality);
 
@@ -111,6 +115,19 @@ gst_mss_stream_quality_new (xmlNodePtr node)
   else
     q->bitrate = 0;
 
+  q->url_parts = NULL;
+  if (url) {
+    gchar *tmp;
+
+    tmp = g_regex_replace_literal (regex_bitrate, url, -1, 0,
+        q->bitrate_str ? q->bitrate_str : "", 0, NULL);
+    if (tmp) {
+      /* the fragment url is then only a join on the start time */
+      q->url_parts = g_regex_split (regex_position, tmp, 0);
+      g_free (tmp);
+    }
+  }
+
   return q;
 }
 
@@ -120,6 +137,7 @@ gst_mss_stream_quality_free (GstMssStreamQuality * quality)
   g_return_if_fail (quality != NULL);
 
   xmlFree (quality->bitrate_str);
+  g_strfreev (quality->url_parts);
   g_slice_free (GstMssStreamQuality, quality);
 }
 
@@ -134,25 +152,22 @@ compare_bitrate (GstMssStreamQuality * a, GstMssStreamQuality * b)
 
 }
 
+/* compiles the fragment nodes of @node into @fragments, appending them in
+ * document order */
 static void
-_gst_mss_stream_init (GstMssStream * stream, xmlNodePtr node)
+gst_mss_stream_parse_fragments (GArray * fragments, xmlNodePtr node)
 {
   xmlNodePtr iter;
-  GstMssStreamFragment *previous_fragment = NULL;
+  gint previous_fragment = -1;
   guint fragment_number = 0;
   guint64 fragment_time_accum = 0;
 
-  stream->xmlnode = node;
-
-  /* get the base url path generator */
-  stream->url = (gchar *) xmlGetProp (node, (xmlChar *) MSS_PROP_URL);
-
   for (iter = node->children; iter; iter = iter->next) {
     if (node_has_type (iter, MSS_NODE_STREAM_FRAGMENT)) {
       gchar *duration_str;
       gchar *time_str;
       gchar *seqnum_str;
-      GstMssStreamFragment *fragment = g_new (GstMssStreamFragment, 1);
+      GstMssStreamFragment fragment;
 
       duration_str = (gchar *) xmlGetProp (iter, (xmlChar *) MSS_PROP_DURATION);
       time_str = (gchar *) xmlGetProp (iter, (xmlChar *) MSS_PROP_TIME);
@@ -160,59 +175,102 @@ _gst_mss_stream_init (GstMssStream * stream, xmlNodePtr node)
 
       /* use the node's seq number or use the previous + 1 */
       if (seqnum_str) {
-        fragment->number = g_ascii_strtoull (seqnum_str, NULL, 10);
+        fragment.number = g_ascii_strtoull (seqnum_str, NULL, 10);
         xmlFree (seqnum_str);
-        fragment_number = fragment->number;
       } else {
-        fragment->number = fragment_number;
+        fragment.number = fragment_number;
       }
-      fragment_number = fragment->number + 1;
+      fragment_number = fragment.number + 1;
 
       if (time_str) {
-        fragment->time = g_ascii_strtoull (time_str, NULL, 10);
-
+        fragment.time = g_ascii_strtoull (time_str, NULL, 10);
         xmlFree (time_str);
-        fragment_time_accum = fragment->time;
+        fragment_time_accum = fragment.time;
       } else {
-        fragment->time = fragment_time_accum;
+        fragment.time = fragment_time_accum;
       }
 
       /* if we have a previous fragment, means we need to set its duration */
-      if (previous_fragment)
-        previous_fragment->duration = fragment->time - previous_fragment->time;
+      if (previous_fragment >= 0) {
+        GstMssStreamFragment *prev = &g_array_index (fragments,
+            GstMssStreamFragment, previous_fragment);
+
+        prev->duration = fragment.time - prev->time;
+      }
 
       if (duration_str) {
-        fragment->duration = g_ascii_strtoull (duration_str, NULL, 10);
+        fragment.duration = g_ascii_strtoull (duration_str, NULL, 10);
 
-        previous_fragment = NULL;
-        fragment_time_accum += fragment->duration;
+        previous_fragment = -1;
+        fragment_time_accum += fragment.duration;
         xmlFree (duration_str);
       } else {
         /* store to set the duration at the next iteration */
-        previous_fragment = fragment;
+        fragment.duration = 0;
+        previous_fragment = fragments->len;
       }
 
-      /* we reverse it later */
-      stream->fragments = g_list_prepend (stream->fragments, fragment);
-    } else if (node_has_type (iter, MSS_NODE_STREAM_QUALITY)) {
-      GstMssStreamQuality *quality = gst_mss_stream_quality_new (iter);
+      g_array_append_val (fragments, fragment);
+    }
+  }
+}
+
+static guint64
+_gst_mss_stream_parse_timescale (xmlNodePtr node)
+{
+  gchar *timescale;
+  guint64 ts = DEFAULT_TIMESCALE;
+
+  timescale = (gchar *) xmlGetProp (node, (xmlChar *) MSS_PROP_TIMESCALE);
+  if (!timescale) {
+    timescale =
+        (gchar *) xmlGetProp (node->parent, (xmlChar *) MSS_PROP_TIMESCALE);
+  }
+
+  if (timescale) {
+    ts = g_ascii_strtoull (timescale, NULL, 10);
+    xmlFree (timescale);
+  }
+  return ts;
+}
+
+static void
+_gst_mss_stream_init (GstMssStream * stream, xmlNodePtr node)
+{
+  xmlNodePtr iter;
+  GRegex *regex_bitrate;
+  GRegex *regex_position;
+
+  stream->xmlnode = node;
+
+  /* get the base url path generator */
+  stream->url = (gchar *) xmlGetProp (node, (xmlChar *) MSS_PROP_URL);
+  stream->timescale = _gst_mss_stream_parse_timescale (node);
+
+  /* the url template is only expanded here, once per quality level */
+  regex_bitrate = g_regex_new ("\\{[Bb]itrate\\}", 0, 0, NULL);
+  regex_position = g_regex_new ("\\{start[ _]time\\}", 0, 0, NULL);
+
+  for (iter = node->children; iter; iter = iter->next) {
+    if (node_has_type (iter, MSS_NODE_STREAM_QUALITY)) {
+      GstMssStreamQuality *quality = gst_mss_stream_quality_new (iter,
+          stream->url, regex_bitrate, regex_position);
       stream->qualities = g_list_prepend (stream->qualities, quality);
-    } else {
-      /* TODO gst log this */
     }
   }
 
-  stream->fragments = g_list_reverse (stream->fragments);
+  g_regex_unref (regex_position);
+  g_regex_unref (regex_bitrate);
+
+  stream->fragments = g_array_new (FALSE, FALSE, sizeof (GstMssStreamFragment));
+  gst_mss_stream_parse_fragments (stream->fragments, node);
 
   /* order them from smaller to bigger based on bitrates */
   stream->qualities =
       g_list_sort (stream->qualities, (GCompareFunc) compare_bitrate);
 
-  stream->current_fragment = stream->fragments;
+  stream->current_fragment = 0;
   stream->current_quality = stream->qualities;
-
-  stream->regex_bitrate = g_regex_new ("\\{[Bb]itrate\\}", 0, 0, NULL);
-  stream->regex_position = g_regex_new ("\\{start[ _]time\\}", 0, 0, NULL);
 }
 
 GstMssManifest *
@@ -258,12 +316,10 @@ gst_mss_manifest_new (GstBuffer * data)
 static void
 gst_mss_stream_free (GstMssStream * stream)
 {
-  g_list_free_full (stream->fragments, g_free);
+  g_array_free (stream->fragments, TRUE);
   g_list_free_full (stream->qualities,
       (GDestroyNotify) gst_mss_stream_quality_free);
   xmlFree (stream->url);
-  g_regex_unref (stream->regex_position);
-  g_regex_unref (stream->regex_bitrate);
   g_free (stream);
 }
 
@@ -654,22 +710,7 @@ gst_mss_stream_set_active (GstMssStream * stream, gboolean active)
 guint64
 gst_mss_stream_get_timescale (GstMssStream * stream)
 {
-  gchar *timescale;
-  guint64 ts = DEFAULT_TIMESCALE;
-
-  timescale =
-      (gchar *) xmlGetProp (stream->xmlnode, (xmlChar *) MSS_PROP_TIMESCALE);
-  if (!timescale) {
-    timescale =
-        (gchar *) xmlGetProp (stream->xmlnode->parent,
-        (xmlChar *) MSS_PROP_TIMESCALE);
-  }
-
-  if (timescale) {
-    ts = g_ascii_strtoull (timescale, NULL, 10);
-    xmlFree (timescale);
-  }
-  return ts;
+  return stream->timescale;
 }
 
 guint64
@@ -744,30 +785,24 @@ gst_mss_stream_get_caps (GstMssStream * stream)
 GstFlowReturn
 gst_mss_stream_get_fragment_url (GstMssStream * stream, gchar ** url)
 {
-  gchar *tmp;
-  gchar *start_time_str;
+  gchar start_time_str[24];
   GstMssStreamFragment *fragment;
   GstMssStreamQuality *quality = stream->current_quality->data;
 
   g_return_val_if_fail (stream->active, GST_FLOW_ERROR);
 
-  if (stream->current_fragment == NULL) /* stream is over */
+  if (stream->current_fragment >= stream->fragments->len)       /* stream is over */
     return GST_FLOW_EOS;
 
-  fragment = stream->current_fragment->data;
-
-  start_time_str = g_strdup_printf ("%" G_GUINT64_FORMAT, fragment->time);
-
-  tmp = g_regex_replace_literal (stream->regex_bitrate, stream->url,
-      strlen (stream->url), 0, quality->bitrate_str, 0, NULL);
-  *url = g_regex_replace_literal (stream->regex_position, tmp,
-      strlen (tmp), 0, start_time_str, 0, NULL);
+  if (quality->url_parts == NULL)
+    return GST_FLOW_ERROR;
 
-  g_free (tmp);
-  g_free (start_time_str);
+  fragment = &g_array_index (stream->fragments, GstMssStreamFragment,
+      stream->current_fragment);
 
-  if (*url == NULL)
-    return GST_FLOW_ERROR;
+  g_snprintf (start_time_str, sizeof (start_time_str), "%" G_GUINT64_FORMAT,
+      fragment->time);
+  *url = g_strjoinv (start_time_str, quality->url_parts);
 
   return GST_FLOW_OK;
 }
@@ -775,41 +810,35 @@ gst_mss_stream_get_fragment_url (GstMssStream * stream, gchar ** url)
 GstClockTime
 gst_mss_stream_get_fragment_gst_timestamp (GstMssStream * stream)
 {
-  guint64 time;
-  guint64 timescale;
   GstMssStreamFragment *fragment;
 
   g_return_val_if_fail (stream->active, GST_FLOW_ERROR);
 
-  if (!stream->current_fragment)
+  if (stream->current_fragment >= stream->fragments->len)
     return GST_CLOCK_TIME_NONE;
 
-  fragment = stream->current_fragment->data;
+  fragment = &g_array_index (stream->fragments, GstMssStreamFragment,
+      stream->current_fragment);
 
-  time = fragment->time;
-  timescale = gst_mss_stream_get_timescale (stream);
-  return (GstClockTime) gst_util_uint64_scale_round (time, GST_SECOND,
-      timescale);
+  return (GstClockTime) gst_util_uint64_scale_round (fragment->time,
+      GST_SECOND, stream->timescale);
 }
 
 GstClockTime
 gst_mss_stream_get_fragment_gst_duration (GstMssStream * stream)
 {
-  guint64 dur;
-  guint64 timescale;
   GstMssStreamFragment *fragment;
 
   g_return_val_if_fail (stream->active, GST_FLOW_ERROR);
 
-  if (!stream->current_fragment)
+  if (stream->current_fragment >= stream->fragments->len)
     return GST_CLOCK_TIME_NONE;
 
-  fragment = stream->current_fragment->data;
+  fragment = &g_array_index (stream->fragments, GstMssStreamFragment,
+      stream->current_fragment);
 
-  dur = fragment->duration;
-  timescale = gst_mss_stream_get_timescale (stream);
-  return (GstClockTime) gst_util_uint64_scale_round (dur, GST_SECOND,
-      timescale);
+  return (GstClockTime) gst_util_uint64_scale_round (fragment->duration,
+      GST_SECOND, stream->timescale);
 }
 
 GstFlowReturn
@@ -817,11 +846,11 @@ gst_mss_stream_advance_fragment (GstMssStream * stream)
 {
   g_return_val_if_fail (stream->active, GST_FLOW_ERROR);
 
-  if (stream->current_fragment == NULL)
+  if (stream->current_fragment >= stream->fragments->len)
     return GST_FLOW_EOS;
 
-  stream->current_fragment = g_list_next (stream->current_fragment);
-  if (stream->current_fragment == NULL)
+  stream->current_fragment++;
+  if (stream->current_fragment >= stream->fragments->len)
     return GST_FLOW_EOS;
   return GST_FLOW_OK;
 }
@@ -866,30 +895,34 @@ gst_mss_manifest_seek (GstMssManifest * manifest, guint64 time)
 gboolean
 gst_mss_stream_seek (GstMssStream * stream, guint64 time)
 {
-  GList *iter;
-  guint64 timescale;
+  GstMssStreamFragment *fragment;
+  guint lo, hi;
 
-  timescale = gst_mss_stream_get_timescale (stream);
-  time = gst_util_uint64_scale_round (time, timescale, GST_SECOND);
+  time = gst_util_uint64_scale_round (time, stream->timescale, GST_SECOND);
 
-  for (iter = stream->fragments; iter; iter = g_list_next (iter)) {
-    GList *next = g_list_next (iter);
-    if (next) {
-      GstMssStreamFragment *fragment = next->data;
+  if (stream->fragments->len == 0)
+    return TRUE;
 
-      if (fragment->time > time) {
-        stream->current_fragment = iter;
-        break;
-      }
-    } else {
-      GstMssStreamFragment *fragment = iter->data;
-      if (fragment->time + fragment->duration > time) {
-        stream->current_fragment = iter;
-      } else {
-        stream->current_fragment = NULL;        /* EOS */
-      }
-      break;
-    }
+  /* find the last fragment starting at or before time, the first one is
+   * picked for any time before the start of the table */
+  lo = 0;
+  hi = stream->fragments->len;
+  while (hi - lo > 1) {
+    guint mid = lo + (hi - lo) / 2;
+
+    fragment = &g_array_index (stream->fragments, GstMssStreamFragment, mid);
+    if (fragment->time > time)
+      hi = mid;
+    else
+      lo = mid;
+  }
+
+  fragment = &g_array_index (stream->fragments, GstMssStreamFragment, lo);
+  if (lo == stream->fragments->len - 1
+      && fragment->time + fragment->duration <= time) {
+    stream->current_fragment = stream->fragments->len;  /* EOS */
+  } else {
+    stream->current_fragment = lo;
   }
 
   return TRUE;
@@ -923,90 +956,47 @@ gst_mss_manifest_is_live (GstMssManifest * manifest)
 static void
 gst_mss_stream_reload_fragments (GstMssStream * stream, xmlNodePtr streamIndex)
 {
-  xmlNodePtr iter;
-  GList *new_fragments = NULL;
-  GstMssStreamFragment *previous_fragment = NULL;
-  GstMssStreamFragment *current_fragment =
-      stream->current_fragment ? stream->current_fragment->data : NULL;
-  guint64 current_time = gst_mss_stream_get_fragment_gst_timestamp (stream);
-  guint fragment_number = 0;
-  guint64 fragment_time_accum = 0;
+  GArray *new_fragments;
+  GstMssStreamFragment *last = NULL;
+  guint i;
 
-  if (!current_fragment && stream->fragments) {
-    current_fragment = g_list_last (stream->fragments)->data;
-  } else if (g_list_previous (stream->current_fragment)) {
-    /* rewind one as this is the next to be pushed */
-    current_fragment = g_list_previous (stream->current_fragment)->data;
-  } else {
-    current_fragment = NULL;
-  }
+  new_fragments = g_array_new (FALSE, FALSE, sizeof (GstMssStreamFragment));
+  gst_mss_stream_parse_fragments (new_fragments, streamIndex);
 
-  if (current_fragment) {
-    current_time = current_fragment->time;
-    fragment_number = current_fragment->number;
-    fragment_time_accum = current_fragment->time;
+  if (stream->fragments->len > 0) {
+    last = &g_array_index (stream->fragments, GstMssStreamFragment,
+        stream->fragments->len - 1);
   }
 
-  for (iter = streamIndex->children; iter; iter = iter->next) {
-    if (node_has_type (iter, MSS_NODE_STREAM_FRAGMENT)) {
-      gchar *duration_str;
-      gchar *time_str;
-      gchar *seqnum_str;
-      GstMssStreamFragment *fragment = g_new (GstMssStreamFragment, 1);
-
-      duration_str = (gchar *) xmlGetProp (iter, (xmlChar *) MSS_PROP_DURATION);
-      time_str = (gchar *) xmlGetProp (iter, (xmlChar *) MSS_PROP_TIME);
-      seqnum_str = (gchar *) xmlGetProp (iter, (xmlChar *) MSS_PROP_NUMBER);
-
-      /* use the node's seq number or use the previous + 1 */
-      if (seqnum_str) {
-        fragment->number = g_ascii_strtoull (seqnum_str, NULL, 10);
-        xmlFree (seqnum_str);
-      } else {
-        fragment->number = fragment_number;
-      }
-      fragment_number = fragment->number + 1;
-
-      if (time_str) {
-        fragment->time = g_ascii_strtoull (time_str, NULL, 10);
-        xmlFree (time_str);
-        fragment_time_accum = fragment->time;
-      } else {
-        fragment->time = fragment_time_accum;
-      }
-
-      /* if we have a previous fragment, means we need to set its duration */
-      if (previous_fragment)
-        previous_fragment->duration = fragment->time - previous_fragment->time;
-
-      if (duration_str) {
-        fragment->duration = g_ascii_strtoull (duration_str, NULL, 10);
-
-        previous_fragment = NULL;
-        fragment_time_accum += fragment->duration;
-        xmlFree (duration_str);
-      } else {
-        /* store to set the duration at the next iteration */
-        previous_fragment = fragment;
-      }
-
-      if (fragment->time > current_time) {
-        new_fragments = g_list_append (new_fragments, fragment);
-      } else {
-        previous_fragment = NULL;
-        g_free (fragment);
-      }
+  /* only append what is newer than the end of the table, the current
+   * position stays valid and if we were at EOS it now points to the first
+   * new fragment */
+  for (i = 0; i < new_fragments->len; i++) {
+    GstMssStreamFragment *fragment =
+        &g_array_index (new_fragments, GstMssStreamFragment, i);
 
-    } else {
-      /* TODO gst log this */
+    if (last == NULL || fragment->time > last->time)
+      break;
+  }
+  if (i < new_fragments->len) {
+    /* the previous end of the table might have been missing its duration */
+    if (last && last->duration == 0) {
+      last->duration = g_array_index (new_fragments, GstMssStreamFragment,
+          i).time - last->time;
     }
+    g_array_append_vals (stream->fragments,
+        &g_array_index (new_fragments, GstMssStreamFragment, i),
+        new_fragments->len - i);
   }
+  g_array_free (new_fragments, TRUE);
+
+  /* drop the fragments that were already pushed so the table doesn't grow
+   * forever on long running live streams */
+  if (stream->current_fragment > 1) {
+    guint drop = stream->current_fragment - 1;
 
-  /* store the new fragments list */
-  if (new_fragments) {
-    g_list_free_full (stream->fragments, g_free);
-    stream->fragments = new_fragments;
-    stream->current_fragment = new_fragments;
+    g_array_remove_range (stream->fragments, 0, drop);
+    stream->current_fragment -= drop;
   }
 }
 
@@ -47,6 +47,8 @@
 #include "config.h"
 #endif
 
+#include <stdlib.h>
+
 #include "debugutils-marshal.h"
 #include "fpsdisplaysink.h"
 
@@ -55,6 +57,7 @@
 #define DEFAULT_FONT "Sans 15"
 #define DEFAULT_SILENT FALSE
 #define DEFAULT_LAST_MESSAGE NULL
+#define DEFAULT_POST_MESSAGES FALSE
 
 /* generic templates */
 static GstStaticPadTemplate fps_display_sink_template =
@@ -88,7 +91,9 @@ enum
   PROP_FRAMES_DROPPED,
   PROP_FRAMES_RENDERED,
   PROP_SILENT,
-  PROP_LAST_MESSAGE
+  PROP_LAST_MESSAGE,
+  PROP_POST_MESSAGES,
+  PROP_STATS
       /* FILL ME */
 };
 
@@ -185,6 +190,28 @@ fps_display_sink_class_init (GstFPSDisplaySinkClass * klass)
   g_object_class_install_property (gobject_klass, PROP_LAST_MESSAGE,
       pspec_last_message);
 
+  g_object_class_install_property (gobject_klass, PROP_POST_MESSAGES,
+      g_param_spec_boolean ("post-messages", "Post messages",
+          "Post an element message with the frame timing statistics "
+          "at every fps update interval", DEFAULT_POST_MESSAGES,
+          G_PARAM_STATIC_STRINGS | G_PARAM_READWRITE));
+
+  /**
+   * GstFPSDisplaySink:stats:
+   *
+   * Frame timing statistics of the last fps update interval: rendered and
+   * dropped counts, fps, render lateness and inter-frame jitter
+   * percentiles (p50, p95, p99, in nanoseconds) and the number of frames
+   * dropped per QoS type. All counters start from zero at every interval,
+   * only average-fps is computed since the start. The same structure is
+   * posted as element message when #GstFPSDisplaySink:post-messages is
+   * enabled.
+   */
+  g_object_class_install_property (gobject_klass, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Frame timing statistics of the last update interval",
+          GST_TYPE_STRUCTURE, G_PARAM_STATIC_STRINGS | G_PARAM_READABLE));
+
   /**
    * GstFPSDisplaySink::fps-measurements:
    * @fpsdisplaysink: a #GstFPSDisplaySink
@@ -243,20 +270,51 @@ on_video_sink_data_flow (GstPad * pad, GstPadProbeInfo * info,
     GstEvent *ev = GST_EVENT_CAST (mini_obj);
 
     if (GST_EVENT_TYPE (ev) == GST_EVENT_QOS) {
+      GstQOSType type;
       GstClockTimeDiff diff;
       GstClockTime ts;
+      guint idx;
 
-      gst_event_parse_qos (ev, NULL, NULL, &diff, &ts);
+      gst_event_parse_qos (ev, &type, NULL, &diff, &ts);
       if (diff <= 0.0) {
         g_atomic_int_inc (&self->frames_rendered);
       } else {
         g_atomic_int_inc (&self->frames_dropped);
+        switch (type) {
+          case GST_QOS_TYPE_OVERFLOW:
+            g_atomic_int_inc (&self->drops_overflow);
+            break;
+          case GST_QOS_TYPE_UNDERFLOW:
+            g_atomic_int_inc (&self->drops_underflow);
+            break;
+          case GST_QOS_TYPE_THROTTLE:
+            g_atomic_int_inc (&self->drops_throttle);
+            break;
+        }
       }
 
       ts = gst_util_get_timestamp ();
       if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (self->start_ts))) {
         self->interval_ts = self->last_ts = self->start_ts = ts;
       }
+
+      /* record lateness and the change in inter-frame interval; the ring
+       * wraps if more frames arrive within one update interval */
+      idx = self->n_samples % FPS_DISPLAY_SINK_STATS_SIZE;
+      self->lateness[idx] = diff;
+      if (GST_CLOCK_TIME_IS_VALID (self->last_frame_ts)) {
+        GstClockTimeDiff interval = GST_CLOCK_DIFF (self->last_frame_ts, ts);
+
+        if (self->last_frame_interval >= 0)
+          self->jitter[idx] = ABS (interval - self->last_frame_interval);
+        else
+          self->jitter[idx] = 0;
+        self->last_frame_interval = interval;
+      } else {
+        self->jitter[idx] = 0;
+      }
+      self->last_frame_ts = ts;
+      self->n_samples++;
       if (GST_CLOCK_DIFF (self->interval_ts, ts) > self->fps_update_interval) {
         display_current_fps (self);
         self->interval_ts = ts;
@@ -359,12 +417,76 @@ fps_display_sink_init (GstFPSDisplaySink * self,
   self->max_fps = -1;
   self->min_fps = -1;
   self->silent = DEFAULT_SILENT;
+  self->post_messages = DEFAULT_POST_MESSAGES;
   self->last_message = g_strdup (DEFAULT_LAST_MESSAGE);
 
   self->ghost_pad = gst_ghost_pad_new_no_target ("sink", GST_PAD_SINK);
   gst_element_add_pad (GST_ELEMENT (self), self->ghost_pad);
 }
 
+static int
+compare_clock_diff (const void *a, const void *b)
+{
+  GstClockTimeDiff da = *(const GstClockTimeDiff *) a;
+  GstClockTimeDiff db = *(const GstClockTimeDiff *) b;
+
+  return (da > db) - (da < db);
+}
+
+/* @samples must be sorted */
+static GstClockTimeDiff
+percentile (GstClockTimeDiff * samples, guint n, guint pct)
+{
+  if (n == 0)
+    return 0;
+  return samples[(n - 1) * pct / 100];
+}
+
+static GstStructure *
+fps_display_sink_collect_stats (GstFPSDisplaySink * self,
+    guint64 frames_rendered, guint64 frames_dropped, gdouble rr,
+    gdouble average_fps)
+{
+  GstClockTimeDiff *lateness = self->lateness;
+  GstClockTimeDiff *jitter = self->jitter;
+  guint n = MIN (self->n_samples, FPS_DISPLAY_SINK_STATS_SIZE);
+  gint drops_overflow, drops_underflow, drops_throttle;
+  GstStructure *s;
+
+  /* take the drops of this interval, the streaming thread may count more
+   * in the meantime */
+  drops_overflow = g_atomic_int_get (&self->drops_overflow);
+  g_atomic_int_add (&self->drops_overflow, -drops_overflow);
+  drops_underflow = g_atomic_int_get (&self->drops_underflow);
+  g_atomic_int_add (&self->drops_underflow, -drops_underflow);
+  drops_throttle = g_atomic_int_get (&self->drops_throttle);
+  g_atomic_int_add (&self->drops_throttle, -drops_throttle);
+
+  qsort (lateness, n, sizeof (GstClockTimeDiff), compare_clock_diff);
+  qsort (jitter, n, sizeof (GstClockTimeDiff), compare_clock_diff);
+
+  s = gst_structure_new ("fpsdisplaysink-stats",
+      "frames-rendered", G_TYPE_UINT64, frames_rendered,
+      "frames-dropped", G_TYPE_UINT64, frames_dropped,
+      "current-fps", G_TYPE_DOUBLE, rr,
+      "average-fps", G_TYPE_DOUBLE, average_fps,
+      "samples", G_TYPE_UINT, n,
+      "lateness-p50", G_TYPE_INT64, percentile (lateness, n, 50),
+      "lateness-p95", G_TYPE_INT64, percentile (lateness, n, 95),
+      "lateness-p99", G_TYPE_INT64, percentile (lateness, n, 99),
+      "lateness-max", G_TYPE_INT64, n ? lateness[n - 1] : 0,
+      "jitter-p50", G_TYPE_INT64, percentile (jitter, n, 50),
+      "jitter-p95", G_TYPE_INT64, percentile (jitter, n, 95),
+      "jitter-p99", G_TYPE_INT64, percentile (jitter, n, 99),
+      "dropped-overflow", G_TYPE_UINT, (guint) drops_overflow,
+      "dropped-underflow", G_TYPE_UINT, (guint) drops_underflow,
+      "dropped-throttle", G_TYPE_UINT, (guint) drops_throttle, NULL);
+
+  self->n_samples = 0;
+
+  return s;
+}
+
 static gboolean
 display_current_fps (gpointer data)
 {
@@ -374,6 +496,7 @@ display_current_fps (gpointer data)
   gchar fps_message[256];
   gdouble time_diff, time_elapsed;
   GstClockTime current_ts = gst_util_get_timestamp ();
+  GstStructure *stats;
 
   frames_rendered = g_atomic_int_get (&self->frames_rendered);
   frames_dropped = g_atomic_int_get (&self->frames_dropped);
@@ -400,6 +523,20 @@ display_current_fps (gpointer data)
     GST_DEBUG_OBJECT (self, "Updated min-fps to %f", rr);
   }
 
+  stats = fps_display_sink_collect_stats (self,
+      frames_rendered - self->last_frames_rendered,
+      frames_dropped - self->last_frames_dropped, rr, average_fps);
+  if (self->post_messages) {
+    gst_element_post_message (GST_ELEMENT_CAST (self),
+        gst_message_new_element (GST_OBJECT_CAST (self),
+            gst_structure_copy (stats)));
+  }
+  GST_OBJECT_LOCK (self);
+  if (self->stats)
+    gst_structure_free (self->stats);
+  self->stats = stats;
+  GST_OBJECT_UNLOCK (self);
+
   if (self->signal_measurements) {
     GST_LOG_OBJECT (self, "Signaling measurements: fps:%f droprate:%f "
         "avg-fps:%f", rr, dr, average_fps);
@@ -461,9 +598,21 @@ fps_display_sink_start (GstFPSDisplaySink * self)
   self->last_frames_dropped = G_GUINT64_CONSTANT (0);
   self->max_fps = -1;
   self->min_fps = -1;
+  self->n_samples = 0;
+  self->drops_overflow = 0;
+  self->drops_underflow = 0;
+  self->drops_throttle = 0;
+  self->last_frame_interval = -1;
 
   /* init time stamps */
   self->last_ts = self->start_ts = self->interval_ts = GST_CLOCK_TIME_NONE;
+  self->last_frame_ts = GST_CLOCK_TIME_NONE;
+
+  GST_OBJECT_LOCK (self);
+  if (self->stats)
+    gst_structure_free (self->stats);
+  self->stats = NULL;
+  GST_OBJECT_UNLOCK (self);
 
   GST_DEBUG_OBJECT (self, "Use text-overlay? %d", self->use_text_overlay);
 
@@ -552,6 +701,9 @@ fps_display_sink_dispose (GObject * object)
   GST_OBJECT_LOCK (self);
   g_free (self->last_message);
   self->last_message = NULL;
+  if (self->stats)
+    gst_structure_free (self->stats);
+  self->stats = NULL;
   GST_OBJECT_UNLOCK (self);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
@@ -602,6 +754,9 @@ fps_display_sink_set_property (GObject * object, guint prop_id,
     case PROP_SILENT:
       self->silent = g_value_get_boolean (value);
       break;
+    case PROP_POST_MESSAGES:
+      self->post_messages = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -650,6 +805,14 @@ fps_display_sink_get_property (GObject * object, guint prop_id,
       g_value_set_string (value, self->last_message);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_POST_MESSAGES:
+      g_value_set_boolean (value, self->post_messages);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boxed (value, self->stats);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
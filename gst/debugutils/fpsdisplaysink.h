@@ -37,6 +37,9 @@ G_BEGIN_DECLS
 
 GType fps_display_sink_get_type (void);
 
+/* number of per-frame samples kept between two stats updates */
+#define FPS_DISPLAY_SINK_STATS_SIZE 1024
+
 typedef struct _GstFPSDisplaySink GstFPSDisplaySink;
 typedef struct _GstFPSDisplaySinkClass GstFPSDisplaySinkClass;
 
@@ -59,10 +62,20 @@ struct _GstFPSDisplaySink
   GstClockTime interval_ts;
   guint data_probe_id;
 
+  /* ring of per-frame samples, only touched by the streaming thread */
+  GstClockTimeDiff lateness[FPS_DISPLAY_SINK_STATS_SIZE];
+  GstClockTimeDiff jitter[FPS_DISPLAY_SINK_STATS_SIZE];
+  guint n_samples;
+  GstClockTime last_frame_ts;
+  GstClockTimeDiff last_frame_interval;
+  gint drops_overflow, drops_underflow, drops_throttle;  /* ATOMIC */
+  GstStructure *stats;  /* protected by the object lock */
+
   /* properties */
   gboolean sync;
   gboolean use_text_overlay;
   gboolean signal_measurements;
+  gboolean post_messages;
   GstClockTime fps_update_interval;
   gdouble max_fps;
   gdouble min_fps;
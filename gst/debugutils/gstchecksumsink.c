@@ -21,17 +21,59 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/video/video.h>
 #include "gstchecksumsink.h"
 
+#define DEFAULT_HASH GST_CHECKSUM_SINK_HASH_SHA1
+#define DEFAULT_PER_PLANE FALSE
+
+enum
+{
+  PROP_0,
+  PROP_HASH,
+  PROP_PER_PLANE,
+  PROP_STREAM_CHECKSUM
+};
+
+#define GST_CHECKSUM_SINK_HASH_TYPE (gst_checksum_sink_hash_get_type())
+static GType
+gst_checksum_sink_hash_get_type (void)
+{
+  static GType hash_type = 0;
+
+  static const GEnumValue hash_types[] = {
+    {GST_CHECKSUM_SINK_HASH_SHA1, "SHA-1", "sha1"},
+    {GST_CHECKSUM_SINK_HASH_MD5, "MD5", "md5"},
+    {GST_CHECKSUM_SINK_HASH_SHA256, "SHA-256", "sha256"},
+    {GST_CHECKSUM_SINK_HASH_XXH64, "xxHash64 (fast, non-cryptographic)",
+        "xxh64"},
+    {0, NULL, NULL}
+  };
+
+  if (!hash_type) {
+    hash_type = g_enum_register_static ("GstChecksumSinkHash", hash_types);
+  }
+  return hash_type;
+}
+
+static void gst_checksum_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_checksum_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 static void gst_checksum_sink_dispose (GObject * object);
 static void gst_checksum_sink_finalize (GObject * object);
 
 static gboolean gst_checksum_sink_start (GstBaseSink * sink);
 static gboolean gst_checksum_sink_stop (GstBaseSink * sink);
+static gboolean gst_checksum_sink_set_caps (GstBaseSink * sink,
+    GstCaps * caps);
 static GstFlowReturn
 gst_checksum_sink_render (GstBaseSink * sink, GstBuffer * buffer);
+static void gst_checksum_sink_plane_func (gpointer data, gpointer user_data);
 
 static GstStaticPadTemplate gst_checksum_sink_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
@@ -57,10 +99,13 @@ gst_checksum_sink_class_init (GstChecksumSinkClass * klass)
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstBaseSinkClass *base_sink_class = GST_BASE_SINK_CLASS (klass);
 
+  gobject_class->set_property = gst_checksum_sink_set_property;
+  gobject_class->get_property = gst_checksum_sink_get_property;
   gobject_class->dispose = gst_checksum_sink_dispose;
   gobject_class->finalize = gst_checksum_sink_finalize;
   base_sink_class->start = GST_DEBUG_FUNCPTR (gst_checksum_sink_start);
   base_sink_class->stop = GST_DEBUG_FUNCPTR (gst_checksum_sink_stop);
+  base_sink_class->set_caps = GST_DEBUG_FUNCPTR (gst_checksum_sink_set_caps);
   base_sink_class->render = GST_DEBUG_FUNCPTR (gst_checksum_sink_render);
 
   gst_element_class_add_pad_template (element_class,
@@ -71,12 +116,88 @@ gst_checksum_sink_class_init (GstChecksumSinkClass * klass)
   gst_element_class_set_static_metadata (element_class, "Checksum sink",
       "Debug/Sink", "Calculates a checksum for buffers",
       "David Schleef <ds@schleef.org>");
+
+  g_object_class_install_property (gobject_class, PROP_HASH,
+      g_param_spec_enum ("hash", "Hash",
+          "Hash algorithm used for buffer, plane and stream digests",
+          GST_CHECKSUM_SINK_HASH_TYPE, DEFAULT_HASH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PER_PLANE,
+      g_param_spec_boolean ("per-plane", "Per plane",
+          "Hash the visible pixels of each plane of raw video in parallel "
+          "and print the plane digests after the frame digest",
+          DEFAULT_PER_PLANE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_STREAM_CHECKSUM,
+      g_param_spec_string ("stream-checksum", "Stream checksum",
+          "Running digest over the digests of all frames rendered so far",
+          NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
 gst_checksum_sink_init (GstChecksumSink * checksumsink)
 {
   gst_base_sink_set_sync (GST_BASE_SINK (checksumsink), FALSE);
+
+  checksumsink->hash = DEFAULT_HASH;
+  checksumsink->per_plane = DEFAULT_PER_PLANE;
+  g_mutex_init (&checksumsink->lock);
+  g_cond_init (&checksumsink->cond);
+}
+
+static void
+gst_checksum_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (object);
+
+  switch (prop_id) {
+    case PROP_HASH:
+      checksumsink->hash = g_value_get_enum (value);
+      break;
+    case PROP_PER_PLANE:
+      checksumsink->per_plane = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_checksum_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (object);
+
+  switch (prop_id) {
+    case PROP_HASH:
+      g_value_set_enum (value, checksumsink->hash);
+      break;
+    case PROP_PER_PLANE:
+      g_value_set_boolean (value, checksumsink->per_plane);
+      break;
+    case PROP_STREAM_CHECKSUM:
+      GST_OBJECT_LOCK (checksumsink);
+      g_value_set_string (value, checksumsink->stream_digest);
+      GST_OBJECT_UNLOCK (checksumsink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_checksum_sink_reset_stream (GstChecksumSink * checksumsink)
+{
+  GST_OBJECT_LOCK (checksumsink);
+  if (checksumsink->stream_checksum)
+    g_checksum_free (checksumsink->stream_checksum);
+  checksumsink->stream_checksum = NULL;
+  xxh64_reset (&checksumsink->stream_xxh);
+  g_free (checksumsink->stream_digest);
+  checksumsink->stream_digest = NULL;
+  GST_OBJECT_UNLOCK (checksumsink);
 }
 
 void
@@ -88,33 +209,455 @@ gst_checksum_sink_dispose (GObject * object)
 void
 gst_checksum_sink_finalize (GObject * object)
 {
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (object);
+
+  if (checksumsink->pool)
+    g_thread_pool_free (checksumsink->pool, FALSE, TRUE);
+  gst_checksum_sink_reset_stream (checksumsink);
+  g_mutex_clear (&checksumsink->lock);
+  g_cond_clear (&checksumsink->cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* xxHash64 with a streaming state, so that the digest does not depend on
+ * how the data is split over update calls (for example per row when the
+ * rows of a plane are padded) */
+#define XXH_PRIME64_1 G_GUINT64_CONSTANT (0x9E3779B185EBCA87)
+#define XXH_PRIME64_2 G_GUINT64_CONSTANT (0xC2B2AE3D27D4EB4F)
+#define XXH_PRIME64_3 G_GUINT64_CONSTANT (0x165667B19E3779F9)
+#define XXH_PRIME64_4 G_GUINT64_CONSTANT (0x85EBCA77C2B2AE63)
+#define XXH_PRIME64_5 G_GUINT64_CONSTANT (0x27D4EB2F165667C5)
+#define XXH_ROTL64(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static inline guint64
+xxh64_read64 (const guint8 * p)
+{
+  guint64 v;
+
+  memcpy (&v, p, 8);
+  return GUINT64_FROM_LE (v);
+}
+
+static inline guint32
+xxh64_read32 (const guint8 * p)
+{
+  guint32 v;
+
+  memcpy (&v, p, 4);
+  return GUINT32_FROM_LE (v);
+}
+
+static inline guint64
+xxh64_round (guint64 acc, guint64 input)
+{
+  acc += input * XXH_PRIME64_2;
+  acc = XXH_ROTL64 (acc, 31);
+  return acc * XXH_PRIME64_1;
+}
+
+static inline guint64
+xxh64_merge (guint64 acc, guint64 val)
+{
+  acc ^= xxh64_round (0, val);
+  return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+static void
+xxh64_reset (GstChecksumSinkXxh64 * state)
+{
+  state->total_len = 0;
+  state->v[0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+  state->v[1] = XXH_PRIME64_2;
+  state->v[2] = 0;
+  state->v[3] = -XXH_PRIME64_1;
+  state->mem_size = 0;
+}
+
+/* consume 32 byte stripes; four independent lanes, the compiler can keep
+ * them in registers */
+static const guint8 *
+xxh64_stripes (GstChecksumSinkXxh64 * state, const guint8 * p,
+    const guint8 * end)
+{
+  guint64 v1 = state->v[0], v2 = state->v[1];
+  guint64 v3 = state->v[2], v4 = state->v[3];
+
+  while (end - p >= 32) {
+    v1 = xxh64_round (v1, xxh64_read64 (p));
+    v2 = xxh64_round (v2, xxh64_read64 (p + 8));
+    v3 = xxh64_round (v3, xxh64_read64 (p + 16));
+    v4 = xxh64_round (v4, xxh64_read64 (p + 24));
+    p += 32;
+  }
+  state->v[0] = v1;
+  state->v[1] = v2;
+  state->v[2] = v3;
+  state->v[3] = v4;
+
+  return p;
+}
+
+static void
+xxh64_update (GstChecksumSinkXxh64 * state, const guint8 * p, gsize len)
+{
+  const guint8 *end = p + len;
+
+  state->total_len += len;
+
+  if (state->mem_size + len < 32) {
+    memcpy (state->mem + state->mem_size, p, len);
+    state->mem_size += len;
+    return;
+  }
+
+  if (state->mem_size) {
+    guint fill = 32 - state->mem_size;
+
+    memcpy (state->mem + state->mem_size, p, fill);
+    xxh64_stripes (state, state->mem, state->mem + 32);
+    p += fill;
+    state->mem_size = 0;
+  }
+
+  p = xxh64_stripes (state, p, end);
+
+  if (p < end) {
+    state->mem_size = end - p;
+    memcpy (state->mem, p, state->mem_size);
+  }
+}
+
+static guint64
+xxh64_digest (const GstChecksumSinkXxh64 * state)
+{
+  const guint8 *p = state->mem;
+  const guint8 *end = p + state->mem_size;
+  guint64 h;
+
+  if (state->total_len >= 32) {
+    h = XXH_ROTL64 (state->v[0], 1) + XXH_ROTL64 (state->v[1], 7) +
+        XXH_ROTL64 (state->v[2], 12) + XXH_ROTL64 (state->v[3], 18);
+    h = xxh64_merge (h, state->v[0]);
+    h = xxh64_merge (h, state->v[1]);
+    h = xxh64_merge (h, state->v[2]);
+    h = xxh64_merge (h, state->v[3]);
+  } else {
+    h = state->v[2] + XXH_PRIME64_5;
+  }
+
+  h += state->total_len;
+
+  while (p + 8 <= end) {
+    h ^= xxh64_round (0, xxh64_read64 (p));
+    h = XXH_ROTL64 (h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h ^= (guint64) xxh64_read32 (p) * XXH_PRIME64_1;
+    h = XXH_ROTL64 (h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= (*p) * XXH_PRIME64_5;
+    h = XXH_ROTL64 (h, 11) * XXH_PRIME64_1;
+    p++;
+  }
+
+  h ^= h >> 33;
+  h *= XXH_PRIME64_2;
+  h ^= h >> 29;
+  h *= XXH_PRIME64_3;
+  h ^= h >> 32;
+
+  return h;
+}
+
+typedef struct
+{
+  GstChecksumSinkHash hash;
+  GChecksum *checksum;
+  GstChecksumSinkXxh64 xxh;
+} GstChecksumSinkHasher;
+
+static void
+gst_checksum_sink_hasher_init (GstChecksumSinkHasher * hasher,
+    GstChecksumSinkHash hash)
+{
+  hasher->hash = hash;
+  hasher->checksum = NULL;
+  xxh64_reset (&hasher->xxh);
+
+  switch (hash) {
+    case GST_CHECKSUM_SINK_HASH_MD5:
+      hasher->checksum = g_checksum_new (G_CHECKSUM_MD5);
+      break;
+    case GST_CHECKSUM_SINK_HASH_SHA256:
+      hasher->checksum = g_checksum_new (G_CHECKSUM_SHA256);
+      break;
+    case GST_CHECKSUM_SINK_HASH_XXH64:
+      break;
+    case GST_CHECKSUM_SINK_HASH_SHA1:
+    default:
+      hasher->checksum = g_checksum_new (G_CHECKSUM_SHA1);
+      break;
+  }
+}
+
+static inline void
+gst_checksum_sink_hasher_update (GstChecksumSinkHasher * hasher,
+    const guint8 * data, gsize size)
+{
+  if (hasher->checksum)
+    g_checksum_update (hasher->checksum, data, size);
+  else
+    xxh64_update (&hasher->xxh, data, size);
+}
+
+static gchar *
+gst_checksum_sink_hasher_finish (GstChecksumSinkHasher * hasher)
+{
+  gchar *s;
+
+  if (hasher->checksum) {
+    s = g_strdup (g_checksum_get_string (hasher->checksum));
+    g_checksum_free (hasher->checksum);
+    hasher->checksum = NULL;
+  } else {
+    s = g_strdup_printf ("%016" G_GINT64_MODIFIER "x",
+        xxh64_digest (&hasher->xxh));
+  }
+
+  return s;
+}
+
+typedef struct
+{
+  GstChecksumSink *checksumsink;
+  const guint8 *data;
+  gint stride;
+  gsize row_size;
+  gint height;
+  gchar *digest;
+} GstChecksumSinkPlane;
+
+static void
+gst_checksum_sink_hash_plane (GstChecksumSink * checksumsink,
+    GstChecksumSinkPlane * plane)
+{
+  GstChecksumSinkHasher hasher;
+  const guint8 *data = plane->data;
+  gint i;
+
+  /* all hashes are streaming, so the digest is the same whether the rows
+   * are contiguous or not */
+  gst_checksum_sink_hasher_init (&hasher, checksumsink->hash);
+  if (plane->row_size == (gsize) plane->stride) {
+    gst_checksum_sink_hasher_update (&hasher, data,
+        plane->row_size * plane->height);
+  } else {
+    /* skip the padding at the end of each row */
+    for (i = 0; i < plane->height; i++) {
+      gst_checksum_sink_hasher_update (&hasher, data, plane->row_size);
+      data += plane->stride;
+    }
+  }
+  plane->digest = gst_checksum_sink_hasher_finish (&hasher);
+}
+
+static void
+gst_checksum_sink_plane_func (gpointer data, gpointer user_data)
+{
+  GstChecksumSinkPlane *plane = data;
+  GstChecksumSink *checksumsink = plane->checksumsink;
+
+  gst_checksum_sink_hash_plane (checksumsink, plane);
+
+  g_mutex_lock (&checksumsink->lock);
+  checksumsink->pending--;
+  if (checksumsink->pending == 0)
+    g_cond_signal (&checksumsink->cond);
+  g_mutex_unlock (&checksumsink->lock);
+}
+
 static gboolean
 gst_checksum_sink_start (GstBaseSink * sink)
 {
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (sink);
+
+  gst_checksum_sink_reset_stream (checksumsink);
+  checksumsink->is_video = FALSE;
+
   return TRUE;
 }
 
 static gboolean
 gst_checksum_sink_stop (GstBaseSink * sink)
 {
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (sink);
+
+  if (checksumsink->pool) {
+    g_thread_pool_free (checksumsink->pool, FALSE, TRUE);
+    checksumsink->pool = NULL;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_checksum_sink_set_caps (GstBaseSink * sink, GstCaps * caps)
+{
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (sink);
+
+  checksumsink->is_video = gst_video_info_from_caps (&checksumsink->info,
+      caps);
+
   return TRUE;
 }
 
+static void
+gst_checksum_sink_update_stream (GstChecksumSink * checksumsink,
+    const gchar * digest)
+{
+  GstChecksumSinkHasher hasher;
+  gsize len = strlen (digest);
+
+  GST_OBJECT_LOCK (checksumsink);
+  if (checksumsink->hash == GST_CHECKSUM_SINK_HASH_XXH64) {
+    if (checksumsink->stream_checksum) {
+      g_checksum_free (checksumsink->stream_checksum);
+      checksumsink->stream_checksum = NULL;
+    }
+    xxh64_update (&checksumsink->stream_xxh, (const guint8 *) digest, len);
+    hasher.checksum = NULL;
+    hasher.xxh = checksumsink->stream_xxh;
+  } else {
+    if (!checksumsink->stream_checksum) {
+      gst_checksum_sink_hasher_init (&hasher, checksumsink->hash);
+      checksumsink->stream_checksum = hasher.checksum;
+    }
+    g_checksum_update (checksumsink->stream_checksum,
+        (const guchar *) digest, len);
+    /* get_string closes the checksum, read it from a copy */
+    hasher.checksum = g_checksum_copy (checksumsink->stream_checksum);
+  }
+  g_free (checksumsink->stream_digest);
+  checksumsink->stream_digest = gst_checksum_sink_hasher_finish (&hasher);
+  GST_OBJECT_UNLOCK (checksumsink);
+}
+
+static GstFlowReturn
+gst_checksum_sink_render_planes (GstChecksumSink * checksumsink,
+    GstBuffer * buffer)
+{
+  GstChecksumSinkPlane planes[GST_VIDEO_MAX_PLANES];
+  GstChecksumSinkHasher hasher;
+  GstVideoFrame frame;
+  GString *line;
+  gchar *s;
+  guint i, n_planes;
+
+  if (!gst_video_frame_map (&frame, &checksumsink->info, buffer,
+          GST_MAP_READ)) {
+    GST_ELEMENT_ERROR (checksumsink, STREAM, FAILED, (NULL),
+        ("Failed to map video frame"));
+    return GST_FLOW_ERROR;
+  }
+
+  n_planes = GST_VIDEO_FRAME_N_PLANES (&frame);
+  for (i = 0; i < n_planes; i++) {
+    const GstVideoFormatInfo *finfo = frame.info.finfo;
+    gint comp, pstride;
+
+    /* size the rows from the first component stored in this plane */
+    for (comp = 0; comp < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo) - 1;
+        comp++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp) == i)
+        break;
+    }
+    pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, comp);
+
+    planes[i].checksumsink = checksumsink;
+    planes[i].data = GST_VIDEO_FRAME_PLANE_DATA (&frame, i);
+    planes[i].stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i);
+    planes[i].digest = NULL;
+    if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp) != i) {
+      /* no component lives here (palette), hash the rest of the frame */
+      planes[i].row_size = GST_VIDEO_INFO_SIZE (&frame.info) -
+          GST_VIDEO_INFO_PLANE_OFFSET (&frame.info, i);
+      planes[i].stride = planes[i].row_size;
+      planes[i].height = 1;
+      continue;
+    }
+    planes[i].height = GST_VIDEO_FRAME_COMP_HEIGHT (&frame, comp);
+    if (pstride > 0)
+      planes[i].row_size = GST_VIDEO_FRAME_COMP_WIDTH (&frame, comp) * pstride;
+    else
+      planes[i].row_size = planes[i].stride;
+    planes[i].row_size = MIN (planes[i].row_size, (gsize) planes[i].stride);
+  }
+
+  if (n_planes > 1) {
+    if (!checksumsink->pool) {
+      checksumsink->pool = g_thread_pool_new (gst_checksum_sink_plane_func,
+          NULL, GST_VIDEO_MAX_PLANES, FALSE, NULL);
+    }
+
+    /* every plane goes to a worker, we only wait for them */
+    g_mutex_lock (&checksumsink->lock);
+    checksumsink->pending = n_planes;
+    for (i = 0; i < n_planes; i++)
+      g_thread_pool_push (checksumsink->pool, &planes[i], NULL);
+    while (checksumsink->pending > 0)
+      g_cond_wait (&checksumsink->cond, &checksumsink->lock);
+    g_mutex_unlock (&checksumsink->lock);
+  } else {
+    gst_checksum_sink_hash_plane (checksumsink, &planes[0]);
+  }
+
+  gst_video_frame_unmap (&frame);
+
+  /* the frame digest covers the plane digests in plane order */
+  gst_checksum_sink_hasher_init (&hasher, checksumsink->hash);
+  line = g_string_new (NULL);
+  for (i = 0; i < n_planes; i++) {
+    gst_checksum_sink_hasher_update (&hasher, (const guint8 *) planes[i].digest,
+        strlen (planes[i].digest));
+    g_string_append_printf (line, " %s", planes[i].digest);
+    g_free (planes[i].digest);
+  }
+  s = gst_checksum_sink_hasher_finish (&hasher);
+
+  g_print ("%" GST_TIME_FORMAT " %s%s\n",
+      GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)), s, line->str);
+
+  gst_checksum_sink_update_stream (checksumsink, s);
+  g_string_free (line, TRUE);
+  g_free (s);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_checksum_sink_render (GstBaseSink * sink, GstBuffer * buffer)
 {
+  GstChecksumSink *checksumsink = GST_CHECKSUM_SINK (sink);
+  GstChecksumSinkHasher hasher;
   gchar *s;
   GstMapInfo map;
 
+  if (checksumsink->per_plane && checksumsink->is_video)
+    return gst_checksum_sink_render_planes (checksumsink, buffer);
+
   gst_buffer_map (buffer, &map, GST_MAP_READ);
-  s = g_compute_checksum_for_data (G_CHECKSUM_SHA1, map.data, map.size);
+  gst_checksum_sink_hasher_init (&hasher, checksumsink->hash);
+  gst_checksum_sink_hasher_update (&hasher, map.data, map.size);
+  s = gst_checksum_sink_hasher_finish (&hasher);
   gst_buffer_unmap (buffer, &map);
   g_print ("%" GST_TIME_FORMAT " %s\n",
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)), s);
 
+  gst_checksum_sink_update_stream (checksumsink, s);
   g_free (s);
 
   return GST_FLOW_OK;
@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/video/video.h>
 
 G_BEGIN_DECLS
 
@@ -31,6 +32,23 @@ G_BEGIN_DECLS
 #define GST_IS_CHECKSUM_SINK(obj)   (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_CHECKSUM_SINK))
 #define GST_IS_CHECKSUM_SINK_CLASS(obj)   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_CHECKSUM_SINK))
 
+typedef enum
+{
+  GST_CHECKSUM_SINK_HASH_SHA1,
+  GST_CHECKSUM_SINK_HASH_MD5,
+  GST_CHECKSUM_SINK_HASH_SHA256,
+  GST_CHECKSUM_SINK_HASH_XXH64
+} GstChecksumSinkHash;
+
+/* streaming xxHash64 state */
+typedef struct
+{
+  guint64 total_len;
+  guint64 v[4];
+  guint8 mem[32];               /* input not yet consumed by a stripe */
+  guint mem_size;
+} GstChecksumSinkXxh64;
+
 typedef struct _GstChecksumSink GstChecksumSink;
 typedef struct _GstChecksumSinkClass GstChecksumSinkClass;
 
@@ -38,6 +56,22 @@ struct _GstChecksumSink
 {
   GstBaseSink base_checksumsink;
 
+  GstChecksumSinkHash hash;
+  gboolean per_plane;
+
+  GstVideoInfo info;
+  gboolean is_video;
+
+  /* per-plane workers, the streaming thread waits for all planes */
+  GThreadPool *pool;
+  GMutex lock;
+  GCond cond;
+  gint pending;
+
+  /* running digest over all frame digests, protected by the object lock */
+  GChecksum *stream_checksum;
+  GstChecksumSinkXxh64 stream_xxh;
+  gchar *stream_digest;
 };
 
 struct _GstChecksumSinkClass
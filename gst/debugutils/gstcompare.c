@@ -24,6 +24,7 @@
 #include "config.h"
 #endif
 #include <string.h>
+#include <math.h>
 
 #include <gst/gst.h>
 #include <gst/base/gstcollectpads.h>
@@ -55,7 +56,9 @@ enum GstCompareMethod
 {
   GST_COMPARE_METHOD_MEM,
   GST_COMPARE_METHOD_MAX,
-  GST_COMPARE_METHOD_SSIM
+  GST_COMPARE_METHOD_SSIM,
+  GST_COMPARE_METHOD_MSE,
+  GST_COMPARE_METHOD_PSNR
 };
 
 #define GST_COMPARE_METHOD_TYPE (gst_compare_method_get_type())
@@ -68,6 +71,8 @@ gst_compare_method_get_type (void)
     {GST_COMPARE_METHOD_MEM, "Memory", "mem"},
     {GST_COMPARE_METHOD_MAX, "Maximum metric", "max"},
     {GST_COMPARE_METHOD_SSIM, "SSIM (raw video)", "ssim"},
+    {GST_COMPARE_METHOD_MSE, "Mean squared error (raw video)", "mse"},
+    {GST_COMPARE_METHOD_PSNR, "PSNR in dB (raw video)", "psnr"},
     {0, NULL, NULL}
   };
 
@@ -101,6 +106,9 @@ enum
 #define DEFAULT_THRESHOLD        0
 #define DEFAULT_UPPER            TRUE
 
+/* reported for identical frames instead of an infinite PSNR */
+#define PSNR_IDENTICAL           100.0
+
 static void gst_compare_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_compare_get_property (GObject * object,
@@ -419,7 +427,7 @@ gst_compare_ssim_component (GstCompare * comp, guint8 * data1, guint8 * data2,
 
 static gdouble
 gst_compare_ssim (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
-    GstBuffer * buf2, GstCaps * caps2)
+    GstBuffer * buf2, GstCaps * caps2, gdouble * planes, gint * n_planes)
 {
   GstVideoInfo info1, info2;
   GstVideoFrame frame1, frame2;
@@ -435,7 +443,7 @@ gst_compare_ssim (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
   if (!caps2)
     goto invalid_input;
 
-  if (!gst_video_info_from_caps (&info2, caps1))
+  if (!gst_video_info_from_caps (&info2, caps2))
     goto invalid_input;
 
   if (GST_VIDEO_INFO_FORMAT (&info1) != GST_VIDEO_INFO_FORMAT (&info2) ||
@@ -457,6 +465,9 @@ gst_compare_ssim (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
   gst_video_frame_map (&frame1, &info1, buf1, GST_MAP_READ);
   gst_video_frame_map (&frame2, &info2, buf2, GST_MAP_READ);
 
+  for (i = 0; i < 4; i++)
+    cssim[i] = 0.0;
+
   for (i = 0; i < comps; i++) {
     gint cw, ch, step, stride;
 
@@ -486,6 +497,10 @@ gst_compare_ssim (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
 
   ssim = cssim[0] * c[0] + cssim[1] * c[1] + cssim[2] * c[2] + cssim[3] * c[3];
 
+  for (i = 0; i < comps; i++)
+    planes[i] = cssim[i];
+  *n_planes = comps;
+
   return ssim;
 
   /* ERRORS */
@@ -502,23 +517,194 @@ unsupported_input:
   }
 }
 
+/* sum of squared differences of @n bytes; the 32 bit accumulator lets the
+ * compiler vectorise the loop and cannot overflow for 65536 bytes */
+static guint64
+gst_compare_sse_u8 (const guint8 * data1, const guint8 * data2, gsize n)
+{
+  guint64 sse = 0;
+
+  while (n > 0) {
+    gsize i, len = MIN (n, 65536);
+    guint32 acc = 0;
+
+    for (i = 0; i < len; i++) {
+      gint d = data1[i] - data2[i];
+      acc += d * d;
+    }
+    sse += acc;
+    data1 += len;
+    data2 += len;
+    n -= len;
+  }
+
+  return sse;
+}
+
+static guint64
+gst_compare_sse_u16 (const guint8 * data1, const guint8 * data2, gsize n,
+    gboolean le)
+{
+  guint64 sse = 0;
+  gsize i;
+
+  for (i = 0; i < n; i++) {
+    gint64 d;
+
+    if (le)
+      d = (gint64) GST_READ_UINT16_LE (data1) - GST_READ_UINT16_LE (data2);
+    else
+      d = (gint64) GST_READ_UINT16_BE (data1) - GST_READ_UINT16_BE (data2);
+    sse += d * d;
+    data1 += 2;
+    data2 += 2;
+  }
+
+  return sse;
+}
+
+/* Mean squared error per plane, over the visible part of each row.  Samples
+ * are bytes, or 16 bit words for formats deeper than 8 bits; identical rows
+ * are skipped after a memcmp.  Returns the MSE over all planes, normalised
+ * to 8 bit range, and the peak sample value of each plane in @peaks. */
+static gdouble
+gst_compare_mse (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
+    GstBuffer * buf2, GstCaps * caps2, gdouble * planes, gint * n_planes,
+    gdouble * peaks)
+{
+  GstVideoInfo info1, info2;
+  GstVideoFrame frame1, frame2;
+  const GstVideoFormatInfo *finfo;
+  gdouble total_sse = 0, total_samples = 0;
+  guint i;
+
+  if (!caps1 || !gst_video_info_from_caps (&info1, caps1))
+    goto invalid_input;
+  if (!caps2 || !gst_video_info_from_caps (&info2, caps2))
+    goto invalid_input;
+
+  *n_planes = 0;
+
+  if (GST_VIDEO_INFO_FORMAT (&info1) != GST_VIDEO_INFO_FORMAT (&info2) ||
+      GST_VIDEO_INFO_WIDTH (&info1) != GST_VIDEO_INFO_WIDTH (&info2) ||
+      GST_VIDEO_INFO_HEIGHT (&info1) != GST_VIDEO_INFO_HEIGHT (&info2))
+    return -1;
+
+  if (!gst_video_frame_map (&frame1, &info1, buf1, GST_MAP_READ))
+    goto invalid_input;
+  if (!gst_video_frame_map (&frame2, &info2, buf2, GST_MAP_READ)) {
+    gst_video_frame_unmap (&frame1);
+    goto invalid_input;
+  }
+
+  finfo = info1.finfo;
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&frame1); i++) {
+    const guint8 *data1, *data2;
+    gint comp_idx, pstride, depth, stride1, stride2, height, j;
+    gsize row_size, samples;
+    gboolean wide;
+    gdouble max;
+    guint64 sse = 0;
+
+    /* size the rows from the first component stored in this plane */
+    for (comp_idx = 0;
+        comp_idx < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo) - 1;
+        comp_idx++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp_idx) == i)
+        break;
+    }
+    /* skip planes without components such as palettes */
+    if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp_idx) != i)
+      continue;
+
+    pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&frame1, comp_idx);
+    depth = GST_VIDEO_FORMAT_INFO_DEPTH (finfo, comp_idx);
+    stride1 = GST_VIDEO_FRAME_PLANE_STRIDE (&frame1, i);
+    stride2 = GST_VIDEO_FRAME_PLANE_STRIDE (&frame2, i);
+    height = GST_VIDEO_FRAME_COMP_HEIGHT (&frame1, comp_idx);
+    if (pstride > 0)
+      row_size = GST_VIDEO_FRAME_COMP_WIDTH (&frame1, comp_idx) * pstride;
+    else
+      row_size = stride1;
+    row_size = MIN (row_size, (gsize) MIN (stride1, stride2));
+
+    /* 16 bit containers are compared as words, everything else (including
+     * bit packed formats) bytewise */
+    wide = depth > 8 && pstride > 0 && (pstride % 2) == 0;
+    samples = wide ? row_size / 2 : row_size;
+
+    data1 = GST_VIDEO_FRAME_PLANE_DATA (&frame1, i);
+    data2 = GST_VIDEO_FRAME_PLANE_DATA (&frame2, i);
+    for (j = 0; j < height; j++) {
+      if (memcmp (data1, data2, row_size) != 0) {
+        if (wide)
+          sse += gst_compare_sse_u16 (data1, data2, samples,
+              GST_VIDEO_FORMAT_INFO_IS_LE (finfo));
+        else
+          sse += gst_compare_sse_u8 (data1, data2, samples);
+      }
+      data1 += stride1;
+      data2 += stride2;
+    }
+
+    /* the peak of this plane's component, bytewise compared samples
+     * always span the full byte */
+    max = (gdouble) ((1 << (wide ? depth : 8)) - 1);
+    /* normalise to 8 bit range so planes of mixed depth can be summed */
+    total_sse += sse * (255.0 * 255.0) / (max * max);
+    total_samples += (gdouble) samples * height;
+
+    planes[*n_planes] = samples * height > 0 ?
+        (gdouble) sse / ((gdouble) samples * height) : 0.0;
+    peaks[*n_planes] = max;
+    GST_LOG_OBJECT (comp, "mse[%d] = %f", *n_planes, planes[*n_planes]);
+    (*n_planes)++;
+  }
+
+  gst_video_frame_unmap (&frame1);
+  gst_video_frame_unmap (&frame2);
+
+  return total_samples > 0 ? total_sse / total_samples : 0.0;
+
+  /* ERRORS */
+invalid_input:
+  {
+    GST_ERROR_OBJECT (comp, "mse and psnr methods need raw video input");
+    *n_planes = 0;
+    return 0;
+  }
+}
+
+static gdouble
+gst_compare_psnr_from_mse (gdouble mse, gdouble peak)
+{
+  if (mse <= 0.0)
+    return PSNR_IDENTICAL;
+
+  return MIN (10.0 * log10 (peak * peak / mse), PSNR_IDENTICAL);
+}
+
 static void
 gst_compare_buffers (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
     GstBuffer * buf2, GstCaps * caps2)
 {
   gdouble delta = 0;
+  gdouble planes[GST_VIDEO_MAX_PLANES], peaks[GST_VIDEO_MAX_PLANES];
+  gint i, n_planes = 0;
+  gboolean identical, mismatch = FALSE;
   gsize size1, size2;
 
   /* first check metadata */
   gst_compare_meta (comp, buf1, caps1, buf2, caps2);
 
   size1 = gst_buffer_get_size (buf1);
-  size2 = gst_buffer_get_size (buf1);
+  size2 = gst_buffer_get_size (buf2);
 
   /* check content according to method */
   /* but at least size should match */
   if (size1 != size2) {
     delta = comp->threshold + 1;
+    mismatch = TRUE;
   } else {
     GstMapInfo map1, map2;
 
@@ -526,33 +712,82 @@ gst_compare_buffers (GstCompare * comp, GstBuffer * buf1, GstCaps * caps1,
     gst_buffer_map (buf2, &map2, GST_MAP_READ);
     GST_MEMDUMP_OBJECT (comp, "buffer 1", map1.data, map2.size);
     GST_MEMDUMP_OBJECT (comp, "buffer 2", map2.data, map2.size);
+    /* identical content needs no metric, and is the common case */
+    identical = map1.data == map2.data ||
+        memcmp (map1.data, map2.data, map1.size) == 0;
     gst_buffer_unmap (buf1, &map1);
     gst_buffer_unmap (buf2, &map2);
-    switch (comp->method) {
-      case GST_COMPARE_METHOD_MEM:
-        delta = gst_compare_mem (comp, buf1, caps1, buf2, caps2);
-        break;
-      case GST_COMPARE_METHOD_MAX:
-        delta = gst_compare_max (comp, buf1, caps1, buf2, caps2);
-        break;
-      case GST_COMPARE_METHOD_SSIM:
-        delta = gst_compare_ssim (comp, buf1, caps1, buf2, caps2);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
+
+    if (identical) {
+      GST_LOG_OBJECT (comp, "buffers are identical");
+      switch (comp->method) {
+        case GST_COMPARE_METHOD_SSIM:
+          delta = 1.0;
+          break;
+        case GST_COMPARE_METHOD_PSNR:
+          delta = PSNR_IDENTICAL;
+          break;
+        default:
+          delta = 0;
+          break;
+      }
+    } else {
+      switch (comp->method) {
+        case GST_COMPARE_METHOD_MEM:
+          delta = gst_compare_mem (comp, buf1, caps1, buf2, caps2);
+          break;
+        case GST_COMPARE_METHOD_MAX:
+          delta = gst_compare_max (comp, buf1, caps1, buf2, caps2);
+          break;
+        case GST_COMPARE_METHOD_SSIM:
+          delta = gst_compare_ssim (comp, buf1, caps1, buf2, caps2, planes,
+              &n_planes);
+          break;
+        case GST_COMPARE_METHOD_MSE:
+          delta = gst_compare_mse (comp, buf1, caps1, buf2, caps2, planes,
+              &n_planes, peaks);
+          if (delta < 0) {
+            delta = comp->threshold + 1;
+            mismatch = TRUE;
+          }
+          break;
+        case GST_COMPARE_METHOD_PSNR:
+          delta = gst_compare_mse (comp, buf1, caps1, buf2, caps2, planes,
+              &n_planes, peaks);
+          if (delta < 0) {
+            delta = 0;
+            mismatch = TRUE;
+          } else {
+            delta = gst_compare_psnr_from_mse (delta, 255.0);
+            for (i = 0; i < n_planes; i++)
+              planes[i] = gst_compare_psnr_from_mse (planes[i], peaks[i]);
+          }
+          break;
+        default:
+          g_assert_not_reached ();
+          break;
+      }
     }
   }
 
-  if ((comp->upper && delta > comp->threshold) ||
+  /* buffers of different size or format never match, whichever way the
+   * threshold bounds the delta */
+  if (mismatch || (comp->upper && delta > comp->threshold) ||
       (!comp->upper && delta < comp->threshold)) {
+    GstStructure *s;
+
     GST_WARNING_OBJECT (comp, "buffers %p and %p failed content match %f",
         buf1, buf2, delta);
 
+    s = gst_structure_new ("delta", "content", G_TYPE_DOUBLE, delta, NULL);
+    for (i = 0; i < n_planes; i++) {
+      gchar *name = g_strdup_printf ("plane-%d", i);
+
+      gst_structure_set (s, name, G_TYPE_DOUBLE, planes[i], NULL);
+      g_free (name);
+    }
     gst_element_post_message (GST_ELEMENT (comp),
-        gst_message_new_element (GST_OBJECT (comp),
-            gst_structure_new ("delta", "content", G_TYPE_DOUBLE, delta,
-                NULL)));
+        gst_message_new_element (GST_OBJECT (comp), s));
   }
 }
 
@@ -34,6 +34,18 @@
  * not aware of expected pauses in buffer flow, such as the PAUSED
  * state.
  *
+ * With the instrument property set, the element also keeps statistics
+ * of the buffers passing through it, available from the stats property:
+ * the gap between consecutive buffers and the latency of each buffer,
+ * that is how far the pipeline clock is past the running time of its
+ * timestamp.  It also puts a probe on every pad of the pipeline that
+ * records when the pad last saw a buffer.  Before the error, a stall then
+ * posts a "watchdog-stall" element message that lists for every pad the
+ * number of buffers, the time since the last one, the last timestamp and
+ * whether the pad stalled, so the branch that stopped can be found.  Pads
+ * that never saw a buffer have an idle time of GST_CLOCK_TIME_NONE and are
+ * not reported as stalled.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -50,6 +62,18 @@
 #include <gst/base/gstbasetransform.h>
 #include "gstwatchdog.h"
 
+#define DEFAULT_INSTRUMENT FALSE
+
+/* the last buffer seen on one pad of the pipeline, updated by a pad probe */
+typedef struct
+{
+  GstPad *pad;
+  gulong probe_id;
+  volatile gint buffers;
+  volatile gint last_seen;      /* gst_watchdog_now_ms() */
+  volatile gint last_pts;       /* milliseconds, -1 if unknown */
+} GstWatchdogPadStats;
+
 GST_DEBUG_CATEGORY_STATIC (gst_watchdog_debug_category);
 #define GST_CAT_DEFAULT gst_watchdog_debug_category
 
@@ -72,7 +96,9 @@ static GstFlowReturn gst_watchdog_transform_ip (GstBaseTransform * trans,
 enum
 {
   PROP_0,
-  PROP_TIMEOUT
+  PROP_TIMEOUT,
+  PROP_INSTRUMENT,
+  PROP_STATS
 };
 
 /* class initialization */
@@ -114,12 +140,45 @@ gst_watchdog_class_init (GstWatchdogClass * klass)
           "which an element error is sent to the bus if no buffers are "
           "received.", 1, G_MAXINT, 1000,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_INSTRUMENT,
+      g_param_spec_boolean ("instrument", "Instrument", "Record buffer gaps "
+          "and latency, and the last buffer seen on every pad of the "
+          "pipeline for a stall message", DEFAULT_INSTRUMENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics", "Buffer count, last and "
+          "maximum gap between buffers and last and maximum latency (in ns) "
+          "when instrumenting", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
 }
 
 static void
 gst_watchdog_init (GstWatchdog * watchdog)
 {
+  watchdog->instrument = DEFAULT_INSTRUMENT;
+}
+
+/* monotonic time in ms; only differences are used, so wrapping is fine */
+static inline gint
+gst_watchdog_now_ms (void)
+{
+  return (gint) (guint32) (g_get_monotonic_time () / 1000);
+}
+
+static GstStructure *
+gst_watchdog_collect_stats (GstWatchdog * watchdog, const gchar * name)
+{
+  return gst_structure_new (name,
+      "buffers", G_TYPE_UINT, (guint) g_atomic_int_get (&watchdog->buffers),
+      "gap-last", G_TYPE_UINT64,
+      (guint64) g_atomic_int_get (&watchdog->gap_last) * GST_USECOND,
+      "gap-max", G_TYPE_UINT64,
+      (guint64) g_atomic_int_get (&watchdog->gap_max) * GST_USECOND,
+      "latency-last", G_TYPE_INT64,
+      (gint64) g_atomic_int_get (&watchdog->latency_last) * GST_USECOND,
+      "latency-max", G_TYPE_INT64,
+      (gint64) g_atomic_int_get (&watchdog->latency_max) * GST_USECOND, NULL);
 }
 
 void
@@ -134,6 +193,9 @@ gst_watchdog_set_property (GObject * object, guint property_id,
     case PROP_TIMEOUT:
       watchdog->timeout = g_value_get_int (value);
       break;
+    case PROP_INSTRUMENT:
+      watchdog->instrument = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -152,6 +214,13 @@ gst_watchdog_get_property (GObject * object, guint property_id,
     case PROP_TIMEOUT:
       g_value_set_int (value, watchdog->timeout);
       break;
+    case PROP_INSTRUMENT:
+      g_value_set_boolean (value, watchdog->instrument);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_watchdog_collect_stats (watchdog,
+              "watchdog-stats"));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -172,6 +241,209 @@ gst_watchdog_thread (gpointer user_data)
   return NULL;
 }
 
+static GstPadProbeReturn
+gst_watchdog_pad_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GstWatchdogPadStats *stats = user_data;
+  GstBuffer *buf = NULL;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER)
+    buf = GST_PAD_PROBE_INFO_BUFFER (info);
+  else if (gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info)) > 0)
+    buf = gst_buffer_list_get (GST_PAD_PROBE_INFO_BUFFER_LIST (info), 0);
+
+  g_atomic_int_inc (&stats->buffers);
+  g_atomic_int_set (&stats->last_seen, gst_watchdog_now_ms ());
+  if (buf && GST_BUFFER_PTS_IS_VALID (buf))
+    g_atomic_int_set (&stats->last_pts,
+        MIN (GST_BUFFER_PTS (buf) / GST_MSECOND, G_MAXINT));
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+gst_watchdog_pad_stats_free (gpointer data)
+{
+  g_slice_free (GstWatchdogPadStats, data);
+}
+
+static void
+gst_watchdog_add_pad (const GValue * item, gpointer user_data)
+{
+  GstWatchdog *watchdog = GST_WATCHDOG (user_data);
+  GstPad *pad = g_value_get_object (item);
+  GstWatchdogPadStats *stats;
+
+  if (g_hash_table_lookup (watchdog->pad_stats, pad))
+    return;
+
+  GST_LOG_OBJECT (watchdog, "watching pad %s:%s", GST_DEBUG_PAD_NAME (pad));
+
+  stats = g_slice_new0 (GstWatchdogPadStats);
+  stats->pad = pad;
+  stats->last_pts = -1;
+  stats->probe_id = gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      gst_watchdog_pad_probe, stats, gst_watchdog_pad_stats_free);
+  g_hash_table_insert (watchdog->pad_stats, gst_object_ref (pad), stats);
+}
+
+static void
+gst_watchdog_scan_element (GstWatchdog * watchdog, GstElement * element)
+{
+  GstIterator *it;
+
+  it = gst_element_iterate_pads (element);
+  while (gst_iterator_foreach (it, gst_watchdog_add_pad,
+          watchdog) == GST_ITERATOR_RESYNC)
+    gst_iterator_resync (it);
+  gst_iterator_free (it);
+}
+
+static void
+gst_watchdog_add_element (const GValue * item, gpointer user_data)
+{
+  gst_watchdog_scan_element (GST_WATCHDOG (user_data),
+      g_value_get_object (item));
+}
+
+/* forget pads that were removed from their element since the last scan */
+static void
+gst_watchdog_remove_orphans (GstWatchdog * watchdog)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GstObject *parent;
+
+  g_hash_table_iter_init (&iter, watchdog->pad_stats);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    parent = gst_object_get_parent (GST_OBJECT (key));
+    if (parent) {
+      gst_object_unref (parent);
+      continue;
+    }
+
+    GST_LOG_OBJECT (watchdog, "pad %" GST_PTR_FORMAT " was removed", key);
+    /* this frees the stats, removing the entry drops our pad ref */
+    gst_pad_remove_probe (GST_PAD (key),
+        ((GstWatchdogPadStats *) value)->probe_id);
+    g_hash_table_iter_remove (&iter);
+  }
+}
+
+/* put a probe on all pads of the pipeline we're in that don't have one
+ * yet; pads are added and removed at any time, so this is repeated now
+ * and then */
+static void
+gst_watchdog_scan_pads (GstWatchdog * watchdog)
+{
+  GstObject *top, *parent;
+  GstIterator *it;
+
+  gst_watchdog_remove_orphans (watchdog);
+
+  top = gst_object_ref (watchdog);
+  while ((parent = gst_object_get_parent (top))) {
+    gst_object_unref (top);
+    top = parent;
+  }
+
+  if (GST_IS_BIN (top)) {
+    it = gst_bin_iterate_recurse (GST_BIN (top));
+    while (gst_iterator_foreach (it, gst_watchdog_add_element,
+            watchdog) == GST_ITERATOR_RESYNC)
+      gst_iterator_resync (it);
+    gst_iterator_free (it);
+  } else {
+    gst_watchdog_scan_element (watchdog, GST_ELEMENT (top));
+  }
+  gst_object_unref (top);
+}
+
+static gboolean
+gst_watchdog_scan (gpointer ptr)
+{
+  gst_watchdog_scan_pads (GST_WATCHDOG (ptr));
+
+  return TRUE;
+}
+
+static void
+gst_watchdog_remove_probes (GstWatchdog * watchdog)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_hash_table_iter_init (&iter, watchdog->pad_stats);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    /* this frees the stats */
+    gst_pad_remove_probe (GST_PAD (key),
+        ((GstWatchdogPadStats *) value)->probe_id);
+  }
+  g_hash_table_destroy (watchdog->pad_stats);
+  watchdog->pad_stats = NULL;
+}
+
+/* post the last buffer seen on every pad so the stalled branch of the
+ * pipeline can be told apart from the ones that still run */
+static void
+gst_watchdog_post_stall (GstWatchdog * watchdog)
+{
+  GstStructure *s;
+  GHashTableIter iter;
+  gpointer value;
+  GValue pads = { 0 };
+  GValue v = { 0 };
+  gint now = gst_watchdog_now_ms ();
+
+  gst_watchdog_scan_pads (watchdog);
+
+  g_value_init (&pads, GST_TYPE_ARRAY);
+  g_hash_table_iter_init (&iter, watchdog->pad_stats);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstWatchdogPadStats *stats = value;
+    gint buffers = g_atomic_int_get (&stats->buffers);
+    gint last_pts = g_atomic_int_get (&stats->last_pts);
+    GstClockTime idle = GST_CLOCK_TIME_NONE;
+    gboolean stalled;
+    gchar *name;
+
+    /* a pad that never carried a buffer has no known idle time; it may
+     * just not be used, so it doesn't count as stalled */
+    if (buffers > 0) {
+      idle = ((guint32) now -
+          (guint32) g_atomic_int_get (&stats->last_seen)) * GST_MSECOND;
+    }
+    stalled = GST_CLOCK_TIME_IS_VALID (idle) &&
+        idle >= watchdog->timeout * GST_MSECOND;
+    name = gst_object_get_path_string (GST_OBJECT (stats->pad));
+
+    if (stalled)
+      GST_INFO_OBJECT (watchdog, "pad %s stalled, %d buffers, idle for %"
+          GST_TIME_FORMAT, name, buffers, GST_TIME_ARGS (idle));
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, gst_structure_new ("watchdog-pad",
+            "pad", G_TYPE_STRING, name,
+            "buffers", G_TYPE_UINT, (guint) buffers,
+            "idle", G_TYPE_UINT64, idle,
+            "last-pts", G_TYPE_UINT64,
+            last_pts < 0 ? GST_CLOCK_TIME_NONE : last_pts * GST_MSECOND,
+            "stalled", G_TYPE_BOOLEAN, stalled, NULL));
+    gst_value_array_append_value (&pads, &v);
+    g_value_unset (&v);
+    g_free (name);
+  }
+
+  s = gst_watchdog_collect_stats (watchdog, "watchdog-stall");
+  gst_structure_set (s, "timeout", G_TYPE_INT, watchdog->timeout, NULL);
+  gst_structure_take_value (s, "pads", &pads);
+
+  gst_element_post_message (GST_ELEMENT_CAST (watchdog),
+      gst_message_new_element (GST_OBJECT_CAST (watchdog), s));
+}
+
 static gboolean
 gst_watchdog_trigger (gpointer ptr)
 {
@@ -179,6 +451,9 @@ gst_watchdog_trigger (gpointer ptr)
 
   GST_DEBUG_OBJECT (watchdog, "watchdog triggered");
 
+  if (watchdog->pad_stats)
+    gst_watchdog_post_stall (watchdog);
+
   GST_ELEMENT_ERROR (watchdog, STREAM, FAILED, ("Watchdog triggered"),
       ("Watchdog triggered"));
 
@@ -218,8 +493,27 @@ gst_watchdog_start (GstBaseTransform * trans)
 
   GST_DEBUG_OBJECT (watchdog, "start");
 
+  watchdog->last_buffer_time = -1;
+  g_atomic_int_set (&watchdog->buffers, 0);
+  g_atomic_int_set (&watchdog->gap_last, 0);
+  g_atomic_int_set (&watchdog->gap_max, 0);
+  g_atomic_int_set (&watchdog->latency_last, 0);
+  g_atomic_int_set (&watchdog->latency_max, 0);
+
   watchdog->main_context = g_main_context_new ();
   watchdog->main_loop = g_main_loop_new (watchdog->main_context, TRUE);
+
+  if (watchdog->instrument) {
+    watchdog->pad_stats = g_hash_table_new_full (NULL, NULL,
+        gst_object_unref, NULL);
+    gst_watchdog_scan_pads (watchdog);
+
+    watchdog->scan_source = g_timeout_source_new (watchdog->timeout);
+    g_source_set_callback (watchdog->scan_source, gst_watchdog_scan, watchdog,
+        NULL);
+    g_source_attach (watchdog->scan_source, watchdog->main_context);
+  }
+
   watchdog->thread = g_thread_new ("watchdog", gst_watchdog_thread, watchdog);
 
   return TRUE;
@@ -238,6 +532,11 @@ gst_watchdog_stop (GstBaseTransform * trans)
     g_source_unref (watchdog->source);
     watchdog->source = NULL;
   }
+  if (watchdog->scan_source) {
+    g_source_destroy (watchdog->scan_source);
+    g_source_unref (watchdog->scan_source);
+    watchdog->scan_source = NULL;
+  }
 
   /* dispatch an idle event that trigger g_main_loop_quit to avoid race
    * between g_main_loop_run and g_main_loop_quit */
@@ -251,6 +550,9 @@ gst_watchdog_stop (GstBaseTransform * trans)
   g_main_loop_unref (watchdog->main_loop);
   g_main_context_unref (watchdog->main_context);
 
+  if (watchdog->pad_stats)
+    gst_watchdog_remove_probes (watchdog);
+
   return TRUE;
 }
 
@@ -281,6 +583,55 @@ gst_watchdog_src_event (GstBaseTransform * trans, GstEvent * event)
       event);
 }
 
+/* gap since the previous buffer and how far the clock is past the running
+ * time of this one */
+static void
+gst_watchdog_record_buffer (GstWatchdog * watchdog, GstBuffer * buf)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (watchdog);
+  GstClock *clock;
+  GstClockTime base_time, running_time;
+  GstClockTimeDiff latency;
+  gint64 now = g_get_monotonic_time ();
+  gint gap;
+
+  g_atomic_int_inc (&watchdog->buffers);
+  if (watchdog->last_buffer_time != -1) {
+    gap = CLAMP (now - watchdog->last_buffer_time, 0, G_MAXINT);
+    g_atomic_int_set (&watchdog->gap_last, gap);
+    if (gap > g_atomic_int_get (&watchdog->gap_max))
+      g_atomic_int_set (&watchdog->gap_max, gap);
+  }
+  watchdog->last_buffer_time = now;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buf) ||
+      trans->segment.format != GST_FORMAT_TIME)
+    return;
+  running_time = gst_segment_to_running_time (&trans->segment,
+      GST_FORMAT_TIME, GST_BUFFER_PTS (buf));
+  if (!GST_CLOCK_TIME_IS_VALID (running_time))
+    return;
+
+  GST_OBJECT_LOCK (watchdog);
+  clock = GST_ELEMENT_CLOCK (watchdog);
+  if (clock == NULL) {
+    GST_OBJECT_UNLOCK (watchdog);
+    return;
+  }
+  gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (watchdog)->base_time;
+  GST_OBJECT_UNLOCK (watchdog);
+
+  latency = GST_CLOCK_DIFF (running_time,
+      gst_clock_get_time (clock) - base_time) / GST_USECOND;
+  gst_object_unref (clock);
+
+  latency = CLAMP (latency, G_MININT, G_MAXINT);
+  g_atomic_int_set (&watchdog->latency_last, latency);
+  if (latency > g_atomic_int_get (&watchdog->latency_max))
+    g_atomic_int_set (&watchdog->latency_max, latency);
+}
+
 static GstFlowReturn
 gst_watchdog_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 {
@@ -288,6 +639,9 @@ gst_watchdog_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 
   GST_DEBUG_OBJECT (watchdog, "transform_ip");
 
+  if (watchdog->instrument)
+    gst_watchdog_record_buffer (watchdog, buf);
+
   gst_watchdog_feed (watchdog);
 
   return GST_FLOW_OK;
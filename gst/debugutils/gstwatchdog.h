@@ -40,11 +40,25 @@ struct _GstWatchdog
 
   /* properties */
   int timeout;
+  gboolean instrument;
 
   GMainContext *main_context;
   GMainLoop *main_loop;
   GThread *thread;
   GSource *source;
+
+  /* instrumentation, only written from the streaming thread */
+  gint64 last_buffer_time;
+  volatile gint buffers;
+  volatile gint gap_last;       /* microseconds */
+  volatile gint gap_max;
+  volatile gint latency_last;   /* microseconds */
+  volatile gint latency_max;
+
+  /* GstPad -> per pad stats of all pads in the pipeline, only used from
+   * the watchdog thread once it runs */
+  GHashTable *pad_stats;
+  GSource *scan_source;
 };
 
 struct _GstWatchdogClass
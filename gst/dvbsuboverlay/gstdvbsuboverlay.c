@@ -118,6 +118,8 @@ static gboolean gst_dvbsub_overlay_event_src (GstPad * pad, GstObject * parent,
 
 static void new_dvb_subtitles_cb (DvbSub * dvb_sub, DVBSubtitles * subs,
     gpointer user_data);
+static GstVideoOverlayComposition *gst_dvbsub_overlay_subs_to_comp
+    (GstDVBSubOverlay * overlay, DVBSubtitles * subs);
 
 static gboolean gst_dvbsub_overlay_query_video (GstPad * pad,
     GstObject * parent, GstQuery * query);
@@ -513,7 +515,22 @@ gst_dvbsub_overlay_setcaps_video (GstPad * pad, GstCaps * caps)
   if (!gst_video_info_from_caps (&info, caps))
     goto invalid_caps;
 
-  render->info = info;
+  g_mutex_lock (&render->dvbsub_mutex);
+  if (GST_VIDEO_INFO_WIDTH (&info) != GST_VIDEO_INFO_WIDTH (&render->info)
+      || GST_VIDEO_INFO_HEIGHT (&info) !=
+      GST_VIDEO_INFO_HEIGHT (&render->info)) {
+    render->info = info;
+    /* the composition is laid out for the video size */
+    if (render->current_comp)
+      gst_video_overlay_composition_unref (render->current_comp);
+    render->current_comp = NULL;
+    if (render->current_subtitle)
+      render->current_comp =
+          gst_dvbsub_overlay_subs_to_comp (render, render->current_subtitle);
+  } else {
+    render->info = info;
+  }
+  g_mutex_unlock (&render->dvbsub_mutex);
 
   ret = gst_pad_set_caps (render->srcpad, caps);
   if (!ret)
@@ -671,6 +688,45 @@ gst_dvbsub_overlay_chain_text (GstPad * pad, GstObject * parent,
   return GST_FLOW_OK;
 }
 
+/* returns TRUE if both sets of subtitles show the same regions, which
+ * broadcasters do when they retransmit an unchanged page */
+static gboolean
+gst_dvbsub_overlay_subs_equal (DVBSubtitles * a, DVBSubtitles * b)
+{
+  gint i, k;
+
+  if (a->num_rects != b->num_rects)
+    return FALSE;
+
+  if (memcmp (&a->display_def, &b->display_def, sizeof (DVBSubtitleWindow)))
+    return FALSE;
+
+  for (i = 0; i < a->num_rects; i++) {
+    DVBSubtitleRect *ra = &a->rects[i];
+    DVBSubtitleRect *rb = &b->rects[i];
+    guint8 *da, *db;
+
+    if (ra->x != rb->x || ra->y != rb->y || ra->w != rb->w || ra->h != rb->h)
+      return FALSE;
+
+    if (ra->pict.palette_bits_count != rb->pict.palette_bits_count
+        || memcmp (ra->pict.palette, rb->pict.palette,
+            (1 << ra->pict.palette_bits_count) * sizeof (guint32)))
+      return FALSE;
+
+    da = ra->pict.data;
+    db = rb->pict.data;
+    for (k = 0; k < ra->h; k++) {
+      if (memcmp (da, db, ra->w))
+        return FALSE;
+      da += ra->pict.rowstride;
+      db += rb->pict.rowstride;
+    }
+  }
+
+  return TRUE;
+}
+
 static GstVideoOverlayComposition *
 gst_dvbsub_overlay_subs_to_comp (GstDVBSubOverlay * overlay,
     DVBSubtitles * subs)
@@ -709,32 +765,64 @@ gst_dvbsub_overlay_subs_to_comp (GstDVBSubOverlay * overlay,
     gint w, h;
     guint8 *in_data;
     guint32 *palette, *data;
+    guint32 lut[256];
+    gboolean opaque[256];
+    gint n_colors;
     gint rx, ry, rw, rh, stride;
+    gint x0, y0, x1, y1;
     gint k, l;
     GstMapInfo map;
 
     GST_LOG_OBJECT (overlay, "rectangle %d: %dx%d @ (%d, %d)", i,
         srect->w, srect->h, srect->x, srect->y);
 
-    w = srect->w;
-    h = srect->h;
+    palette = srect->pict.palette;
+    stride = srect->pict.rowstride;
+
+    /* look up the pixels in the byte order of the overlay format directly */
+    n_colors = 1 << srect->pict.palette_bits_count;
+    for (k = 0; k < 256; k++) {
+      guint32 ayuv = k < n_colors ? palette[k] : 0;
+
+      lut[k] = GUINT32_TO_BE (ayuv);
+      opaque[k] = (ayuv >> 24) != 0;
+    }
+
+    /* regions are often much larger than the text they hold, only keep the
+     * part that has visible pixels so that less has to be blended */
+    x0 = srect->w;
+    y0 = srect->h;
+    x1 = y1 = -1;
+    in_data = srect->pict.data;
+    for (k = 0; k < srect->h; k++) {
+      for (l = 0; l < srect->w; l++) {
+        if (opaque[in_data[l]]) {
+          x0 = MIN (x0, l);
+          x1 = MAX (x1, l);
+          y0 = MIN (y0, k);
+          y1 = k;
+        }
+      }
+      in_data += stride;
+    }
+
+    if (x1 < 0) {
+      GST_LOG_OBJECT (overlay, "rectangle %d is fully transparent", i);
+      continue;
+    }
+
+    w = x1 - x0 + 1;
+    h = y1 - y0 + 1;
 
     buf = gst_buffer_new_and_alloc (w * h * 4);
     gst_buffer_map (buf, &map, GST_MAP_WRITE);
     data = (guint32 *) map.data;
-    in_data = srect->pict.data;
-    palette = srect->pict.palette;
-    stride = srect->pict.rowstride;
+    in_data = srect->pict.data + y0 * stride + x0;
     for (k = 0; k < h; k++) {
-      for (l = 0; l < w; l++) {
-        guint32 ayuv;
-
-        ayuv = palette[*in_data];
-        GST_WRITE_UINT32_BE (data, ayuv);
-        in_data++;
-        data++;
-      }
-      in_data += stride - w;
+      for (l = 0; l < w; l++)
+        data[l] = lut[in_data[l]];
+      in_data += stride;
+      data += w;
     }
     gst_buffer_unmap (buf, &map);
 
@@ -742,10 +830,10 @@ gst_dvbsub_overlay_subs_to_comp (GstDVBSubOverlay * overlay,
      * to the window (if there is one) within a display of specified dimension.
      * Coordinate wrt the latter is then scaled to the actual dimension of
      * the video we are dealing with here. */
-    rx = gst_util_uint64_scale (wx + srect->x, width, dw);
-    ry = gst_util_uint64_scale (wy + srect->y, height, dh);
-    rw = gst_util_uint64_scale (srect->w, width, dw);
-    rh = gst_util_uint64_scale (srect->h, height, dh);
+    rx = gst_util_uint64_scale (wx + srect->x + x0, width, dw);
+    ry = gst_util_uint64_scale (wy + srect->y + y0, height, dh);
+    rw = gst_util_uint64_scale (w, width, dw);
+    rh = gst_util_uint64_scale (h, height, dh);
 
     GST_LOG_OBJECT (overlay, "rectangle %d rendered: %dx%d @ (%d, %d)", i,
         rw, rh, rx, ry);
@@ -868,12 +956,20 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstObject * parent,
           GST_TIME_FORMAT ") - it has %u regions",
           GST_TIME_ARGS (vid_running_time), GST_TIME_ARGS (candidate->pts),
           candidate->num_rects);
+      if (overlay->current_subtitle && overlay->current_comp
+          && gst_dvbsub_overlay_subs_equal (overlay->current_subtitle,
+              candidate)) {
+        /* same page again, keep the composition and whatever the blending
+         * already cached for it */
+        GST_DEBUG_OBJECT (overlay, "page unchanged, reusing composition");
+      } else {
+        if (overlay->current_comp)
+          gst_video_overlay_composition_unref (overlay->current_comp);
+        overlay->current_comp =
+            gst_dvbsub_overlay_subs_to_comp (overlay, candidate);
+      }
       dvb_subtitles_free (overlay->current_subtitle);
       overlay->current_subtitle = candidate;
-      if (overlay->current_comp)
-        gst_video_overlay_composition_unref (overlay->current_comp);
-      overlay->current_comp =
-          gst_dvbsub_overlay_subs_to_comp (overlay, overlay->current_subtitle);
     }
   }
 
@@ -891,10 +987,10 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstObject * parent,
   }
 
   /* Now render it */
-  if (g_atomic_int_get (&overlay->enable) && overlay->current_subtitle) {
+  if (g_atomic_int_get (&overlay->enable) && overlay->current_subtitle
+      && overlay->current_comp) {
     GstVideoFrame frame;
 
-    g_assert (overlay->current_comp);
     if (overlay->attach_compo_to_buffer) {
       GST_DEBUG_OBJECT (overlay, "Attaching overlay image to video buffer");
       gst_buffer_add_video_overlay_composition_meta (buffer,
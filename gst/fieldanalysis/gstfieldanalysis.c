@@ -82,6 +82,9 @@ GST_DEBUG_CATEGORY_STATIC (gst_field_analysis_debug);
 #define DEFAULT_BLOCK_HEIGHT 16
 #define DEFAULT_BLOCK_THRESH 80
 #define DEFAULT_IGNORED_LINES 2
+#define DEFAULT_THREADS 0
+
+#define MAX_THREADS 16
 
 enum
 {
@@ -96,7 +99,9 @@ enum
   PROP_BLOCK_WIDTH,
   PROP_BLOCK_HEIGHT,
   PROP_BLOCK_THRESH,
-  PROP_IGNORED_LINES
+  PROP_IGNORED_LINES,
+  PROP_THREADS,
+  PROP_ANALYSIS_TIME
 };
 
 static GstStaticPadTemplate sink_factory =
@@ -274,6 +279,15 @@ gst_field_analysis_class_init (GstFieldAnalysisClass * klass)
           "Ignore this many lines from the top and bottom for windowed comb detection",
           2, G_MAXUINT64, DEFAULT_IGNORED_LINES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_THREADS,
+      g_param_spec_uint ("threads", "Threads",
+          "Number of threads used to compute the metrics (0 = automatic)",
+          0, MAX_THREADS, DEFAULT_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_ANALYSIS_TIME,
+      g_param_spec_uint64 ("analysis-time", "Analysis time",
+          "Time spent computing the metrics of the last frame in nanoseconds",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_field_analysis_change_state);
@@ -299,15 +313,36 @@ static gfloat same_parity_3_tap (GstFieldAnalysis * filter,
     FieldAnalysisFields (*history)[2]);
 static gfloat opposite_parity_5_tap (GstFieldAnalysis * filter,
     FieldAnalysisFields (*history)[2]);
-static guint64 block_score_for_row_32detect (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1);
-static guint64 block_score_for_row_iscombed (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1);
-static guint64 block_score_for_row_5_tap (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1);
+static guint64 block_score_for_row_32detect (FieldAnalysisBand * band,
+    guint8 * base_fj, guint8 * base_fjp1);
+static guint64 block_score_for_row_iscombed (FieldAnalysisBand * band,
+    guint8 * base_fj, guint8 * base_fjp1);
+static guint64 block_score_for_row_5_tap (FieldAnalysisBand * band,
+    guint8 * base_fj, guint8 * base_fjp1);
 static gfloat opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields (*history)[2]);
 
+static void
+gst_field_analysis_free_bands (GstFieldAnalysis * filter)
+{
+  guint i;
+
+  if (filter->pool) {
+    g_thread_pool_free (filter->pool, FALSE, TRUE);
+    filter->pool = NULL;
+  }
+
+  for (i = 0; i < filter->n_bands; i++) {
+    g_free (filter->bands[i].comb_mask);
+    g_free (filter->bands[i].block_scores);
+  }
+  g_free (filter->bands);
+  filter->bands = NULL;
+  filter->n_bands = 0;
+  filter->bands_width = 0;
+  filter->bands_block_width = 0;
+}
+
 static void
 gst_field_analysis_clear_frames (GstFieldAnalysis * filter)
 {
@@ -327,10 +362,8 @@ gst_field_analysis_reset (GstFieldAnalysis * filter)
   filter->is_telecine = FALSE;
   filter->first_buffer = TRUE;
   gst_video_info_init (&filter->vinfo);
-  g_free (filter->comb_mask);
-  filter->comb_mask = NULL;
-  g_free (filter->block_scores);
-  filter->block_scores = NULL;
+  gst_field_analysis_free_bands (filter);
+  filter->analysis_time = 0;
 }
 
 static void
@@ -347,6 +380,9 @@ gst_field_analysis_init (GstFieldAnalysis * filter)
   gst_element_add_pad (GST_ELEMENT (filter), filter->sinkpad);
   gst_element_add_pad (GST_ELEMENT (filter), filter->srcpad);
 
+  g_mutex_init (&filter->bands_lock);
+  g_cond_init (&filter->bands_cond);
+
   filter->nframes = 0;
   gst_field_analysis_reset (filter);
   filter->same_field = &same_parity_ssd;
@@ -360,6 +396,7 @@ gst_field_analysis_init (GstFieldAnalysis * filter)
   filter->block_height = DEFAULT_BLOCK_HEIGHT;
   filter->block_thresh = DEFAULT_BLOCK_THRESH;
   filter->ignored_lines = DEFAULT_IGNORED_LINES;
+  filter->threads = DEFAULT_THREADS;
 }
 
 static void
@@ -425,18 +462,6 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
       break;
     case PROP_BLOCK_WIDTH:
       filter->block_width = g_value_get_uint64 (value);
-      if (GST_VIDEO_FRAME_WIDTH (&filter->frames[0].frame)) {
-        const gint frame_width =
-            GST_VIDEO_FRAME_WIDTH (&filter->frames[0].frame);
-        if (filter->block_scores) {
-          gsize nbytes = (frame_width / filter->block_width) * sizeof (guint);
-          filter->block_scores = g_realloc (filter->block_scores, nbytes);
-          memset (filter->block_scores, 0, nbytes);
-        } else {
-          filter->block_scores =
-              g_malloc0 ((frame_width / filter->block_width) * sizeof (guint));
-        }
-      }
       break;
     case PROP_BLOCK_HEIGHT:
       filter->block_height = g_value_get_uint64 (value);
@@ -447,6 +472,11 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       filter->ignored_lines = g_value_get_uint64 (value);
       break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (filter);
+      filter->threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -521,6 +551,16 @@ gst_field_analysis_get_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       g_value_set_uint64 (value, filter->ignored_lines);
       break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (filter);
+      g_value_set_uint (value, filter->threads);
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    case PROP_ANALYSIS_TIME:
+      GST_OBJECT_LOCK (filter);
+      g_value_set_uint64 (value, filter->analysis_time);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -530,7 +570,6 @@ gst_field_analysis_get_property (GObject * object, guint prop_id,
 static void
 gst_field_analysis_update_format (GstFieldAnalysis * filter, GstCaps * caps)
 {
-  gint width;
   GQueue *outbufs;
   GstVideoInfo vinfo;
 
@@ -567,22 +606,6 @@ gst_field_analysis_update_format (GstFieldAnalysis * filter, GstCaps * caps)
   filter->flushing = FALSE;
 
   filter->vinfo = vinfo;
-  width = GST_VIDEO_INFO_WIDTH (&filter->vinfo);
-
-  /* update allocations for metric scores */
-  if (filter->comb_mask) {
-    filter->comb_mask = g_realloc (filter->comb_mask, width);
-  } else {
-    filter->comb_mask = g_malloc (width);
-  }
-  if (filter->block_scores) {
-    gsize nbytes = (width / filter->block_width) * sizeof (guint);
-    filter->block_scores = g_realloc (filter->block_scores, nbytes);
-    memset (filter->block_scores, 0, nbytes);
-  } else {
-    filter->block_scores =
-        g_malloc0 ((width / filter->block_width) * sizeof (guint));
-  }
 
   GST_OBJECT_UNLOCK (filter);
   return;
@@ -804,121 +827,256 @@ gst_field_analysis_sink_event (GstPad * pad, GstObject * parent,
 }
 
 
-static gfloat
-same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+static guint
+gst_field_analysis_get_n_bands (GstFieldAnalysis * filter)
+{
+  guint n_bands = filter->threads;
+
+  if (n_bands == 0) {
+#if GLIB_CHECK_VERSION(2,36,0)
+    n_bands = g_get_num_processors ();
+#else
+    n_bands = 1;
+#endif
+  }
+
+  return CLAMP (n_bands, 1, MAX_THREADS);
+}
+
+static void
+gst_field_analysis_band_thread (gpointer data, gpointer user_data)
+{
+  GstFieldAnalysis *filter = user_data;
+  FieldAnalysisBand *band = data;
+
+  band->func (band);
+
+  g_mutex_lock (&filter->bands_lock);
+  if (--filter->bands_pending == 0)
+    g_cond_signal (&filter->bands_cond);
+  g_mutex_unlock (&filter->bands_lock);
+}
+
+/* (re)allocates the bands and their scratch space if the number of threads,
+ * the frame width or the block width changed */
+static void
+gst_field_analysis_setup_bands (GstFieldAnalysis * filter, gint width)
+{
+  guint i;
+  const guint n_bands = gst_field_analysis_get_n_bands (filter);
+
+  if (filter->bands && n_bands == filter->n_bands
+      && width == filter->bands_width
+      && filter->block_width == filter->bands_block_width)
+    return;
+
+  gst_field_analysis_free_bands (filter);
+
+  GST_DEBUG_OBJECT (filter, "using %u bands for width %d", n_bands, width);
+
+  filter->bands = g_new0 (FieldAnalysisBand, n_bands);
+  for (i = 0; i < n_bands; i++) {
+    FieldAnalysisBand *band = &filter->bands[i];
+
+    band->filter = filter;
+    band->comb_mask = g_malloc (width + 1);
+    band->comb_mask[0] = 0xff;
+    band->block_scores = g_new0 (guint, width / filter->block_width + 1);
+  }
+  filter->n_bands = n_bands;
+  filter->bands_width = width;
+  filter->bands_block_width = filter->block_width;
+
+  if (n_bands > 1) {
+    filter->pool = g_thread_pool_new (gst_field_analysis_band_thread, filter,
+        n_bands - 1, FALSE, NULL);
+    if (!filter->pool)
+      GST_WARNING_OBJECT (filter, "failed to create thread pool, analysing "
+          "bands sequentially");
+  }
+}
+
+/* splits nrows rows into bands and runs func on each of them, the first band
+ * on the calling thread and the others on the thread pool. returns the
+ * number of bands used */
+static guint
+gst_field_analysis_run_bands (GstFieldAnalysis * filter,
+    FieldAnalysisFields (*history)[2], void (*func) (FieldAnalysisBand *),
+    gint nrows)
+{
+  guint i, n_bands;
+
+  gst_field_analysis_setup_bands (filter,
+      GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame));
+
+  n_bands = MIN (filter->n_bands, MAX (nrows, 1));
+  for (i = 0; i < n_bands; i++) {
+    FieldAnalysisBand *band = &filter->bands[i];
+
+    band->history = history;
+    band->func = func;
+    band->start = nrows * i / n_bands;
+    band->end = nrows * (i + 1) / n_bands;
+    band->sum = 0;
+  }
+  g_atomic_int_set (&filter->combed, 0);
+
+  if (filter->pool && n_bands > 1) {
+    g_mutex_lock (&filter->bands_lock);
+    filter->bands_pending = n_bands - 1;
+    g_mutex_unlock (&filter->bands_lock);
+
+    for (i = 1; i < n_bands; i++)
+      g_thread_pool_push (filter->pool, &filter->bands[i], NULL);
+
+    func (&filter->bands[0]);
+
+    g_mutex_lock (&filter->bands_lock);
+    while (filter->bands_pending > 0)
+      g_cond_wait (&filter->bands_cond, &filter->bands_lock);
+    g_mutex_unlock (&filter->bands_lock);
+  } else {
+    for (i = 0; i < n_bands; i++)
+      func (&filter->bands[i]);
+  }
+
+  return n_bands;
+}
+
+static guint64
+gst_field_analysis_sum_bands (GstFieldAnalysis * filter,
+    FieldAnalysisFields (*history)[2], void (*func) (FieldAnalysisBand *),
+    gint nrows)
+{
+  guint i, n_bands;
+  guint64 sum = 0;
+
+  n_bands = gst_field_analysis_run_bands (filter, history, func, nrows);
+  for (i = 0; i < n_bands; i++)
+    sum += filter->bands[i].sum;
+
+  return sum;
+}
+
+/* returns a pointer to the given line of the luma plane of the field's frame */
+static inline guint8 *
+field_analysis_line (FieldAnalysisFields * field, gint line)
+{
+  return GST_VIDEO_FRAME_COMP_DATA (&field->frame, 0) +
+      GST_VIDEO_FRAME_COMP_OFFSET (&field->frame, 0) +
+      line * GST_VIDEO_FRAME_COMP_STRIDE (&field->frame, 0);
+}
+
+static void
+same_parity_sad_band (FieldAnalysisBand * band)
 {
   gint j;
-  gfloat sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields (*history)[2] = band->history;
 
   const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
-  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
   const gint stride0x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
   const gint stride1x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0) << 1;
-  const guint32 noise_floor = filter->noise_floor;
-
-  f1j =
-      GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-      0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame,
-      0) +
-      (*history)[0].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame,
-      0);
-  f2j =
-      GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-      0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame,
-      0) +
-      (*history)[1].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame,
-      0);
-
-  sum = 0.0f;
-  for (j = 0; j < (height >> 1); j++) {
+  const guint32 noise_floor = band->filter->noise_floor;
+
+  f1j = field_analysis_line (&(*history)[0],
+      (band->start << 1) + (*history)[0].parity);
+  f2j = field_analysis_line (&(*history)[1],
+      (band->start << 1) + (*history)[1].parity);
+
+  for (j = band->start; j < band->end; j++) {
     guint32 tempsum = 0;
     fieldanalysis_orc_same_parity_sad_planar_yuv (&tempsum, f1j, f2j,
         noise_floor, width);
-    sum += tempsum;
+    band->sum += tempsum;
     f1j += stride0x2;
     f2j += stride1x2;
   }
+}
+
+static gfloat
+same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+{
+  guint64 sum;
+
+  const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
+  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
+
+  sum = gst_field_analysis_sum_bands (filter, history, same_parity_sad_band,
+      height >> 1);
 
   return sum / (0.5f * width * height);
 }
 
-static gfloat
-same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+static void
+same_parity_ssd_band (FieldAnalysisBand * band)
 {
   gint j;
-  gfloat sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields (*history)[2] = band->history;
 
   const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
-  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
   const gint stride0x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
   const gint stride1x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0) << 1;
   /* noise floor needs to be squared for SSD */
-  const guint32 noise_floor = filter->noise_floor * filter->noise_floor;
-
-  f1j =
-      GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-      0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame,
-      0) +
-      (*history)[0].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame,
-      0);
-  f2j =
-      GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-      0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame,
-      0) +
-      (*history)[1].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame,
-      0);
-
-  sum = 0.0f;
-  for (j = 0; j < (height >> 1); j++) {
+  const guint32 noise_floor =
+      band->filter->noise_floor * band->filter->noise_floor;
+
+  f1j = field_analysis_line (&(*history)[0],
+      (band->start << 1) + (*history)[0].parity);
+  f2j = field_analysis_line (&(*history)[1],
+      (band->start << 1) + (*history)[1].parity);
+
+  for (j = band->start; j < band->end; j++) {
     guint32 tempsum = 0;
     fieldanalysis_orc_same_parity_ssd_planar_yuv (&tempsum, f1j, f2j,
         noise_floor, width);
-    sum += tempsum;
+    band->sum += tempsum;
     f1j += stride0x2;
     f2j += stride1x2;
   }
+}
+
+static gfloat
+same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+{
+  guint64 sum;
+
+  const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
+  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
+
+  sum = gst_field_analysis_sum_bands (filter, history, same_parity_ssd_band,
+      height >> 1);
 
   return sum / (0.5f * width * height); /* field is half height */
 }
 
-/* horizontal [1,4,1] diff between fields - is this a good idea or should the
- * current sample be emphasised more or less? */
-static gfloat
-same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+static void
+same_parity_3_tap_band (FieldAnalysisBand * band)
 {
   gint i, j;
-  gfloat sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields (*history)[2] = band->history;
 
   const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
-  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
   const gint stride0x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
   const gint stride1x2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0) << 1;
   const gint incr = GST_VIDEO_FRAME_COMP_PSTRIDE (&(*history)[0].frame, 0);
   /* noise floor needs to be *6 for [1,4,1] */
-  const guint32 noise_floor = filter->noise_floor * 6;
-
-  f1j = GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame, 0) +
-      GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame, 0) +
-      (*history)[0].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame,
-      0);
-  f2j =
-      GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-      0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame,
-      0) +
-      (*history)[1].parity * GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame,
-      0);
-
-  sum = 0.0f;
-  for (j = 0; j < (height >> 1); j++) {
+  const guint32 noise_floor = band->filter->noise_floor * 6;
+
+  f1j = field_analysis_line (&(*history)[0],
+      (band->start << 1) + (*history)[0].parity);
+  f2j = field_analysis_line (&(*history)[1],
+      (band->start << 1) + (*history)[1].parity);
+
+  for (j = band->start; j < band->end; j++) {
     guint32 tempsum = 0;
     guint32 diff;
 
@@ -926,49 +1084,53 @@ same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
     diff = abs (((f1j[0] << 2) + (f1j[incr] << 1))
         - ((f2j[0] << 2) + (f2j[incr] << 1)));
     if (diff > noise_floor)
-      sum += diff;
+      band->sum += diff;
 
     fieldanalysis_orc_same_parity_3_tap_planar_yuv (&tempsum, f1j, &f1j[incr],
         &f1j[incr << 1], f2j, &f2j[incr], &f2j[incr << 1], noise_floor,
         width - 1);
-    sum += tempsum;
+    band->sum += tempsum;
 
     /* unroll last as it is a special case */
     i = width - 1;
     diff = abs (((f1j[i - incr] << 1) + (f1j[i] << 2))
         - ((f2j[i - incr] << 1) + (f2j[i] << 2)));
     if (diff > noise_floor)
-      sum += diff;
+      band->sum += diff;
 
     f1j += stride0x2;
     f2j += stride1x2;
   }
+}
+
+/* horizontal [1,4,1] diff between fields - is this a good idea or should the
+ * current sample be emphasised more or less? */
+static gfloat
+same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields (*history)[2])
+{
+  guint64 sum;
+
+  const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
+  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
+
+  sum = gst_field_analysis_sum_bands (filter, history, same_parity_3_tap_band,
+      height >> 1);
 
   return sum / ((6.0f / 2.0f) * width * height);        /* 1 + 4 + 1 = 6; field is half height */
 }
 
-/* vertical [1,-3,4,-3,1] - same as is used in FieldDiff from TIVTC,
- * tritical's AVISynth IVTC filter */
-/* 0th field's parity defines operation */
-static gfloat
-opposite_parity_5_tap (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2])
+static void
+opposite_parity_5_tap_band (FieldAnalysisBand * band)
 {
   gint j;
-  gfloat sum;
   guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
-  guint32 tempsum;
+  FieldAnalysisFields *fa, *fb;
+  FieldAnalysisFields (*history)[2] = band->history;
 
   const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
-  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
-  const gint stride0x2 =
-      GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
-  const gint stride1x2 =
-      GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0) << 1;
+  const gint last = (GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame) >> 1) - 1;
   /* noise floor needs to be *6 for [1,-3,4,-3,1] */
-  const guint32 noise_floor = filter->noise_floor * 6;
-
-  sum = 0.0f;
+  const guint32 noise_floor = band->filter->noise_floor * 6;
 
   /* fj is line j of the combined frame made from the top field even lines of
    *   field 0 and the bottom field odd lines from field 1
@@ -977,75 +1139,114 @@ opposite_parity_5_tap (GstFieldAnalysis * filter,
    * fj with j == 0 is the 0th line of the top field
    * fj with j == 1 is the 0th line of the bottom field or the 1st field of
    *   the frame*/
-
-  /* unroll first line as it is a special case */
   if ((*history)[0].parity == TOP_FIELD) {
-    fj = GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame, 0);
-    fjp1 =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0);
-    fjp2 = fj + stride0x2;
+    fa = &(*history)[0];
+    fb = &(*history)[1];
   } else {
-    fj = GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame, 0);
-    fjp1 =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0);
-    fjp2 = fj + stride1x2;
+    fa = &(*history)[1];
+    fb = &(*history)[0];
   }
 
-  tempsum = 0;
-  fieldanalysis_orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjp2, fjp1, fj,
-      fjp1, fjp2, noise_floor, width);
-  sum += tempsum;
-
-  for (j = 1; j < (height >> 1) - 1; j++) {
-    /* shift everything down a line in the field of interest (means += stridex2) */
-    fjm2 = fj;
-    fjm1 = fjp1;
-    fj = fjp2;
-    if ((*history)[0].parity == TOP_FIELD) {
-      fjp1 += stride1x2;
-      fjp2 += stride0x2;
+  for (j = band->start; j < band->end; j++) {
+    guint32 tempsum = 0;
+    const gint line = j << 1;
+
+    fj = field_analysis_line (fa, line);
+    /* the first and the last line are special cases that mirror the lines
+     * below or above them respectively */
+    if (j > 0) {
+      fjm2 = field_analysis_line (fa, line - 2);
+      fjm1 = field_analysis_line (fb, line - 1);
     } else {
-      fjp1 += stride0x2;
-      fjp2 += stride1x2;
+      fjm2 = field_analysis_line (fa, line + 2);
+      fjm1 = field_analysis_line (fb, line + 1);
+    }
+    if (j < last) {
+      fjp1 = field_analysis_line (fb, line + 1);
+      fjp2 = field_analysis_line (fa, line + 2);
+    } else {
+      fjp1 = fjm1;
+      fjp2 = fjm2;
     }
 
-    tempsum = 0;
     fieldanalysis_orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1,
         fj, fjp1, fjp2, noise_floor, width);
-    sum += tempsum;
+    band->sum += tempsum;
   }
+}
+
+/* vertical [1,-3,4,-3,1] - same as is used in FieldDiff from TIVTC,
+ * tritical's AVISynth IVTC filter */
+/* 0th field's parity defines operation */
+static gfloat
+opposite_parity_5_tap (GstFieldAnalysis * filter,
+    FieldAnalysisFields (*history)[2])
+{
+  guint64 sum;
 
-  /* unroll the last line as it is a special case */
-  /* shift everything down a line in the field of interest (means += stridex2) */
-  fjm2 = fj;
-  fjm1 = fjp1;
-  fj = fjp2;
+  const gint width = GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame);
+  const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
 
-  tempsum = 0;
-  fieldanalysis_orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj,
-      fjm1, fjm2, noise_floor, width);
-  sum += tempsum;
+  sum = gst_field_analysis_sum_bands (filter, history,
+      opposite_parity_5_tap_band, height >> 1);
 
   return sum / ((6.0f / 2.0f) * width * height);        /* 1 + 4 + 1 == 3 + 3 == 6; field is half height */
 }
 
+/* adds the combed samples of a line of the comb mask to the block scores. a
+ * sample counts if it and both its neighbours are combed. the leading
+ * sentinel means the left edge only needs its right neighbour and the right
+ * edge is handled separately as it only needs its left neighbour */
+static inline void
+field_analysis_score_line (FieldAnalysisBand * band, gint width,
+    guint64 block_width)
+{
+  gint i, start;
+  const guint8 *comb_mask = band->comb_mask + 1;
+  guint *block_scores = band->block_scores;
+
+  if (width < 2)
+    return;
+
+  for (i = 0, start = 0; start < width - 1; i++, start += block_width) {
+    guint32 score = 0;
+    const gint end = MIN (start + block_width, width - 1);
+
+    fieldanalysis_orc_comb_block_score (&score, &comb_mask[start - 1],
+        &comb_mask[start], &comb_mask[start + 1], end - start);
+    block_scores[i] += score;
+  }
+
+  if (comb_mask[width - 2] && comb_mask[width - 1])
+    block_scores[(width - 1) / block_width]++;
+}
+
+static inline guint64
+field_analysis_max_block_score (FieldAnalysisBand * band, gint width,
+    guint64 block_width)
+{
+  guint64 i;
+  guint64 block_score = 0;
+
+  for (i = 0; i < width / block_width; i++) {
+    if (band->block_scores[i] > block_score)
+      block_score = band->block_scores[i];
+  }
+
+  return block_score;
+}
+
 /* this metric was sourced from HandBrake but originally from transcode
  * the return value is the highest block score for the row of blocks */
 static inline guint64
-block_score_for_row_32detect (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1)
+block_score_for_row_32detect (FieldAnalysisBand * band, guint8 * base_fj,
+    guint8 * base_fjp1)
 {
   guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
   guint8 *fjm2, *fjm1, *fj, *fjp1;
+  GstFieldAnalysis *filter = band->filter;
+  FieldAnalysisFields (*history)[2] = band->history;
+  guint8 *comb_mask = band->comb_mask + 1;
   const gint incr = GST_VIDEO_FRAME_COMP_PSTRIDE (&(*history)[0].frame, 0);
   const gint stridex2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
@@ -1056,53 +1257,37 @@ block_score_for_row_32detect (GstFieldAnalysis * filter,
       GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) -
       (GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) % block_width);
 
+  memset (band->block_scores, 0, (width / block_width) * sizeof (guint));
+
   fjm2 = base_fj - stridex2;
   fjm1 = base_fjp1 - stridex2;
   fj = base_fj;
   fjp1 = base_fjp1;
 
   for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
-
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] = abs (fj[0] - fjm2[0]) < 10 && abs (fj[0] - fjm1[0]) > 15;
+    if (incr == 1) {
+      fieldanalysis_orc_comb_mask_32detect (comb_mask, fjm2, fjm1, fj, fjp1,
+          MIN (spatial_thresh, 255), width);
     } else {
-      comb_mask[0] = FALSE;
-    }
-
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] = abs (fj[idx] - fjm2[idx]) < 10
-            && abs (fj[idx] - fjm1[idx]) > 15;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
+      for (i = 0; i < width; i++) {
+        const guint64 idx = i * incr;
+        gint diff1, diff2;
+
+        diff1 = fj[idx] - fjm1[idx];
+        diff2 = fj[idx] - fjp1[idx];
+        /* change in the same direction */
+        if (((diff1 > spatial_thresh && diff2 > spatial_thresh)
+                || (diff1 < -spatial_thresh && diff2 < -spatial_thresh))
+            && abs (fj[idx] - fjm2[idx]) < 10
+            && abs (fj[idx] - fjm1[idx]) > 15) {
+          comb_mask[i] = 0xff;
+        } else {
+          comb_mask[i] = 0;
+        }
       }
     }
+    field_analysis_score_line (band, width, block_width);
+
     /* advance down a line */
     fjm2 = fjm1;
     fjm1 = fj;
@@ -1110,29 +1295,21 @@ block_score_for_row_32detect (GstFieldAnalysis * filter,
     fjp1 = fjm1 + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
-  }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  return field_analysis_max_block_score (band, width, block_width);
 }
 
 /* this metric was sourced from HandBrake but originally from
  * tritical's isCombedT Avisynth function
  * the return value is the highest block score for the row of blocks */
 static inline guint64
-block_score_for_row_iscombed (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1)
+block_score_for_row_iscombed (FieldAnalysisBand * band, guint8 * base_fj,
+    guint8 * base_fjp1)
 {
   guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
   guint8 *fjm1, *fj, *fjp1;
+  GstFieldAnalysis *filter = band->filter;
+  FieldAnalysisFields (*history)[2] = band->history;
+  guint8 *comb_mask = band->comb_mask + 1;
   const gint incr = GST_VIDEO_FRAME_COMP_PSTRIDE (&(*history)[0].frame, 0);
   const gint stridex2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
@@ -1144,83 +1321,61 @@ block_score_for_row_iscombed (GstFieldAnalysis * filter,
       GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) -
       (GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) % block_width);
 
+  memset (band->block_scores, 0, (width / block_width) * sizeof (guint));
+
   fjm1 = base_fjp1 - stridex2;
   fj = base_fj;
   fjp1 = base_fjp1;
 
   for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
-
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          (fjm1[0] - fj[0]) * (fjp1[0] - fj[0]) > spatial_thresh_squared;
-    } else {
-      comb_mask[0] = FALSE;
-    }
-
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
-            spatial_thresh_squared;
-      } else {
-        comb_mask[i] = FALSE;
-      }
+    if (incr == 1) {
+      /* the product of two differences is at most 255 * 255 so larger
+       * thresholds can be clamped */
+      const gint st = MIN (spatial_thresh, 255);
 
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
+      fieldanalysis_orc_comb_mask_iscombed (comb_mask, fjm1, fj, fjp1, st,
+          st * st, width);
+    } else {
+      for (i = 0; i < width; i++) {
+        const guint64 idx = i * incr;
+        gint diff1, diff2;
+
+        diff1 = fj[idx] - fjm1[idx];
+        diff2 = fj[idx] - fjp1[idx];
+        /* change in the same direction */
+        if (((diff1 > spatial_thresh && diff2 > spatial_thresh)
+                || (diff1 < -spatial_thresh && diff2 < -spatial_thresh))
+            && (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
+            spatial_thresh_squared) {
+          comb_mask[i] = 0xff;
+        } else {
+          comb_mask[i] = 0;
+        }
       }
     }
+    field_analysis_score_line (band, width, block_width);
+
     /* advance down a line */
     fjm1 = fj;
     fj = fjp1;
     fjp1 = fjm1 + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
-  }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  return field_analysis_max_block_score (band, width, block_width);
 }
 
 /* this metric was sourced from HandBrake but originally from
  * tritical's isCombedT Avisynth function
  * the return value is the highest block score for the row of blocks */
 static inline guint64
-block_score_for_row_5_tap (GstFieldAnalysis * filter,
-    FieldAnalysisFields (*history)[2], guint8 * base_fj, guint8 * base_fjp1)
+block_score_for_row_5_tap (FieldAnalysisBand * band, guint8 * base_fj,
+    guint8 * base_fjp1)
 {
   guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
   guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
+  GstFieldAnalysis *filter = band->filter;
+  FieldAnalysisFields (*history)[2] = band->history;
+  guint8 *comb_mask = band->comb_mask + 1;
   const gint incr = GST_VIDEO_FRAME_COMP_PSTRIDE (&(*history)[0].frame, 0);
   const gint stridex2 =
       GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0) << 1;
@@ -1232,6 +1387,7 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter,
       GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) -
       (GST_VIDEO_FRAME_WIDTH (&(*history)[0].frame) % block_width);
 
+  memset (band->block_scores, 0, (width / block_width) * sizeof (guint));
 
   fjm2 = base_fj - stridex2;
   fjm1 = base_fjp1 - stridex2;
@@ -1240,67 +1396,48 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter,
   fjp2 = fj + stridex2;
 
   for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
-
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          abs (fjm2[0] + (fj[0] << 2) + fjp2[0] - 3 * (fjm1[0] + fjp1[0])) >
-          spatial_threshx6;
-
-      /* motion detection that needs previous and next frames
-         this isn't really necessary, but acts as an optimisation if the
-         additional delay isn't a problem
-         if (motion_detection) {
-         if (abs(fpj[idx] - fj[idx]               ) > motion_thresh &&
-         abs(           fjm1[idx] - fnjm1[idx]) > motion_thresh &&
-         abs(           fjp1[idx] - fnjp1[idx]) > motion_thresh)
-         motion++;
-         if (abs(             fj[idx]   - fnj[idx]) > motion_thresh &&
-         abs(fpjm1[idx] - fjm1[idx]           ) > motion_thresh &&
-         abs(fpjp1[idx] - fjp1[idx]           ) > motion_thresh)
-         motion++;
-         } else {
-         motion = 1;
-         }
-       */
-    } else {
-      comb_mask[0] = FALSE;
-    }
+    if (incr == 1) {
+      const gint st = MIN (spatial_thresh, 255);
 
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] - 3 * (fjm1[idx] +
-                fjp1[idx])) > spatial_threshx6;
-      } else {
-        comb_mask[i] = FALSE;
-      }
+      fieldanalysis_orc_comb_mask_5_tap (comb_mask, fjm2, fjm1, fj, fjp1, fjp2,
+          st, 6 * st, width);
+    } else {
+      for (i = 0; i < width; i++) {
+        const guint64 idx = i * incr;
+        gint diff1, diff2;
+
+        diff1 = fj[idx] - fjm1[idx];
+        diff2 = fj[idx] - fjp1[idx];
+        /* change in the same direction */
+        if (((diff1 > spatial_thresh && diff2 > spatial_thresh)
+                || (diff1 < -spatial_thresh && diff2 < -spatial_thresh))
+            && abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] -
+                3 * (fjm1[idx] + fjp1[idx])) > spatial_threshx6) {
+          comb_mask[i] = 0xff;
+        } else {
+          comb_mask[i] = 0;
+        }
 
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
+        /* motion detection that needs previous and next frames
+           this isn't really necessary, but acts as an optimisation if the
+           additional delay isn't a problem
+           if (motion_detection) {
+           if (abs(fpj[idx] - fj[idx]               ) > motion_thresh &&
+           abs(           fjm1[idx] - fnjm1[idx]) > motion_thresh &&
+           abs(           fjp1[idx] - fnjp1[idx]) > motion_thresh)
+           motion++;
+           if (abs(             fj[idx]   - fnj[idx]) > motion_thresh &&
+           abs(fpjm1[idx] - fjm1[idx]           ) > motion_thresh &&
+           abs(fpjp1[idx] - fjp1[idx]           ) > motion_thresh)
+           motion++;
+           } else {
+           motion = 1;
+           }
+         */
       }
     }
+    field_analysis_score_line (band, width, block_width);
+
     /* advance down a line */
     fjm2 = fjm1;
     fjm1 = fj;
@@ -1309,15 +1446,53 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter,
     fjp2 = fj + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
+  return field_analysis_max_block_score (band, width, block_width);
+}
+
+/* 0th field's parity defines operation */
+static void
+opposite_parity_windowed_comb_band (FieldAnalysisBand * band)
+{
+  gint j;
+  guint8 *base_fj, *base_fjp1;
+  GstFieldAnalysis *filter = band->filter;
+  FieldAnalysisFields (*history)[2] = band->history;
+
+  const gint stride = GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0);
+  const guint64 block_thresh = filter->block_thresh;
+  const guint64 block_height = filter->block_height;
+
+  if ((*history)[0].parity == TOP_FIELD) {
+    base_fj = field_analysis_line (&(*history)[0], 0);
+    base_fjp1 = field_analysis_line (&(*history)[1], 1);
+  } else {
+    base_fj = field_analysis_line (&(*history)[1], 0);
+    base_fjp1 = field_analysis_line (&(*history)[0], 1);
   }
 
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  /* we operate on a row of blocks of height block_height through each
+   * iteration, 1 in the sum marks slight combing and 2 combing */
+  for (j = band->start; j < band->end; j++) {
+    guint64 line_offset = (filter->ignored_lines + j * block_height) * stride;
+    guint64 block_score;
+
+    /* another band already found combing so the result is known */
+    if (g_atomic_int_get (&filter->combed))
+      break;
+
+    block_score = filter->block_score_for_row (band, base_fj + line_offset,
+        base_fjp1 + line_offset);
+
+    if (block_score > (block_thresh >> 1)
+        && block_score <= block_thresh) {
+      /* blend if nothing more combed comes along */
+      band->sum = 1;
+    } else if (block_score > block_thresh) {
+      band->sum = 2;
+      g_atomic_int_set (&filter->combed, 1);
+      break;
+    }
+  }
 }
 
 /* a pass is made over the field using one of three comb-detection metrics
@@ -1327,59 +1502,35 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter,
    score is between half the threshold and the threshold, the block is
    slightly combed. if when analysis is complete, slight combing is detected
    that is returned. if any results are observed that are above the threshold,
-   the function returns immediately */
-/* 0th field's parity defines operation */
+   the bands stop as soon as possible */
 static gfloat
 opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields (*history)[2])
 {
-  gint j;
+  guint i, n_bands;
+  gint nrows = 0;
   gboolean slightly_combed;
 
   const gint height = GST_VIDEO_FRAME_HEIGHT (&(*history)[0].frame);
-  const gint stride = GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0);
-  const guint64 block_thresh = filter->block_thresh;
   const guint64 block_height = filter->block_height;
-  guint8 *base_fj, *base_fjp1;
 
-  if ((*history)[0].parity == TOP_FIELD) {
-    base_fj =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame, 0);
-    base_fjp1 =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[1].frame, 0);
-  } else {
-    base_fj =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[1].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[1].frame, 0);
-    base_fjp1 =
-        GST_VIDEO_FRAME_COMP_DATA (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_OFFSET (&(*history)[0].frame,
-        0) + GST_VIDEO_FRAME_COMP_STRIDE (&(*history)[0].frame, 0);
-  }
+  if (height >= filter->ignored_lines + block_height)
+    nrows = (height - filter->ignored_lines - block_height) / block_height + 1;
 
-  /* we operate on a row of blocks of height block_height through each iteration */
-  slightly_combed = FALSE;
-  for (j = 0; j <= height - filter->ignored_lines - block_height;
-      j += block_height) {
-    guint64 line_offset = (filter->ignored_lines + j) * stride;
-    guint block_score =
-        filter->block_score_for_row (filter, history, base_fj + line_offset,
-        base_fjp1 + line_offset);
+  n_bands = gst_field_analysis_run_bands (filter, history,
+      opposite_parity_windowed_comb_band, nrows);
 
-    if (block_score > (block_thresh >> 1)
-        && block_score <= block_thresh) {
-      /* blend if nothing more combed comes along */
-      slightly_combed = TRUE;
-    } else if (block_score > block_thresh) {
+  slightly_combed = FALSE;
+  for (i = 0; i < n_bands; i++) {
+    if (filter->bands[i].sum == 2) {
       if (GST_VIDEO_INFO_INTERLACE_MODE (&(*history)[0].frame.info) ==
           GST_VIDEO_INTERLACE_MODE_INTERLEAVED) {
         return 1.0f;            /* blend */
       } else {
         return 2.0f;            /* deinterlace */
       }
+    } else if (filter->bands[i].sum == 1) {
+      slightly_combed = TRUE;
     }
   }
 
@@ -1417,6 +1568,7 @@ gst_field_analysis_process_buffer (GstFieldAnalysis * filter,
   FieldAnalysis *res0, *res1;
   FieldAnalysisFields history[2];
   GstBuffer *outbuf = NULL;
+  gint64 start_time;
 
   /* move previous result to index 1 */
   filter->frames[1] = filter->frames[0];
@@ -1434,6 +1586,8 @@ gst_field_analysis_process_buffer (GstFieldAnalysis * filter,
   res0 = &filter->frames[0].results;    /* results for current frame */
   res1 = &filter->frames[1].results;    /* results for previous frame */
 
+  start_time = g_get_monotonic_time ();
+
   history[0].frame = filter->frames[0].frame;
   /* we do it like this because the first frame has no predecessor so this is
    * the only result we can get for it */
@@ -1444,6 +1598,8 @@ gst_field_analysis_process_buffer (GstFieldAnalysis * filter,
     /* compare the fields within the buffer, if the buffer exhibits combing it
      * could be interlaced or a mixed telecine frame */
     res0->f = filter->same_frame (filter, &history);
+    filter->analysis_time =
+        (g_get_monotonic_time () - start_time) * GST_USECOND;
     res0->t = res0->b = res0->t_b = res0->b_t = G_MAXINT64;
     if (filter->nframes == 1)
       GST_DEBUG_OBJECT (filter, "Scores: f %f, t , b , t_b , b_t ", res0->f);
@@ -1480,9 +1636,13 @@ gst_field_analysis_process_buffer (GstFieldAnalysis * filter,
     history[1].parity = TOP_FIELD;
     res0->b_t = filter->same_frame (filter, &history);
 
+    filter->analysis_time =
+        (g_get_monotonic_time () - start_time) * GST_USECOND;
+
     GST_DEBUG_OBJECT (filter,
-        "Scores: f %f, t %f, b %f, t_b %f, b_t %f", res0->f,
-        res0->t, res0->b, res0->t_b, res0->b_t);
+        "Scores: f %f, t %f, b %f, t_b %f, b_t %f (analysed in %"
+        GST_TIME_FORMAT ")", res0->f, res0->t, res0->b, res0->t_b, res0->b_t,
+        GST_TIME_ARGS (filter->analysis_time));
 
     /* analysis */
     telecine_matches = 0;
@@ -1833,6 +1993,8 @@ gst_field_analysis_finalize (GObject * object)
   GstFieldAnalysis *filter = GST_FIELDANALYSIS (object);
 
   gst_field_analysis_reset (filter);
+  g_mutex_clear (&filter->bands_lock);
+  g_cond_clear (&filter->bands_cond);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
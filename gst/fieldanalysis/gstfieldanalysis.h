@@ -63,6 +63,7 @@ typedef struct _GstFieldAnalysisClass GstFieldAnalysisClass;
 typedef struct _FieldAnalysisFields FieldAnalysisFields;
 typedef struct _FieldAnalysisHistory FieldAnalysisHistory;
 typedef struct _FieldAnalysis FieldAnalysis;
+typedef struct _FieldAnalysisBand FieldAnalysisBand;
 
 typedef enum
 {
@@ -101,6 +102,20 @@ struct _FieldAnalysisHistory
   FieldAnalysis results;
 };
 
+/* a range of rows of a metric, processed by one thread */
+struct _FieldAnalysisBand
+{
+  GstFieldAnalysis *filter;
+  FieldAnalysisFields (*history)[2];
+  void (*func) (FieldAnalysisBand *);
+  gint start, end;
+  guint64 sum;
+  /* scratch space for windowed comb detection, the comb mask has one
+   * leading sentinel sample */
+  guint8 *comb_mask;
+  guint *block_scores;
+};
+
 typedef enum
 {
   METHOD_32DETECT,
@@ -119,14 +134,24 @@ struct _GstFieldAnalysis
   GstVideoInfo vinfo;
   gfloat (*same_field) (GstFieldAnalysis *, FieldAnalysisFields (*)[2]);
   gfloat (*same_frame) (GstFieldAnalysis *, FieldAnalysisFields (*)[2]);
-  guint64 (*block_score_for_row) (GstFieldAnalysis *, FieldAnalysisFields (*)[2], guint8 *, guint8 *);
+  guint64 (*block_score_for_row) (FieldAnalysisBand *, guint8 *, guint8 *);
   gboolean is_telecine;
   gboolean first_buffer; /* indicates the first buffer for which a buffer will be output
                           * after a discont or flushing seek */
-  guint8 *comb_mask;
-  guint *block_scores;
   gboolean flushing;     /* indicates whether we are flushing or not */
 
+  /* metrics are computed in bands of rows in parallel */
+  GThreadPool *pool;
+  FieldAnalysisBand *bands;
+  guint n_bands;
+  gint bands_width;      /* width the band scratch space was allocated for */
+  guint64 bands_block_width;
+  GMutex bands_lock;
+  GCond bands_cond;
+  guint bands_pending;
+  volatile gint combed;  /* lets the bands stop early once combing is found */
+  GstClockTime analysis_time; /* time spent analysing the last frame */
+
   /* properties */
   guint32 noise_floor; /* threshold for the result of a metric to be valid */
   gfloat field_thresh; /* threshold used for the same parity field metric */
@@ -135,6 +160,7 @@ struct _GstFieldAnalysis
   guint64 block_width, block_height; /* width/height of window used for comb clusted detection */
   guint64 block_thresh;
   guint64 ignored_lines;
+  guint threads;
 };
 
 struct _GstFieldAnalysisClass
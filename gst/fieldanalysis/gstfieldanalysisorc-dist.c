@@ -111,6 +111,20 @@ void fieldanalysis_orc_opposite_parity_5_tap_planar_yuv (guint32 *
     const orc_uint8 * ORC_RESTRICT s2, const orc_uint8 * ORC_RESTRICT s3,
     const orc_uint8 * ORC_RESTRICT s4, const orc_uint8 * ORC_RESTRICT s5,
     int p1, int n);
+void fieldanalysis_orc_comb_mask_32detect (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n);
+void fieldanalysis_orc_comb_mask_iscombed (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n);
+void fieldanalysis_orc_comb_mask_5_tap (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n);
+void fieldanalysis_orc_comb_block_score (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int n);
 
 
 /* begin Orc C target preamble */
@@ -1195,3 +1209,1208 @@ fieldanalysis_orc_opposite_parity_5_tap_planar_yuv (guint32 * ORC_RESTRICT a1,
   *a1 = orc_executor_get_accumulator (ex, ORC_VAR_A1);
 }
 #endif
+
+
+/* fieldanalysis_orc_comb_mask_32detect */
+#ifdef DISABLE_ORC
+void
+fieldanalysis_orc_comb_mask_32detect (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_int8 var71;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+
+  /* loadpw */
+  var50.i = p1;
+  /* loadpw */
+  var62.i = (int) 0x0000000a;
+  /* loadpw */
+  var68.i = (int) 0x0000000f;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* loadb */
+    var46 = ptr7[i];
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* subw */
+    var48.i = var45.i - var43.i;
+    /* subw */
+    var49.i = var45.i - var47.i;
+    /* cmpgtsw */
+    var51.i = (var48.i > var50.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var52.i = (var49.i > var50.i) ? (~0) : 0;
+    /* andw */
+    var53.i = var51.i & var52.i;
+    /* subw */
+    var54.i = var43.i - var45.i;
+    /* subw */
+    var55.i = var47.i - var45.i;
+    /* cmpgtsw */
+    var56.i = (var54.i > var50.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var57.i = (var55.i > var50.i) ? (~0) : 0;
+    /* andw */
+    var58.i = var56.i & var57.i;
+    /* orw */
+    var59.i = var53.i | var58.i;
+    /* subw */
+    var60.i = var45.i - var41.i;
+    /* absw */
+    var61.i = ORC_ABS (var60.i);
+    /* subw */
+    var63.i = var61.i - var62.i;
+    /* shrsw */
+    var64.i = var63.i >> 15;
+    /* andw */
+    var65.i = var59.i & var64.i;
+    /* subw */
+    var66.i = var45.i - var43.i;
+    /* absw */
+    var67.i = ORC_ABS (var66.i);
+    /* cmpgtsw */
+    var69.i = (var67.i > var68.i) ? (~0) : 0;
+    /* andw */
+    var70.i = var65.i & var69.i;
+    /* convwb */
+    var71 = var70.i;
+    /* storeb */
+    ptr0[i] = var71;
+  }
+
+}
+
+#else
+static void
+_backup_fieldanalysis_orc_comb_mask_32detect (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_int8 var71;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+
+  /* loadpw */
+  var50.i = ex->params[24];
+  /* loadpw */
+  var62.i = (int) 0x0000000a;
+  /* loadpw */
+  var68.i = (int) 0x0000000f;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* loadb */
+    var46 = ptr7[i];
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* subw */
+    var48.i = var45.i - var43.i;
+    /* subw */
+    var49.i = var45.i - var47.i;
+    /* cmpgtsw */
+    var51.i = (var48.i > var50.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var52.i = (var49.i > var50.i) ? (~0) : 0;
+    /* andw */
+    var53.i = var51.i & var52.i;
+    /* subw */
+    var54.i = var43.i - var45.i;
+    /* subw */
+    var55.i = var47.i - var45.i;
+    /* cmpgtsw */
+    var56.i = (var54.i > var50.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var57.i = (var55.i > var50.i) ? (~0) : 0;
+    /* andw */
+    var58.i = var56.i & var57.i;
+    /* orw */
+    var59.i = var53.i | var58.i;
+    /* subw */
+    var60.i = var45.i - var41.i;
+    /* absw */
+    var61.i = ORC_ABS (var60.i);
+    /* subw */
+    var63.i = var61.i - var62.i;
+    /* shrsw */
+    var64.i = var63.i >> 15;
+    /* andw */
+    var65.i = var59.i & var64.i;
+    /* subw */
+    var66.i = var45.i - var43.i;
+    /* absw */
+    var67.i = ORC_ABS (var66.i);
+    /* cmpgtsw */
+    var69.i = (var67.i > var68.i) ? (~0) : 0;
+    /* andw */
+    var70.i = var65.i & var69.i;
+    /* convwb */
+    var71 = var70.i;
+    /* storeb */
+    ptr0[i] = var71;
+  }
+
+}
+
+void
+fieldanalysis_orc_comb_mask_32detect (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "fieldanalysis_orc_comb_mask_32detect");
+      orc_program_set_backup_function (p,
+          _backup_fieldanalysis_orc_comb_mask_32detect);
+      orc_program_add_destination (p, 1, "d1");
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_source (p, 1, "s2");
+      orc_program_add_source (p, 1, "s3");
+      orc_program_add_source (p, 1, "s4");
+      orc_program_add_constant (p, 4, 0x0000000a, "c1");
+      orc_program_add_constant (p, 4, 0x0000000f, "c2");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 2, "t4");
+      orc_program_add_temporary (p, 2, "t5");
+      orc_program_add_temporary (p, 2, "t6");
+      orc_program_add_temporary (p, 2, "t7");
+
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_T6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_T6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "absw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shrsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "absw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T7, ORC_VAR_D1,
+          ORC_VAR_D1);
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* fieldanalysis_orc_comb_mask_iscombed */
+#ifdef DISABLE_ORC
+void
+fieldanalysis_orc_comb_mask_iscombed (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union32 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union32 var60;
+  orc_union32 var61;
+  orc_union32 var62;
+  orc_union16 var63;
+  orc_int8 var64;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  /* loadpw */
+  var48.i = p1;
+  /* loadpl */
+  var59.i = p2;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* subw */
+    var46.i = var43.i - var41.i;
+    /* subw */
+    var47.i = var43.i - var45.i;
+    /* cmpgtsw */
+    var49.i = (var46.i > var48.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var50.i = (var47.i > var48.i) ? (~0) : 0;
+    /* andw */
+    var51.i = var49.i & var50.i;
+    /* subw */
+    var52.i = var41.i - var43.i;
+    /* subw */
+    var53.i = var45.i - var43.i;
+    /* mulswl */
+    var54.i = var52.i * var53.i;
+    /* cmpgtsw */
+    var55.i = (var52.i > var48.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var56.i = (var53.i > var48.i) ? (~0) : 0;
+    /* andw */
+    var57.i = var55.i & var56.i;
+    /* orw */
+    var58.i = var51.i | var57.i;
+    /* cmpgtsl */
+    var60.i = (var54.i > var59.i) ? (~0) : 0;
+    /* convswl */
+    var61.i = var58.i;
+    /* andl */
+    var62.i = var61.i & var60.i;
+    /* convlw */
+    var63.i = var62.i;
+    /* convwb */
+    var64 = var63.i;
+    /* storeb */
+    ptr0[i] = var64;
+  }
+
+}
+
+#else
+static void
+_backup_fieldanalysis_orc_comb_mask_iscombed (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union32 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union32 var59;
+  orc_union32 var60;
+  orc_union32 var61;
+  orc_union32 var62;
+  orc_union16 var63;
+  orc_int8 var64;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  /* loadpw */
+  var48.i = ex->params[24];
+  /* loadpl */
+  var59.i = ex->params[25];
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* subw */
+    var46.i = var43.i - var41.i;
+    /* subw */
+    var47.i = var43.i - var45.i;
+    /* cmpgtsw */
+    var49.i = (var46.i > var48.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var50.i = (var47.i > var48.i) ? (~0) : 0;
+    /* andw */
+    var51.i = var49.i & var50.i;
+    /* subw */
+    var52.i = var41.i - var43.i;
+    /* subw */
+    var53.i = var45.i - var43.i;
+    /* mulswl */
+    var54.i = var52.i * var53.i;
+    /* cmpgtsw */
+    var55.i = (var52.i > var48.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var56.i = (var53.i > var48.i) ? (~0) : 0;
+    /* andw */
+    var57.i = var55.i & var56.i;
+    /* orw */
+    var58.i = var51.i | var57.i;
+    /* cmpgtsl */
+    var60.i = (var54.i > var59.i) ? (~0) : 0;
+    /* convswl */
+    var61.i = var58.i;
+    /* andl */
+    var62.i = var61.i & var60.i;
+    /* convlw */
+    var63.i = var62.i;
+    /* convwb */
+    var64 = var63.i;
+    /* storeb */
+    ptr0[i] = var64;
+  }
+
+}
+
+void
+fieldanalysis_orc_comb_mask_iscombed (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "fieldanalysis_orc_comb_mask_iscombed");
+      orc_program_set_backup_function (p,
+          _backup_fieldanalysis_orc_comb_mask_iscombed);
+      orc_program_add_destination (p, 1, "d1");
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_source (p, 1, "s2");
+      orc_program_add_source (p, 1, "s3");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_parameter (p, 4, "p2");
+      orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 2, "t4");
+      orc_program_add_temporary (p, 2, "t5");
+      orc_program_add_temporary (p, 2, "t6");
+      orc_program_add_temporary (p, 4, "t7");
+      orc_program_add_temporary (p, 4, "t8");
+
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_T1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_P2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convswl", 0, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andl", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convlw", 0, ORC_VAR_T6, ORC_VAR_T7, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T6, ORC_VAR_D1,
+          ORC_VAR_D1);
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* fieldanalysis_orc_comb_mask_5_tap */
+#ifdef DISABLE_ORC
+void
+fieldanalysis_orc_comb_mask_5_tap (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_int8 var73;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+  ptr8 = (orc_int8 *) s5;
+
+  /* loadpw */
+  var52.i = p1;
+  /* loadpw */
+  var66.i = (int) 0x00000003;
+  /* loadpw */
+  var70.i = p2;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* loadb */
+    var46 = ptr7[i];
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* loadb */
+    var48 = ptr8[i];
+    /* convubw */
+    var49.i = (orc_uint8) var48;
+    /* subw */
+    var50.i = var45.i - var43.i;
+    /* subw */
+    var51.i = var45.i - var47.i;
+    /* cmpgtsw */
+    var53.i = (var50.i > var52.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var54.i = (var51.i > var52.i) ? (~0) : 0;
+    /* andw */
+    var55.i = var53.i & var54.i;
+    /* subw */
+    var56.i = var43.i - var45.i;
+    /* subw */
+    var57.i = var47.i - var45.i;
+    /* cmpgtsw */
+    var58.i = (var56.i > var52.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var59.i = (var57.i > var52.i) ? (~0) : 0;
+    /* andw */
+    var60.i = var58.i & var59.i;
+    /* orw */
+    var61.i = var55.i | var60.i;
+    /* shlw */
+    var62.i = var45.i << 2;
+    /* addw */
+    var63.i = var41.i + var62.i;
+    /* addw */
+    var64.i = var63.i + var49.i;
+    /* addw */
+    var65.i = var43.i + var47.i;
+    /* mullw */
+    var67.i = (var65.i * var66.i) & 0xffff;
+    /* subw */
+    var68.i = var64.i - var67.i;
+    /* absw */
+    var69.i = ORC_ABS (var68.i);
+    /* cmpgtsw */
+    var71.i = (var69.i > var70.i) ? (~0) : 0;
+    /* andw */
+    var72.i = var61.i & var71.i;
+    /* convwb */
+    var73 = var72.i;
+    /* storeb */
+    ptr0[i] = var73;
+  }
+
+}
+
+#else
+static void
+_backup_fieldanalysis_orc_comb_mask_5_tap (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_int8 var73;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+  ptr8 = (orc_int8 *) ex->arrays[8];
+
+  /* loadpw */
+  var52.i = ex->params[24];
+  /* loadpw */
+  var66.i = (int) 0x00000003;
+  /* loadpw */
+  var70.i = ex->params[25];
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* convubw */
+    var41.i = (orc_uint8) var40;
+    /* loadb */
+    var42 = ptr5[i];
+    /* convubw */
+    var43.i = (orc_uint8) var42;
+    /* loadb */
+    var44 = ptr6[i];
+    /* convubw */
+    var45.i = (orc_uint8) var44;
+    /* loadb */
+    var46 = ptr7[i];
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* loadb */
+    var48 = ptr8[i];
+    /* convubw */
+    var49.i = (orc_uint8) var48;
+    /* subw */
+    var50.i = var45.i - var43.i;
+    /* subw */
+    var51.i = var45.i - var47.i;
+    /* cmpgtsw */
+    var53.i = (var50.i > var52.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var54.i = (var51.i > var52.i) ? (~0) : 0;
+    /* andw */
+    var55.i = var53.i & var54.i;
+    /* subw */
+    var56.i = var43.i - var45.i;
+    /* subw */
+    var57.i = var47.i - var45.i;
+    /* cmpgtsw */
+    var58.i = (var56.i > var52.i) ? (~0) : 0;
+    /* cmpgtsw */
+    var59.i = (var57.i > var52.i) ? (~0) : 0;
+    /* andw */
+    var60.i = var58.i & var59.i;
+    /* orw */
+    var61.i = var55.i | var60.i;
+    /* shlw */
+    var62.i = var45.i << 2;
+    /* addw */
+    var63.i = var41.i + var62.i;
+    /* addw */
+    var64.i = var63.i + var49.i;
+    /* addw */
+    var65.i = var43.i + var47.i;
+    /* mullw */
+    var67.i = (var65.i * var66.i) & 0xffff;
+    /* subw */
+    var68.i = var64.i - var67.i;
+    /* absw */
+    var69.i = ORC_ABS (var68.i);
+    /* cmpgtsw */
+    var71.i = (var69.i > var70.i) ? (~0) : 0;
+    /* andw */
+    var72.i = var61.i & var71.i;
+    /* convwb */
+    var73 = var72.i;
+    /* storeb */
+    ptr0[i] = var73;
+  }
+
+}
+
+void
+fieldanalysis_orc_comb_mask_5_tap (orc_uint8 * ORC_RESTRICT d1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, const orc_uint8 * ORC_RESTRICT s4,
+    const orc_uint8 * ORC_RESTRICT s5, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "fieldanalysis_orc_comb_mask_5_tap");
+      orc_program_set_backup_function (p,
+          _backup_fieldanalysis_orc_comb_mask_5_tap);
+      orc_program_add_destination (p, 1, "d1");
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_source (p, 1, "s2");
+      orc_program_add_source (p, 1, "s3");
+      orc_program_add_source (p, 1, "s4");
+      orc_program_add_source (p, 1, "s5");
+      orc_program_add_constant (p, 4, 0x00000002, "c1");
+      orc_program_add_constant (p, 4, 0x00000003, "c2");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_parameter (p, 2, "p2");
+      orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 2, "t4");
+      orc_program_add_temporary (p, 2, "t5");
+      orc_program_add_temporary (p, 2, "t6");
+      orc_program_add_temporary (p, 2, "t7");
+      orc_program_add_temporary (p, 2, "t8");
+
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T3, ORC_VAR_T4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T8, ORC_VAR_T6, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T2, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_C1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T4,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_P2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 0, ORC_VAR_T8, ORC_VAR_T8, ORC_VAR_T1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T8, ORC_VAR_D1,
+          ORC_VAR_D1);
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* fieldanalysis_orc_comb_block_score */
+#ifdef DISABLE_ORC
+void
+fieldanalysis_orc_comb_block_score (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int n)
+{
+  int i;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_union32 var12 = { 0 };
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  /* loadpb */
+  var45 = (int) 0x00000001;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* loadb */
+    var41 = ptr5[i];
+    /* andb */
+    var42 = var40 & var41;
+    /* loadb */
+    var43 = ptr6[i];
+    /* andb */
+    var44 = var42 & var43;
+    /* andb */
+    var46 = var44 & var45;
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* convuwl */
+    var48.i = (orc_uint16) var47.i;
+    /* accl */
+    var12.i = var12.i + var48.i;
+  }
+  *a1 = var12.i;
+
+}
+
+#else
+static void
+_backup_fieldanalysis_orc_comb_block_score (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_union32 var12 = { 0 };
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  /* loadpb */
+  var45 = (int) 0x00000001;
+
+  for (i = 0; i < n; i++) {
+    /* loadb */
+    var40 = ptr4[i];
+    /* loadb */
+    var41 = ptr5[i];
+    /* andb */
+    var42 = var40 & var41;
+    /* loadb */
+    var43 = ptr6[i];
+    /* andb */
+    var44 = var42 & var43;
+    /* andb */
+    var46 = var44 & var45;
+    /* convubw */
+    var47.i = (orc_uint8) var46;
+    /* convuwl */
+    var48.i = (orc_uint16) var47.i;
+    /* accl */
+    var12.i = var12.i + var48.i;
+  }
+  ex->accumulators[0] = var12.i;
+
+}
+
+void
+fieldanalysis_orc_comb_block_score (guint32 * ORC_RESTRICT a1,
+    const orc_uint8 * ORC_RESTRICT s1, const orc_uint8 * ORC_RESTRICT s2,
+    const orc_uint8 * ORC_RESTRICT s3, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+      p = orc_program_new ();
+      orc_program_set_name (p, "fieldanalysis_orc_comb_block_score");
+      orc_program_set_backup_function (p,
+          _backup_fieldanalysis_orc_comb_block_score);
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_source (p, 1, "s2");
+      orc_program_add_source (p, 1, "s3");
+      orc_program_add_accumulator (p, 4, "a1");
+      orc_program_add_constant (p, 4, 0x00000001, "c1");
+      orc_program_add_temporary (p, 1, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 4, "t3");
+
+      orc_program_append_2 (p, "andb", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andb", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_S3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andb", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T3, ORC_VAR_T2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
+          ORC_VAR_D1);
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+
+  func = c->exec;
+  func (ex);
+  *a1 = orc_executor_get_accumulator (ex, ORC_VAR_A1);
+}
+#endif
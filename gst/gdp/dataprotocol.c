@@ -56,6 +56,12 @@
  * the event as the payload.  In addition, GDP streams can now start with
  * events as well, as required by the new data stream model in GStreamer 0.10.
  *
+ * Version 2.0 keeps the first three header bytes (major, minor, flags) so
+ * receivers can tell the versions apart, but encodes the rest of the header
+ * with variable length integers and leaves out unset buffer fields.  It adds
+ * packets carrying several buffers at once, and caps packets can carry an
+ * id so that caps seen before are later referred to by id only.
+ *
  * Converting buffers, caps and events to GDP buffers is done using a
  * #GstDPPacketizer object and invoking its packetizer functions.
  * For backwards-compatibility reasons, the old 0.2 methods are still
@@ -71,6 +77,8 @@
 #endif
 
 #include <gst/gst.h>
+#include <gst/base/gstbytereader.h>
+#include <gst/base/gstbytewriter.h>
 #include "dataprotocol.h"
 #include <glib/gprintf.h>       /* g_sprintf */
 #include <string.h>             /* strlen */
@@ -125,8 +133,23 @@ G_STMT_START {							\
 #define POLY       0x1021
 #define CRC_INIT   0xFFFF
 
+/* a parsed 2.0 header, see the VERSION 2.0 section */
+typedef struct
+{
+  guint8 flags;
+  guint type;
+  guint32 payload_length;
+  guint fields;                 /* offset of the type specific fields */
+  guint length;                 /* total header length */
+} GstDPHeader2;
+
 /*** HELPER FUNCTIONS ***/
 
+static void gst_dp_header_2_0_type_and_length (const guint8 * header,
+    guint * type, guint32 * payload_length);
+static gboolean gst_dp_parse_header_2_0 (const guint8 * data, guint size,
+    GstDPHeader2 * info);
+
 static gboolean
 gst_dp_header_from_buffer_any (const GstBuffer * buffer, GstDPHeaderFlag flags,
     guint * length, guint8 ** header, GstDPVersion version)
@@ -245,6 +268,18 @@ static const guint16 gst_dp_crc_table[256] = {
   0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
 };
 
+/* feed @length bytes into a running CRC register, so the CRC of data split
+ * over several memory blocks can be computed without joining them */
+static guint16
+gst_dp_crc_update (guint16 crc_register, const guint8 * buffer, guint length)
+{
+  for (; length--;) {
+    crc_register = (guint16) ((crc_register << 8) ^
+        gst_dp_crc_table[((crc_register >> 8) & 0x00ff) ^ *buffer++]);
+  }
+  return crc_register;
+}
+
 /**
  * gst_dp_crc:
  * @buffer: array of bytes
@@ -259,16 +294,9 @@ static const guint16 gst_dp_crc_table[256] = {
 guint16
 gst_dp_crc (const guint8 * buffer, guint length)
 {
-  guint16 crc_register = CRC_INIT;
-
   g_return_val_if_fail (buffer != NULL || length == 0, 0);
 
-  /* calc CRC */
-  for (; length--;) {
-    crc_register = (guint16) ((crc_register << 8) ^
-        gst_dp_crc_table[((crc_register >> 8) & 0x00ff) ^ *buffer++]);
-  }
-  return (0xffff ^ crc_register);
+  return (0xffff ^ gst_dp_crc_update (CRC_INIT, buffer, length));
 }
 
 GType
@@ -278,6 +306,7 @@ gst_dp_version_get_type (void)
   static const GEnumValue gst_dp_version[] = {
     {GST_DP_VERSION_0_2, "GST_DP_VERSION_0_2", "0.2"},
     {GST_DP_VERSION_1_0, "GST_DP_VERSION_1_0", "1.0"},
+    {GST_DP_VERSION_2_0, "GST_DP_VERSION_2_0", "2.0"},
     {0, NULL, NULL},
   };
 
@@ -326,6 +355,14 @@ gst_dp_header_payload_length (const guint8 * header)
 {
   g_return_val_if_fail (header != NULL, 0);
 
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    guint type;
+    guint32 length;
+
+    gst_dp_header_2_0_type_and_length (header, &type, &length);
+    return length;
+  }
+
   return GST_DP_HEADER_PAYLOAD_LENGTH (header);
 }
 
@@ -342,9 +379,520 @@ gst_dp_header_payload_type (const guint8 * header)
 {
   g_return_val_if_fail (header != NULL, GST_DP_PAYLOAD_NONE);
 
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    guint type;
+    guint32 length;
+
+    gst_dp_header_2_0_type_and_length (header, &type, &length);
+    return type;
+  }
+
   return GST_DP_HEADER_PAYLOAD_TYPE (header);
 }
 
+/**
+ * gst_dp_header_peek_length:
+ * @data: the start of a packet
+ * @size: the number of bytes available at @data
+ * @length: (out): the header length
+ *
+ * Works out the length of the packet header starting at @data.  Headers of
+ * versions before 2.0 are always #GST_DP_HEADER_LENGTH bytes, 2.0 headers
+ * vary in length.  If @size is too small to tell, @length is set to a lower
+ * bound larger than @size; call again once that many bytes are available.
+ *
+ * Returns: %FALSE if @data does not start a packet of a known version.
+ */
+gboolean
+gst_dp_header_peek_length (const guint8 * data, guint size, guint * length)
+{
+  GstDPHeader2 info;
+
+  g_return_val_if_fail (data != NULL || size == 0, FALSE);
+  g_return_val_if_fail (length != NULL, FALSE);
+
+  if (size == 0) {
+    *length = 1;
+    return TRUE;
+  }
+
+  switch (GST_DP_HEADER_MAJOR_VERSION (data)) {
+    case 0:
+    case 1:
+      *length = GST_DP_HEADER_LENGTH;
+      return TRUE;
+    case 2:
+      if (!gst_dp_parse_header_2_0 (data, size, &info))
+        return FALSE;
+      *length = info.length;
+      return TRUE;
+    default:
+      GST_WARNING ("Unknown GDP version %d",
+          GST_DP_HEADER_MAJOR_VERSION (data));
+      return FALSE;
+  }
+}
+
+/*** VERSION 2.0 ***/
+
+/* After the major, minor and flags bytes, a 2.0 header holds LEB128 varints:
+ *
+ *   payload type, payload length, type specific fields,
+ *   [header CRC, 2 bytes BE], [payload CRC, 2 bytes BE]
+ *
+ * The type specific fields are:
+ *
+ *   buffer:       record
+ *   buffer list:  n_buffers, n_buffers * (record, payload size)
+ *   caps:         caps id, 0 for none.  A caps packet with an id and an
+ *                 empty payload refers to caps sent earlier with that id
+ *   event:        record
+ *
+ * A record is a byte of GST_DP_RECORD_* bits saying which of timestamp,
+ * duration, offset and offset end are present, the buffer flags and then
+ * the present values.  The payload of caps and events is their string
+ * representation without the trailing 0.
+ */
+#define GST_DP_RECORD_TIMESTAMP  (1 << 0)
+#define GST_DP_RECORD_DURATION   (1 << 1)
+#define GST_DP_RECORD_OFFSET     (1 << 2)
+#define GST_DP_RECORD_OFFSET_END (1 << 3)
+
+#define GST_DP_2_0_MAX_BUFFERS   G_MAXUINT16
+
+static void
+gst_dp_write_varint (GstByteWriter * bw, guint64 val)
+{
+  do {
+    guint8 b = val & 0x7f;
+
+    val >>= 7;
+    if (val)
+      b |= 0x80;
+    gst_byte_writer_put_uint8 (bw, b);
+  } while (val);
+}
+
+/* returns FALSE if the data ends before the varint does; over-long
+ * encodings read as G_MAXUINT64 so range checks reject them */
+static gboolean
+gst_dp_read_varint (GstByteReader * br, guint64 * val)
+{
+  guint64 v = 0;
+  guint shift = 0;
+  guint8 b;
+
+  do {
+    if (!gst_byte_reader_get_uint8 (br, &b))
+      return FALSE;
+    if (shift < 64)
+      v |= ((guint64) (b & 0x7f)) << shift;
+    else
+      v = G_MAXUINT64;
+    shift += 7;
+  } while ((b & 0x80) && shift < 70);
+
+  *val = (b & 0x80) ? G_MAXUINT64 : v;
+  return TRUE;
+}
+
+static void
+gst_dp_write_record (GstByteWriter * bw, GstClockTime timestamp,
+    GstClockTime duration, guint64 offset, guint64 offset_end, guint flags)
+{
+  guint8 present = 0;
+
+  if (GST_CLOCK_TIME_IS_VALID (timestamp))
+    present |= GST_DP_RECORD_TIMESTAMP;
+  if (GST_CLOCK_TIME_IS_VALID (duration))
+    present |= GST_DP_RECORD_DURATION;
+  if (offset != GST_BUFFER_OFFSET_NONE)
+    present |= GST_DP_RECORD_OFFSET;
+  if (offset_end != GST_BUFFER_OFFSET_NONE)
+    present |= GST_DP_RECORD_OFFSET_END;
+
+  gst_byte_writer_put_uint8 (bw, present);
+  gst_dp_write_varint (bw, flags);
+  if (present & GST_DP_RECORD_TIMESTAMP)
+    gst_dp_write_varint (bw, timestamp);
+  if (present & GST_DP_RECORD_DURATION)
+    gst_dp_write_varint (bw, duration);
+  if (present & GST_DP_RECORD_OFFSET)
+    gst_dp_write_varint (bw, offset);
+  if (present & GST_DP_RECORD_OFFSET_END)
+    gst_dp_write_varint (bw, offset_end);
+}
+
+static gboolean
+gst_dp_read_record (GstByteReader * br, GstClockTime * timestamp,
+    GstClockTime * duration, guint64 * offset, guint64 * offset_end,
+    guint * flags)
+{
+  guint8 present;
+  guint64 v;
+
+  *timestamp = *duration = GST_CLOCK_TIME_NONE;
+  *offset = *offset_end = GST_BUFFER_OFFSET_NONE;
+
+  if (!gst_byte_reader_get_uint8 (br, &present))
+    return FALSE;
+  if (!gst_dp_read_varint (br, &v))
+    return FALSE;
+  *flags = (guint) MIN (v, G_MAXUINT16);
+  if ((present & GST_DP_RECORD_TIMESTAMP) && !gst_dp_read_varint (br,
+          timestamp))
+    return FALSE;
+  if ((present & GST_DP_RECORD_DURATION) && !gst_dp_read_varint (br, duration))
+    return FALSE;
+  if ((present & GST_DP_RECORD_OFFSET) && !gst_dp_read_varint (br, offset))
+    return FALSE;
+  if ((present & GST_DP_RECORD_OFFSET_END) && !gst_dp_read_varint (br,
+          offset_end))
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+gst_dp_write_buffer_record (GstByteWriter * bw, const GstBuffer * buffer)
+{
+  /* we copy everything but the read-only flags */
+  guint flags_mask = GST_BUFFER_FLAG_LIVE | GST_BUFFER_FLAG_DISCONT |
+      GST_BUFFER_FLAG_HEADER | GST_BUFFER_FLAG_GAP | GST_BUFFER_FLAG_DELTA_UNIT;
+
+  gst_dp_write_record (bw, GST_BUFFER_TIMESTAMP (buffer),
+      GST_BUFFER_DURATION (buffer), GST_BUFFER_OFFSET (buffer),
+      GST_BUFFER_OFFSET_END (buffer), GST_BUFFER_FLAGS (buffer) & flags_mask);
+}
+
+static gboolean
+gst_dp_read_buffer_record (GstByteReader * br, GstBuffer * buffer)
+{
+  GstClockTime timestamp, duration;
+  guint64 offset, offset_end;
+  guint flags;
+
+  if (!gst_dp_read_record (br, &timestamp, &duration, &offset, &offset_end,
+          &flags))
+    return FALSE;
+
+  GST_BUFFER_TIMESTAMP (buffer) = timestamp;
+  GST_BUFFER_DURATION (buffer) = duration;
+  GST_BUFFER_OFFSET (buffer) = offset;
+  GST_BUFFER_OFFSET_END (buffer) = offset_end;
+  GST_BUFFER_FLAGS (buffer) = flags;
+
+  return TRUE;
+}
+
+static void
+gst_dp_init_header_2_0 (GstByteWriter * bw, GstDPHeaderFlag flags,
+    guint type, guint32 payload_length)
+{
+  gst_byte_writer_init_with_size (bw, 32, FALSE);
+  gst_byte_writer_put_uint8 (bw, 2);
+  gst_byte_writer_put_uint8 (bw, 0);
+  gst_byte_writer_put_uint8 (bw, (guint8) flags);
+  gst_dp_write_varint (bw, type);
+  gst_dp_write_varint (bw, payload_length);
+}
+
+/* appends the CRC fields and hands out the header data */
+static guint8 *
+gst_dp_finish_header_2_0 (GstByteWriter * bw, GstDPHeaderFlag flags,
+    guint16 payload_crc, guint * length)
+{
+  guint8 *h;
+
+  /* the header CRC covers everything before the CRC fields */
+  if (flags & GST_DP_HEADER_FLAG_CRC_HEADER) {
+    gst_byte_writer_put_uint16_be (bw, gst_dp_crc (bw->parent.data,
+            gst_byte_writer_get_size (bw)));
+  }
+  if (flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)
+    gst_byte_writer_put_uint16_be (bw, payload_crc);
+
+  *length = gst_byte_writer_get_size (bw);
+  h = gst_byte_writer_reset_and_get_data (bw);
+
+  return h;
+}
+
+/* Parses the 2.0 header at the start of @data.  Returns FALSE if it is not a
+ * valid header.  If @size is too small to tell, @info->length is set to a
+ * lower bound of the header length larger than @size. */
+static gboolean
+gst_dp_parse_header_2_0 (const guint8 * data, guint size, GstDPHeader2 * info)
+{
+  GstByteReader br;
+  guint64 type, length, n, val, total;
+  guint i, crc_size;
+
+  memset (info, 0, sizeof (GstDPHeader2));
+
+  if (size < 3)
+    goto need_more;
+  if (GST_DP_HEADER_MAJOR_VERSION (data) != 2)
+    return FALSE;
+
+  gst_byte_reader_init (&br, data, size);
+  gst_byte_reader_skip_unchecked (&br, 3);
+  info->flags = GST_DP_HEADER_FLAGS (data);
+
+  if (!gst_dp_read_varint (&br, &type) || !gst_dp_read_varint (&br, &length))
+    goto need_more;
+  if (type > G_MAXUINT16 || length > G_MAXUINT32)
+    return FALSE;
+  info->type = type;
+  info->payload_length = length;
+  info->fields = gst_byte_reader_get_pos (&br);
+
+  switch (type) {
+    case GST_DP_PAYLOAD_BUFFER:
+      if (!gst_dp_read_record (&br, &val, &val, &val, &val, &i))
+        goto need_more;
+      break;
+    case GST_DP_PAYLOAD_BUFFER_LIST:
+      if (!gst_dp_read_varint (&br, &n))
+        goto need_more;
+      if (n == 0 || n > GST_DP_2_0_MAX_BUFFERS)
+        return FALSE;
+      total = 0;
+      for (; n > 0; n--) {
+        if (!gst_dp_read_record (&br, &val, &val, &val, &val, &i))
+          goto need_more;
+        if (!gst_dp_read_varint (&br, &val))
+          goto need_more;
+        total += MIN (val, G_MAXUINT32);
+      }
+      if (total != length)
+        return FALSE;
+      break;
+    case GST_DP_PAYLOAD_CAPS:
+      if (!gst_dp_read_varint (&br, &val))
+        goto need_more;
+      if (val > G_MAXUINT)
+        return FALSE;
+      break;
+    default:
+      if (type < GST_DP_PAYLOAD_EVENT_NONE)
+        return FALSE;
+      if (!gst_dp_read_record (&br, &val, &val, &val, &val, &i))
+        goto need_more;
+      break;
+  }
+
+  crc_size = 0;
+  if (info->flags & GST_DP_HEADER_FLAG_CRC_HEADER)
+    crc_size += 2;
+  if (info->flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)
+    crc_size += 2;
+  info->length = gst_byte_reader_get_pos (&br) + crc_size;
+
+  return TRUE;
+
+need_more:
+  info->length = size + 1;
+  return TRUE;
+}
+
+/* for a header that passed validation */
+static void
+gst_dp_header_2_0_type_and_length (const guint8 * header, guint * type,
+    guint32 * payload_length)
+{
+  GstByteReader br;
+  guint64 v = 0;
+
+  /* the varints end inside a valid header, the size only bounds the read */
+  gst_byte_reader_init (&br, header + 3, 20);
+  gst_dp_read_varint (&br, &v);
+  *type = (guint) v;
+  v = 0;
+  gst_dp_read_varint (&br, &v);
+  *payload_length = (guint32) v;
+}
+
+static guint16
+gst_dp_crc_buffer (guint16 crc_register, const GstBuffer * buffer)
+{
+  GstMapInfo map;
+
+  gst_buffer_map ((GstBuffer *) buffer, &map, GST_MAP_READ);
+  crc_register = gst_dp_crc_update (crc_register, map.data, map.size);
+  gst_buffer_unmap ((GstBuffer *) buffer, &map);
+
+  return crc_register;
+}
+
+static gboolean
+gst_dp_header_from_buffer_2_0 (const GstBuffer * buffer, GstDPHeaderFlag flags,
+    guint * length, guint8 ** header)
+{
+  return gst_dp_header_from_buffers ((GstBuffer **) & buffer, 1, flags, length,
+      header);
+}
+
+static gboolean
+gst_dp_packet_from_caps_2_0 (const GstCaps * caps, GstDPHeaderFlag flags,
+    guint * length, guint8 ** header, guint8 ** payload)
+{
+  return gst_dp_packet_from_caps_with_id (caps, 0, flags, length, header,
+      payload);
+}
+
+static gboolean
+gst_dp_packet_from_event_2_0 (const GstEvent * event, GstDPHeaderFlag flags,
+    guint * length, guint8 ** header, guint8 ** payload)
+{
+  GstByteWriter bw;
+  const GstStructure *structure;
+  gchar *string = NULL;
+  guint32 pl_length = 0;
+  guint16 crc = 0;
+
+  g_return_val_if_fail (GST_IS_EVENT (event), FALSE);
+  g_return_val_if_fail (length, FALSE);
+  g_return_val_if_fail (header, FALSE);
+  g_return_val_if_fail (payload, FALSE);
+
+  structure = gst_event_get_structure ((GstEvent *) event);
+  if (structure) {
+    string = gst_structure_to_string (structure);
+    pl_length = strlen (string);
+  }
+
+  gst_dp_init_header_2_0 (&bw, flags,
+      GST_DP_PAYLOAD_EVENT_NONE + GST_EVENT_TYPE (event), pl_length);
+  gst_dp_write_record (&bw, GST_EVENT_TIMESTAMP (event), GST_CLOCK_TIME_NONE,
+      GST_BUFFER_OFFSET_NONE, GST_BUFFER_OFFSET_NONE, 0);
+
+  if (pl_length && (flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    crc = gst_dp_crc ((guint8 *) string, pl_length);
+  *header = gst_dp_finish_header_2_0 (&bw, flags, crc, length);
+
+  if (pl_length == 0) {
+    g_free (string);
+    string = NULL;
+  }
+  *payload = (guint8 *) string;
+
+  GST_MEMDUMP ("created 2.0 header from event", *header, *length);
+  return TRUE;
+}
+
+/**
+ * gst_dp_header_from_buffers:
+ * @buffers: (array length=n_buffers): the buffers to make a header for
+ * @n_buffers: the number of buffers, at least one
+ * @flags: the #GstDPHeaderFlag to create the header with
+ * @length: (out): the length of the returned header
+ * @header: (out): the returned header
+ *
+ * Creates a version 2.0 header for a packet carrying all @buffers; the
+ * packet payload is the data of the buffers one after the other.  A single
+ * buffer gives a plain buffer packet.
+ *
+ * Returns: %TRUE if the header was successfully created.
+ */
+gboolean
+gst_dp_header_from_buffers (GstBuffer ** buffers, guint n_buffers,
+    GstDPHeaderFlag flags, guint * length, guint8 ** header)
+{
+  GstByteWriter bw;
+  guint64 payload_length = 0;
+  guint16 crc = CRC_INIT;
+  guint i;
+
+  g_return_val_if_fail (buffers != NULL, FALSE);
+  g_return_val_if_fail (n_buffers > 0 && n_buffers <= GST_DP_2_0_MAX_BUFFERS,
+      FALSE);
+  g_return_val_if_fail (length, FALSE);
+  g_return_val_if_fail (header, FALSE);
+
+  for (i = 0; i < n_buffers; i++) {
+    g_return_val_if_fail (GST_IS_BUFFER (buffers[i]), FALSE);
+    payload_length += gst_buffer_get_size (buffers[i]);
+  }
+  if (payload_length > G_MAXUINT32)
+    return FALSE;
+
+  if (n_buffers == 1) {
+    gst_dp_init_header_2_0 (&bw, flags, GST_DP_PAYLOAD_BUFFER, payload_length);
+    gst_dp_write_buffer_record (&bw, buffers[0]);
+  } else {
+    gst_dp_init_header_2_0 (&bw, flags, GST_DP_PAYLOAD_BUFFER_LIST,
+        payload_length);
+    gst_dp_write_varint (&bw, n_buffers);
+    for (i = 0; i < n_buffers; i++) {
+      gst_dp_write_buffer_record (&bw, buffers[i]);
+      gst_dp_write_varint (&bw, gst_buffer_get_size (buffers[i]));
+    }
+  }
+
+  if (payload_length && (flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)) {
+    for (i = 0; i < n_buffers; i++)
+      crc = gst_dp_crc_buffer (crc, buffers[i]);
+  }
+  *header = gst_dp_finish_header_2_0 (&bw, flags, 0xffff ^ crc, length);
+
+  GST_MEMDUMP ("created 2.0 header from buffers", *header, *length);
+  return TRUE;
+}
+
+/**
+ * gst_dp_packet_from_caps_with_id:
+ * @caps: (allow-none): the #GstCaps to create a packet for, or NULL
+ * @id: the id to give the caps, at most %GST_DP_MAX_CAPS_IDS, or 0 for none
+ * @flags: the #GstDPHeaderFlag to create the header with
+ * @length: (out): the length of the returned header
+ * @header: (out): the returned header
+ * @payload: (out): the returned payload, NULL if there is none
+ *
+ * Creates a version 2.0 caps packet.  A packet with an @id lets the
+ * receiver remember the caps; later packets with the same @id and NULL
+ * @caps refer to them without repeating the caps.
+ *
+ * Returns: %TRUE if the packet was successfully created.
+ */
+gboolean
+gst_dp_packet_from_caps_with_id (const GstCaps * caps, guint id,
+    GstDPHeaderFlag flags, guint * length, guint8 ** header,
+    guint8 ** payload)
+{
+  GstByteWriter bw;
+  gchar *string = NULL;
+  guint32 payload_length = 0;
+  guint16 crc = 0;
+
+  g_return_val_if_fail (caps == NULL || GST_IS_CAPS (caps), FALSE);
+  g_return_val_if_fail (caps != NULL || id != 0, FALSE);
+  g_return_val_if_fail (length, FALSE);
+  g_return_val_if_fail (header, FALSE);
+  g_return_val_if_fail (payload, FALSE);
+
+  if (caps) {
+    string = gst_caps_to_string (caps);
+    payload_length = strlen (string);
+  }
+
+  gst_dp_init_header_2_0 (&bw, flags, GST_DP_PAYLOAD_CAPS, payload_length);
+  gst_dp_write_varint (&bw, id);
+
+  if (payload_length && (flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    crc = gst_dp_crc ((guint8 *) string, payload_length);
+  *header = gst_dp_finish_header_2_0 (&bw, flags, crc, length);
+
+  if (payload_length == 0) {
+    g_free (string);
+    string = NULL;
+  }
+  *payload = (guint8 *) string;
+
+  GST_MEMDUMP ("created 2.0 header from caps", *header, *length);
+  return TRUE;
+}
+
 /*** PACKETIZER FUNCTIONS ***/
 
 static gboolean
@@ -409,6 +957,23 @@ gst_dp_packet_from_event_1_0 (const GstEvent * event, GstDPHeaderFlag flags,
 
 /*** DEPACKETIZING FUNCTIONS ***/
 
+static gboolean
+gst_dp_buffer_from_header_2_0 (guint header_length, const guint8 * header,
+    GstBuffer * buffer)
+{
+  GstByteReader br;
+  GstDPHeader2 info;
+
+  if (!gst_dp_parse_header_2_0 (header, header_length, &info) ||
+      info.length > header_length || info.type != GST_DP_PAYLOAD_BUFFER)
+    return FALSE;
+
+  gst_byte_reader_init (&br, header, header_length);
+  gst_byte_reader_skip_unchecked (&br, info.fields);
+
+  return gst_dp_read_buffer_record (&br, buffer);
+}
+
 /**
  * gst_dp_buffer_from_header:
  * @header_length: the length of the packet header
@@ -431,6 +996,17 @@ gst_dp_buffer_from_header (guint header_length, const guint8 * header)
   GstBuffer *buffer;
 
   g_return_val_if_fail (header != NULL, NULL);
+
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    buffer = gst_buffer_new_allocate (NULL,
+        gst_dp_header_payload_length (header), NULL);
+    if (!gst_dp_buffer_from_header_2_0 (header_length, header, buffer)) {
+      gst_buffer_unref (buffer);
+      return NULL;
+    }
+    return buffer;
+  }
+
   g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
   g_return_val_if_fail (GST_DP_HEADER_PAYLOAD_TYPE (header) ==
       GST_DP_PAYLOAD_BUFFER, NULL);
@@ -448,6 +1024,168 @@ gst_dp_buffer_from_header (guint header_length, const guint8 * header)
   return buffer;
 }
 
+/**
+ * gst_dp_buffer_from_header_and_payload:
+ * @header_length: the length of the packet header
+ * @header: the byte array of the packet header
+ * @payload: (transfer full) (allow-none): a #GstBuffer with the packet
+ *     payload, or NULL if the packet has no payload
+ *
+ * Creates a #GstBuffer from the given header that uses the memory of
+ * @payload, for example a sub-buffer taken from an adapter, so the payload
+ * data does not need to be copied.
+ *
+ * This function does not check the header passed to it, use
+ * gst_dp_validate_header() first if the header data is unchecked.
+ *
+ * Returns: A #GstBuffer if the buffer was successfully created, or NULL.
+ */
+GstBuffer *
+gst_dp_buffer_from_header_and_payload (guint header_length,
+    const guint8 * header, GstBuffer * payload)
+{
+  GstBuffer *buffer;
+
+  g_return_val_if_fail (header != NULL, NULL);
+
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    g_return_val_if_fail (payload == NULL ||
+        gst_buffer_get_size (payload) == gst_dp_header_payload_length (header),
+        NULL);
+
+    buffer = payload ? gst_buffer_make_writable (payload) : gst_buffer_new ();
+    if (!gst_dp_buffer_from_header_2_0 (header_length, header, buffer)) {
+      gst_buffer_unref (buffer);
+      return NULL;
+    }
+    return buffer;
+  }
+
+  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
+  g_return_val_if_fail (GST_DP_HEADER_PAYLOAD_TYPE (header) ==
+      GST_DP_PAYLOAD_BUFFER, NULL);
+  g_return_val_if_fail (payload == NULL ||
+      gst_buffer_get_size (payload) == GST_DP_HEADER_PAYLOAD_LENGTH (header),
+      NULL);
+
+  if (payload)
+    buffer = gst_buffer_make_writable (payload);
+  else
+    buffer = gst_buffer_new ();
+
+  GST_BUFFER_TIMESTAMP (buffer) = GST_DP_HEADER_TIMESTAMP (header);
+  GST_BUFFER_DURATION (buffer) = GST_DP_HEADER_DURATION (header);
+  GST_BUFFER_OFFSET (buffer) = GST_DP_HEADER_OFFSET (header);
+  GST_BUFFER_OFFSET_END (buffer) = GST_DP_HEADER_OFFSET_END (header);
+  GST_BUFFER_FLAGS (buffer) = GST_DP_HEADER_BUFFER_FLAGS (header);
+
+  return buffer;
+}
+
+/**
+ * gst_dp_buffer_list_from_header_and_payload:
+ * @header_length: the length of the packet header
+ * @header: the byte array of the packet header
+ * @payload: (transfer full) (allow-none): a #GstBuffer with the packet
+ *     payload, or NULL if it is empty
+ *
+ * Splits the payload of a version 2.0 buffer list packet into the buffers
+ * described by @header.  The buffers are sub-buffers of @payload, no data
+ * is copied.
+ *
+ * This function does not check the header passed to it, use
+ * gst_dp_validate_header() first if the header data is unchecked.
+ *
+ * Returns: A #GstBufferList if the buffers were successfully created, or
+ *          NULL.
+ */
+GstBufferList *
+gst_dp_buffer_list_from_header_and_payload (guint header_length,
+    const guint8 * header, GstBuffer * payload)
+{
+  GstBufferList *list;
+  GstByteReader br;
+  GstDPHeader2 info;
+  guint64 n, size;
+  gsize offset = 0;
+
+  g_return_val_if_fail (header != NULL, NULL);
+  g_return_val_if_fail (payload == NULL || GST_IS_BUFFER (payload), NULL);
+
+  if (!gst_dp_parse_header_2_0 (header, header_length, &info) ||
+      info.length > header_length || info.type != GST_DP_PAYLOAD_BUFFER_LIST ||
+      (payload ? gst_buffer_get_size (payload) : 0) != info.payload_length)
+    goto invalid;
+
+  gst_byte_reader_init (&br, header, header_length);
+  gst_byte_reader_skip_unchecked (&br, info.fields);
+  if (!gst_dp_read_varint (&br, &n))
+    goto invalid;
+
+  list = gst_buffer_list_new_sized (n);
+  for (; n > 0; n--) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    if (!gst_dp_read_buffer_record (&br, buffer) ||
+        !gst_dp_read_varint (&br, &size)) {
+      gst_buffer_unref (buffer);
+      gst_buffer_list_unref (list);
+      goto invalid;
+    }
+    if (size > 0)
+      gst_buffer_copy_into (buffer, payload, GST_BUFFER_COPY_MEMORY, offset,
+          size);
+    offset += size;
+    gst_buffer_list_add (list, buffer);
+  }
+  if (payload)
+    gst_buffer_unref (payload);
+
+  return list;
+
+invalid:
+  {
+    GST_WARNING ("invalid GDP buffer list header");
+    if (payload)
+      gst_buffer_unref (payload);
+    return NULL;
+  }
+}
+
+/**
+ * gst_dp_header_caps_id:
+ * @header_length: the length of the packet header
+ * @header: the byte array of the packet header
+ *
+ * Gets the caps id of a version 2.0 caps packet.  A packet with an id and
+ * no payload refers to the caps of an earlier packet with the same id.
+ *
+ * Returns: the caps id, or 0 if the packet has none.
+ */
+guint
+gst_dp_header_caps_id (guint header_length, const guint8 * header)
+{
+  GstByteReader br;
+  GstDPHeader2 info;
+  guint64 id;
+
+  g_return_val_if_fail (header != NULL, 0);
+
+  if (GST_DP_HEADER_MAJOR_VERSION (header) != 2)
+    return 0;
+
+  if (!gst_dp_parse_header_2_0 (header, header_length, &info) ||
+      info.length > header_length || info.type != GST_DP_PAYLOAD_CAPS)
+    return 0;
+
+  gst_byte_reader_init (&br, header, header_length);
+  gst_byte_reader_skip_unchecked (&br, info.fields);
+  if (!gst_dp_read_varint (&br, &id))
+    return 0;
+
+  return (guint) id;
+}
+
 /**
  * gst_dp_caps_from_packet:
  * @header_length: the length of the packet header
@@ -471,6 +1209,20 @@ gst_dp_caps_from_packet (guint header_length, const guint8 * header,
   gchar *string;
 
   g_return_val_if_fail (header, NULL);
+
+  /* 2.0 caps references have no payload, they give no caps here */
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    guint32 length = gst_dp_header_payload_length (header);
+
+    if (length == 0 || payload == NULL)
+      return NULL;
+    string = g_strndup ((gchar *) payload, length);
+    caps = gst_caps_from_string (string);
+    g_free (string);
+
+    return caps;
+  }
+
   g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
   g_return_val_if_fail (GST_DP_HEADER_PAYLOAD_TYPE (header) ==
       GST_DP_PAYLOAD_CAPS, NULL);
@@ -562,6 +1314,41 @@ gst_dp_event_from_packet_1_0 (guint header_length, const guint8 * header,
   return event;
 }
 
+static GstEvent *
+gst_dp_event_from_packet_2_0 (guint header_length, const guint8 * header,
+    const guint8 * payload)
+{
+  GstEvent *event;
+  GstByteReader br;
+  GstDPHeader2 info;
+  GstClockTime timestamp, duration;
+  guint64 offset, offset_end;
+  guint flags;
+  GstStructure *s = NULL;
+
+  if (!gst_dp_parse_header_2_0 (header, header_length, &info) ||
+      info.length > header_length || info.type < GST_DP_PAYLOAD_EVENT_NONE)
+    return NULL;
+
+  gst_byte_reader_init (&br, header, header_length);
+  gst_byte_reader_skip_unchecked (&br, info.fields);
+  if (!gst_dp_read_record (&br, &timestamp, &duration, &offset, &offset_end,
+          &flags))
+    return NULL;
+
+  if (payload && info.payload_length) {
+    gchar *string = g_strndup ((gchar *) payload, info.payload_length);
+
+    s = gst_structure_from_string (string, NULL);
+    g_free (string);
+  }
+  GST_LOG ("Creating event of type 0x%x with structure '%" GST_PTR_FORMAT "'",
+      info.type - GST_DP_PAYLOAD_EVENT_NONE, s);
+  event = gst_event_new_custom (info.type - GST_DP_PAYLOAD_EVENT_NONE, s);
+  GST_EVENT_TIMESTAMP (event) = timestamp;
+
+  return event;
+}
 
 /**
  * gst_dp_event_from_packet:
@@ -585,11 +1372,15 @@ gst_dp_event_from_packet (guint header_length, const guint8 * header,
   guint8 major, minor;
 
   g_return_val_if_fail (header, NULL);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
 
   major = GST_DP_HEADER_MAJOR_VERSION (header);
   minor = GST_DP_HEADER_MINOR_VERSION (header);
 
+  if (major == 2)
+    return gst_dp_event_from_packet_2_0 (header_length, header, payload);
+
+  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
+
   if (major == 0 && minor == 2)
     return gst_dp_event_from_packet_0_2 (header_length, header, payload);
   else if (major == 1 && minor == 0)
@@ -615,15 +1406,35 @@ gst_dp_validate_header (guint header_length, const guint8 * header)
   guint16 crc_read, crc_calculated;
 
   g_return_val_if_fail (header != NULL, FALSE);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
 
-  if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_HEADER))
-    return TRUE;
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    GstDPHeader2 info;
+    guint crc_pos;
+
+    if (!gst_dp_parse_header_2_0 (header, header_length, &info) ||
+        info.length != header_length)
+      goto invalid_header;
+
+    if (!(info.flags & GST_DP_HEADER_FLAG_CRC_HEADER))
+      return TRUE;
+
+    /* the header CRC comes first, the payload CRC may follow it */
+    crc_pos = header_length - 2;
+    if (info.flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)
+      crc_pos -= 2;
+    crc_read = GST_READ_UINT16_BE (header + crc_pos);
+    crc_calculated = gst_dp_crc (header, crc_pos);
+  } else {
+    g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
+
+    if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_HEADER))
+      return TRUE;
 
-  crc_read = GST_DP_HEADER_CRC_HEADER (header);
+    crc_read = GST_DP_HEADER_CRC_HEADER (header);
 
-  /* don't include the last two crc fields for the crc check */
-  crc_calculated = gst_dp_crc (header, header_length - 4);
+    /* don't include the last two crc fields for the crc check */
+    crc_calculated = gst_dp_crc (header, header_length - 4);
+  }
   if (crc_read != crc_calculated)
     goto crc_error;
 
@@ -637,6 +1448,11 @@ crc_error:
         crc_calculated);
     return FALSE;
   }
+invalid_header:
+  {
+    GST_WARNING ("invalid 2.0 header");
+    return FALSE;
+  }
 }
 
 /**
@@ -657,13 +1473,25 @@ gst_dp_validate_payload (guint header_length, const guint8 * header,
   guint16 crc_read, crc_calculated;
 
   g_return_val_if_fail (header != NULL, FALSE);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
 
-  if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
-    return TRUE;
+  if (GST_DP_HEADER_MAJOR_VERSION (header) == 2) {
+    if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+      return TRUE;
 
-  crc_read = GST_DP_HEADER_CRC_PAYLOAD (header);
-  crc_calculated = gst_dp_crc (payload, GST_DP_HEADER_PAYLOAD_LENGTH (header));
+    /* the payload CRC is always last */
+    crc_read = GST_READ_UINT16_BE (header + header_length - 2);
+    crc_calculated = gst_dp_crc (payload,
+        gst_dp_header_payload_length (header));
+  } else {
+    g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
+
+    if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+      return TRUE;
+
+    crc_read = GST_DP_HEADER_CRC_PAYLOAD (header);
+    crc_calculated =
+        gst_dp_crc (payload, GST_DP_HEADER_PAYLOAD_LENGTH (header));
+  }
   if (crc_read != crc_calculated)
     goto crc_error;
 
@@ -723,6 +1551,11 @@ gst_dp_packetizer_new (GstDPVersion version)
       ret->packet_from_caps = gst_dp_packet_from_caps_1_0;
       ret->packet_from_event = gst_dp_packet_from_event_1_0;
       break;
+    case GST_DP_VERSION_2_0:
+      ret->header_from_buffer = gst_dp_header_from_buffer_2_0;
+      ret->packet_from_caps = gst_dp_packet_from_caps_2_0;
+      ret->packet_from_event = gst_dp_packet_from_event_2_0;
+      break;
     default:
       g_free (ret);
       ret = NULL;
@@ -26,6 +26,7 @@
 #include <gst/gstbuffer.h>
 #include <gst/gstevent.h>
 #include <gst/gstcaps.h>
+#include <gst/gstbufferlist.h>
 
 G_BEGIN_DECLS
 
@@ -33,12 +34,15 @@ G_BEGIN_DECLS
  * GstDPVersion:
  * @GST_DP_VERSION_0_2: protocol version 0.2
  * @GST_DP_VERSION_1_0: protocol version 1.0
+ * @GST_DP_VERSION_2_0: protocol version 2.0, with compact headers, buffer
+ *     lists and caps ids
  *
  * The version of the GDP protocol being used.
  */
 typedef enum {
   GST_DP_VERSION_0_2 = 1,
   GST_DP_VERSION_1_0,
+  GST_DP_VERSION_2_0,
 } GstDPVersion;
 
 GType gst_dp_version_get_type (void);
@@ -60,10 +64,18 @@ GType gst_dp_version_get_type (void);
 /**
  * GST_DP_HEADER_LENGTH:
  *
- * The header size in bytes.
+ * The header size in bytes for versions before 2.0.  Version 2.0 headers
+ * have a variable length, see gst_dp_header_peek_length().
  */
 #define GST_DP_HEADER_LENGTH 62
 
+/**
+ * GST_DP_MAX_CAPS_IDS:
+ *
+ * The highest id a version 2.0 caps packet can carry.
+ */
+#define GST_DP_MAX_CAPS_IDS 16
+
 /**
  * GstDPHeaderFlag:
  * @GST_DP_HEADER_FLAG_NONE: No flag present.
@@ -85,6 +97,7 @@ typedef enum {
  * @GST_DP_PAYLOAD_NONE: Invalid payload type.
  * @GST_DP_PAYLOAD_BUFFER: #GstBuffer payload packet.
  * @GST_DP_PAYLOAD_CAPS: #GstCaps payload packet.
+ * @GST_DP_PAYLOAD_BUFFER_LIST: several #GstBuffer in one packet (2.0 only).
  * @GST_DP_PAYLOAD_EVENT_NONE: First value of #GstEvent payload packets.
  *
  * The GDP payload types. a #GstEvent payload type is encoded with the
@@ -94,6 +107,7 @@ typedef enum {
   GST_DP_PAYLOAD_NONE            = 0,
   GST_DP_PAYLOAD_BUFFER,
   GST_DP_PAYLOAD_CAPS,
+  GST_DP_PAYLOAD_BUFFER_LIST,
   GST_DP_PAYLOAD_EVENT_NONE      = 64,
 } GstDPPayloadType;
 
@@ -148,10 +162,34 @@ guint16         gst_dp_crc                      (const guint8 * buffer,
 guint32         gst_dp_header_payload_length    (const guint8 * header);
 GstDPPayloadType
                 gst_dp_header_payload_type      (const guint8 * header);
+gboolean        gst_dp_header_peek_length       (const guint8 * data,
+                                                 guint size,
+                                                 guint * length);
+guint           gst_dp_header_caps_id           (guint header_length,
+                                                 const guint8 * header);
+
+/* version 2.0 packets */
+gboolean        gst_dp_header_from_buffers      (GstBuffer ** buffers,
+                                                 guint n_buffers,
+                                                 GstDPHeaderFlag flags,
+                                                 guint * length,
+                                                 guint8 ** header);
+gboolean        gst_dp_packet_from_caps_with_id (const GstCaps * caps,
+                                                 guint id,
+                                                 GstDPHeaderFlag flags,
+                                                 guint * length,
+                                                 guint8 ** header,
+                                                 guint8 ** payload);
 
 /* converting to GstBuffer/GstEvent/GstCaps */
 GstBuffer *     gst_dp_buffer_from_header       (guint header_length,
                                                 const guint8 * header);
+GstBuffer *     gst_dp_buffer_from_header_and_payload (guint header_length,
+                                                const guint8 * header,
+                                                GstBuffer * payload);
+GstBufferList * gst_dp_buffer_list_from_header_and_payload (guint header_length,
+                                                const guint8 * header,
+                                                GstBuffer * payload);
 GstCaps *       gst_dp_caps_from_packet         (guint header_length,
                                                 const guint8 * header,
                                                 const guint8 * payload);
@@ -126,6 +126,8 @@ gst_gdp_depay_init (GstGDPDepay * gdpdepay)
   gst_element_add_pad (GST_ELEMENT (gdpdepay), gdpdepay->srcpad);
 
   gdpdepay->adapter = gst_adapter_new ();
+  gdpdepay->caps_table = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_caps_unref);
 }
 
 static void
@@ -139,6 +141,7 @@ gst_gdp_depay_finalize (GObject * gobject)
   g_free (this->header);
   gst_adapter_clear (this->adapter);
   g_object_unref (this->adapter);
+  g_hash_table_destroy (this->caps_table);
 
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (gobject));
 }
@@ -229,16 +232,35 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       case GST_GDP_DEPAY_STATE_HEADER:
       {
         guint8 *header;
+        const guint8 *data;
+        guint header_length, size;
+        gboolean res;
 
         /* collect a complete header, validate and store the header. Figure out
-         * the payload length and switch to the PAYLOAD state */
+         * the payload length and switch to the PAYLOAD state. 2.0 headers
+         * vary in length, peek until we know how long this one is */
         available = gst_adapter_available (this->adapter);
-        if (available < GST_DP_HEADER_LENGTH)
+        if (available == 0)
           goto done;
 
-        GST_LOG_OBJECT (this, "reading GDP header from adapter");
-        header = gst_adapter_take (this->adapter, GST_DP_HEADER_LENGTH);
-        if (!gst_dp_validate_header (GST_DP_HEADER_LENGTH, header)) {
+        header_length = 0;
+        do {
+          size = MIN (available, MAX (header_length, GST_DP_HEADER_LENGTH));
+
+          data = gst_adapter_map (this->adapter, size);
+          res = gst_dp_header_peek_length (data, size, &header_length);
+          gst_adapter_unmap (this->adapter);
+
+          if (!res)
+            goto header_validate_error;
+          if (header_length > available)
+            goto done;
+        } while (header_length > size);
+
+        GST_LOG_OBJECT (this, "reading GDP header of %u bytes from adapter",
+            header_length);
+        header = gst_adapter_take (this->adapter, header_length);
+        if (!gst_dp_validate_header (header_length, header)) {
           g_free (header);
           goto header_validate_error;
         }
@@ -250,6 +272,7 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         /* free previous header and store new one. */
         g_free (this->header);
         this->header = header;
+        this->header_length = header_length;
 
         GST_LOG_OBJECT (this,
             "read GDP header, payload size %d, payload type %d, switching to state PAYLOAD",
@@ -267,7 +290,8 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           goto done;
 
         /* change state based on type */
-        if (this->payload_type == GST_DP_PAYLOAD_BUFFER) {
+        if (this->payload_type == GST_DP_PAYLOAD_BUFFER ||
+            this->payload_type == GST_DP_PAYLOAD_BUFFER_LIST) {
           GST_LOG_OBJECT (this, "switching to state BUFFER");
           this->state = GST_GDP_DEPAY_STATE_BUFFER;
         } else if (this->payload_type == GST_DP_PAYLOAD_CAPS) {
@@ -285,7 +309,7 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           gboolean res;
 
           data = gst_adapter_map (this->adapter, this->payload_length);
-          res = gst_dp_validate_payload (GST_DP_HEADER_LENGTH, this->header,
+          res = gst_dp_validate_payload (this->header_length, this->header,
               data);
           gst_adapter_unmap (this->adapter);
 
@@ -297,26 +321,46 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       }
       case GST_GDP_DEPAY_STATE_BUFFER:
       {
+        GstBuffer *payload;
+
         /* if we receive a buffer without caps first, we error out */
         if (!this->caps)
           goto no_caps;
 
         GST_LOG_OBJECT (this, "reading GDP buffer from adapter");
-        buf = gst_dp_buffer_from_header (GST_DP_HEADER_LENGTH, this->header);
-        if (!buf)
-          goto buffer_failed;
 
-        /* now take the payload if there is any */
-        if (this->payload_length > 0) {
-          GstMapInfo map;
+        /* take the payload if there is any, this is a sub-buffer of the
+         * input when the payload is not split over several input buffers */
+        if (this->payload_length > 0)
+          payload = gst_adapter_take_buffer (this->adapter,
+              this->payload_length);
+        else
+          payload = NULL;
 
-          gst_buffer_map (buf, &map, GST_MAP_WRITE);
-          gst_adapter_copy (this->adapter, map.data, 0, this->payload_length);
-          gst_buffer_unmap (buf, &map);
+        if (this->payload_type == GST_DP_PAYLOAD_BUFFER_LIST) {
+          GstBufferList *list;
 
-          gst_adapter_flush (this->adapter, this->payload_length);
+          list = gst_dp_buffer_list_from_header_and_payload
+              (this->header_length, this->header, payload);
+          if (!list)
+            goto buffer_failed;
+
+          GST_LOG_OBJECT (this, "deserialized list of %u buffers, pushing",
+              gst_buffer_list_length (list));
+          ret = gst_pad_push_list (this->srcpad, list);
+          if (ret != GST_FLOW_OK)
+            goto push_error;
+
+          GST_LOG_OBJECT (this, "switching to state HEADER");
+          this->state = GST_GDP_DEPAY_STATE_HEADER;
+          break;
         }
 
+        buf = gst_dp_buffer_from_header_and_payload (this->header_length,
+            this->header, payload);
+        if (!buf)
+          goto buffer_failed;
+
         /* set caps and push */
         GST_LOG_OBJECT (this, "deserialized buffer %p, pushing, timestamp %"
             GST_TIME_FORMAT ", duration %" GST_TIME_FORMAT
@@ -338,15 +382,36 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       case GST_GDP_DEPAY_STATE_CAPS:
       {
         guint8 *payload;
+        guint id;
 
-        /* take the payload of the caps */
+        /* take the payload of the caps, 2.0 caps references have none */
         GST_LOG_OBJECT (this, "reading GDP caps from adapter");
-        payload = gst_adapter_take (this->adapter, this->payload_length);
-        caps = gst_dp_caps_from_packet (GST_DP_HEADER_LENGTH, this->header,
-            payload);
-        g_free (payload);
-        if (!caps)
+        if (this->payload_length > 0)
+          payload = gst_adapter_take (this->adapter, this->payload_length);
+        else
+          payload = NULL;
+        id = gst_dp_header_caps_id (this->header_length, this->header);
+        if (id > GST_DP_MAX_CAPS_IDS) {
+          g_free (payload);
           goto caps_failed;
+        }
+
+        if (payload) {
+          caps = gst_dp_caps_from_packet (this->header_length, this->header,
+              payload);
+          g_free (payload);
+          if (!caps)
+            goto caps_failed;
+          if (id != 0)
+            g_hash_table_insert (this->caps_table, GUINT_TO_POINTER (id),
+                gst_caps_ref (caps));
+        } else {
+          caps = g_hash_table_lookup (this->caps_table, GUINT_TO_POINTER (id));
+          if (!caps)
+            goto caps_failed;
+          GST_LOG_OBJECT (this, "caps reference to id %u", id);
+          gst_caps_ref (caps);
+        }
 
         GST_DEBUG_OBJECT (this, "deserialized caps %" GST_PTR_FORMAT, caps);
         gst_caps_replace (&(this->caps), caps);
@@ -369,7 +434,7 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           payload = gst_adapter_take (this->adapter, this->payload_length);
         else
           payload = NULL;
-        event = gst_dp_event_from_packet (GST_DP_HEADER_LENGTH, this->header,
+        event = gst_dp_event_from_packet (this->header_length, this->header,
             payload);
         g_free (payload);
         if (!event)
@@ -460,6 +525,7 @@ gst_gdp_depay_change_state (GstElement * element, GstStateChange transition)
         gst_caps_unref (this->caps);
         this->caps = NULL;
       }
+      g_hash_table_remove_all (this->caps_table);
       gst_adapter_clear (this->adapter);
       break;
     default:
@@ -64,8 +64,12 @@ struct _GstGDPDepay
   GstCaps *caps;
 
   guint8 *header;
+  guint header_length;
   guint32 payload_length;
   GstDPPayloadType payload_type;
+
+  /* caps announced with an id in 2.0 streams, id -> GstCaps */
+  GHashTable *caps_table;
 };
 
 struct _GstGDPDepayClass
@@ -30,6 +30,13 @@
  * ]| This pipeline creates a serialized video stream that can be played back
  * with the example shown in gdpdepay.
  * </refsect2>
+ *
+ * With #GstGDPPay:version set to 2.0 the headers are much smaller, caps that
+ * were sent before are referred to by a numeric id and, with
+ * #GstGDPPay:batch-size, several buffers share one packet.  This saves a lot
+ * of overhead on streams of small buffers such as audio.  The receiving
+ * gdpdepay must support version 2.0; the caps then carry
+ * "gdp-version=(string)2.0".
  */
 
 #ifdef HAVE_CONFIG_H
@@ -58,6 +65,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_gdp_pay_debug);
 #define DEFAULT_CRC_HEADER TRUE
 #define DEFAULT_CRC_PAYLOAD FALSE
 #define DEFAULT_VERSION GST_DP_VERSION_1_0
+#define DEFAULT_BATCH_SIZE 1
 
 enum
 {
@@ -65,6 +73,7 @@ enum
   PROP_CRC_HEADER,
   PROP_CRC_PAYLOAD,
   PROP_VERSION,
+  PROP_BATCH_SIZE,
 };
 
 #define _do_init \
@@ -118,6 +127,11 @@ gst_gdp_pay_class_init (GstGDPPayClass * klass)
           "Version of the GStreamer Data Protocol",
           GST_TYPE_DP_VERSION, DEFAULT_VERSION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Number of buffers to put in one packet (version 2.0 only)",
+          1, G_MAXUINT16, DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_set_static_metadata (gstelement_class,
       "GDP Payloader", "GDP/Payloader",
@@ -153,9 +167,14 @@ gst_gdp_pay_init (GstGDPPay * gdppay)
   gdppay->crc_payload = DEFAULT_CRC_PAYLOAD;
   gdppay->header_flag = gdppay->crc_header | gdppay->crc_payload;
   gdppay->version = DEFAULT_VERSION;
+  gdppay->batch_size = DEFAULT_BATCH_SIZE;
   gdppay->offset = 0;
 
   gdppay->packetizer = gst_dp_packetizer_new (gdppay->version);
+  gdppay->batch = g_ptr_array_new_with_free_func (
+      (GDestroyNotify) gst_buffer_unref);
+  gdppay->caps_table = g_ptr_array_new_with_free_func (
+      (GDestroyNotify) gst_caps_unref);
 }
 
 static void
@@ -165,6 +184,8 @@ gst_gdp_pay_finalize (GObject * gobject)
 
   gst_gdp_pay_reset (this);
   gst_dp_packetizer_free (this->packetizer);
+  g_ptr_array_free (this->batch, TRUE);
+  g_ptr_array_free (this->caps_table, TRUE);
 
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (gobject));
 }
@@ -200,10 +221,36 @@ gst_gdp_pay_reset (GstGDPPay * this)
     gst_buffer_unref (this->new_segment_buf);
     this->new_segment_buf = NULL;
   }
+  g_ptr_array_set_size (this->batch, 0);
+  g_ptr_array_set_size (this->caps_table, 0);
   this->sent_streamheader = FALSE;
+  this->version_set = FALSE;
   this->offset = 0;
 }
 
+/* switch the packetizer to @version */
+static void
+gst_gdp_pay_set_packetizer (GstGDPPay * this, GstDPVersion version)
+{
+  if (this->packetizer->version == version)
+    return;
+
+  gst_dp_packetizer_free (this->packetizer);
+  this->packetizer = gst_dp_packetizer_new (version);
+}
+
+/* the version property only takes effect when the first packet of a
+ * stream is made, so a running stream doesn't change version midway */
+static void
+gst_gdp_pay_update_version (GstGDPPay * this)
+{
+  if (this->version_set)
+    return;
+  this->version_set = TRUE;
+
+  gst_gdp_pay_set_packetizer (this, this->version);
+}
+
 /* set OFFSET and OFFSET_END with running count */
 static void
 gst_gdp_stamp_buffer (GstGDPPay * this, GstBuffer * buffer)
@@ -213,25 +260,37 @@ gst_gdp_stamp_buffer (GstGDPPay * this, GstBuffer * buffer)
   this->offset = GST_BUFFER_OFFSET_END (buffer);
 }
 
+/* make a caps packet; for 2.0 a NULL @caps makes a reference to the caps
+ * sent earlier with @id */
 static GstBuffer *
-gst_gdp_buffer_from_caps (GstGDPPay * this, GstCaps * caps)
+gst_gdp_buffer_from_caps_with_id (GstGDPPay * this, GstCaps * caps, guint id)
 {
   GstBuffer *headerbuf;
-  GstBuffer *payloadbuf;
   guint8 *header, *payload;
   guint len, plen;
+  gboolean ret;
 
-  if (!this->packetizer->packet_from_caps (caps, this->header_flag, &len,
-          &header, &payload))
+  if (this->packetizer->version == GST_DP_VERSION_2_0)
+    ret = gst_dp_packet_from_caps_with_id (caps, id, this->header_flag, &len,
+        &header, &payload);
+  else
+    ret = this->packetizer->packet_from_caps (caps, this->header_flag, &len,
+        &header, &payload);
+  if (!ret)
     goto packet_failed;
 
   GST_LOG_OBJECT (this, "creating GDP header and payload buffer from caps");
   headerbuf = gst_buffer_new_wrapped (header, len);
 
   plen = gst_dp_header_payload_length (header);
-  payloadbuf = gst_buffer_new_wrapped (payload, plen);
+  if (plen && payload != NULL) {
+    gst_buffer_append_memory (headerbuf,
+        gst_memory_new_wrapped (0, payload, plen, 0, plen, payload, g_free));
+  } else {
+    g_free (payload);
+  }
 
-  return gst_buffer_append (headerbuf, payloadbuf);
+  return headerbuf;
 
   /* ERRORS */
 packet_failed:
@@ -241,6 +300,44 @@ packet_failed:
   }
 }
 
+static GstBuffer *
+gst_gdp_buffer_from_caps (GstGDPPay * this, GstCaps * caps)
+{
+  guint i;
+
+  if (this->packetizer->version != GST_DP_VERSION_2_0)
+    return gst_gdp_buffer_from_caps_with_id (this, caps, 0);
+
+  /* caps we gave an id to before only need a reference */
+  for (i = 0; i < this->caps_table->len; i++) {
+    if (gst_caps_is_equal (caps, g_ptr_array_index (this->caps_table, i))) {
+      GST_LOG_OBJECT (this, "referring to caps with id %u", i + 1);
+      return gst_gdp_buffer_from_caps_with_id (this, NULL, i + 1);
+    }
+  }
+
+  /* once the table is full, new caps are always sent in full */
+  if (this->caps_table->len == GST_DP_MAX_CAPS_IDS)
+    return gst_gdp_buffer_from_caps_with_id (this, caps, 0);
+
+  g_ptr_array_add (this->caps_table, gst_caps_ref (caps));
+  return gst_gdp_buffer_from_caps_with_id (this, caps, this->caps_table->len);
+}
+
+/* append the payload memory by reference; unlike gst_buffer_append() this
+ * does not need a writable (and thus copied) input buffer and metadata */
+static void
+gst_gdp_pay_append_payload (GstBuffer * outbuffer, GstBuffer * buffer)
+{
+  guint i, n;
+
+  n = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n; i++) {
+    gst_buffer_append_memory (outbuffer,
+        gst_memory_ref (gst_buffer_peek_memory (buffer, i)));
+  }
+}
+
 static GstBuffer *
 gst_gdp_pay_buffer_from_buffer (GstGDPPay * this, GstBuffer * buffer)
 {
@@ -254,11 +351,9 @@ gst_gdp_pay_buffer_from_buffer (GstGDPPay * this, GstBuffer * buffer)
 
   GST_LOG_OBJECT (this, "creating GDP header and payload buffer from buffer");
   headerbuf = gst_buffer_new_wrapped (header, len);
+  gst_gdp_pay_append_payload (headerbuf, buffer);
 
-  /* we do not want to lose the ref on the incoming buffer */
-  gst_buffer_ref (buffer);
-
-  return gst_buffer_append (headerbuf, buffer);
+  return headerbuf;
 
   /* ERRORS */
 no_buffer:
@@ -316,13 +411,14 @@ gst_gdp_pay_reset_streamheader (GstGDPPay * this)
   GstStructure *structure;
   GstFlowReturn r = GST_FLOW_OK;
   gboolean version_one_zero = TRUE;
+  guint i, caps_id = 0;
 
   GValue array = { 0 };
   GValue value = { 0 };
 
   GST_DEBUG_OBJECT (this, "start");
   /* In version 0.2, we didn't need or send new segment or tags */
-  if (this->version == GST_DP_VERSION_0_2)
+  if (this->packetizer->version == GST_DP_VERSION_0_2)
     version_one_zero = FALSE;
 
   if (version_one_zero) {
@@ -369,8 +465,45 @@ gst_gdp_pay_reset_streamheader (GstGDPPay * this)
   }
 
   gst_gdp_stamp_buffer (this, this->caps_buf);
-  GST_DEBUG_OBJECT (this, "appending copy of caps buffer %p", this->caps_buf);
-  caps_buf = gst_buffer_copy (this->caps_buf);
+
+  /* in 2.0 the caps buffer may only refer to caps by id, a client starting
+   * from the streamheader needs the full caps of all ids */
+  for (i = 0; i < this->caps_table->len; i++) {
+    GstCaps *table_caps = g_ptr_array_index (this->caps_table, i);
+
+    if (gst_caps_is_equal (table_caps, this->caps)) {
+      caps_id = i + 1;
+      continue;
+    }
+
+    caps_buf = gst_gdp_buffer_from_caps_with_id (this, table_caps, i + 1);
+    if (!caps_buf) {
+      g_value_unset (&array);
+      goto no_buffer;
+    }
+    GST_BUFFER_FLAG_SET (caps_buf, GST_BUFFER_FLAG_HEADER);
+    GST_DEBUG_OBJECT (this, "2.0, appending caps with id %u", i + 1);
+    g_value_init (&value, GST_TYPE_BUFFER);
+    gst_value_set_buffer (&value, caps_buf);
+    gst_value_array_append_value (&array, &value);
+    g_value_unset (&value);
+    gst_buffer_unref (caps_buf);
+  }
+
+  if (caps_id) {
+    GST_DEBUG_OBJECT (this, "2.0, appending current caps with id %u", caps_id);
+    caps_buf = gst_gdp_buffer_from_caps_with_id (this, this->caps, caps_id);
+    if (!caps_buf) {
+      g_value_unset (&array);
+      goto no_buffer;
+    }
+    gst_buffer_copy_into (caps_buf, this->caps_buf,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+  } else {
+    GST_DEBUG_OBJECT (this, "appending copy of caps buffer %p",
+        this->caps_buf);
+    caps_buf = gst_buffer_copy (this->caps_buf);
+  }
   g_value_init (&value, GST_TYPE_BUFFER);
   gst_value_set_buffer (&value, caps_buf);
   gst_value_array_append_value (&array, &value);
@@ -387,8 +520,6 @@ gst_gdp_pay_reset_streamheader (GstGDPPay * this)
 
     GstBuffer *buffer;
 
-    int i;
-
     sh = gst_structure_get_value (structure, "streamheader");
     buffers = g_value_peek_pointer (sh);
     GST_DEBUG_OBJECT (this,
@@ -438,6 +569,8 @@ gst_gdp_pay_reset_streamheader (GstGDPPay * this)
       gst_value_array_get_size (&array));
   caps = gst_caps_from_string ("application/x-gdp");
   structure = gst_caps_get_structure (caps, 0);
+  if (this->packetizer->version == GST_DP_VERSION_2_0)
+    gst_structure_set (structure, "gdp-version", G_TYPE_STRING, "2.0", NULL);
 
   gst_structure_set_value (structure, "streamheader", &array);
   g_value_unset (&array);
@@ -543,6 +676,54 @@ gst_gdp_queue_buffer (GstGDPPay * this, GstBuffer * buffer)
   return GST_FLOW_OK;
 }
 
+/* push out the buffers collected for a 2.0 batch as one packet */
+static GstFlowReturn
+gst_gdp_pay_flush_batch (GstGDPPay * this)
+{
+  GstBuffer *outbuffer, *first;
+  GstClockTime duration = 0;
+  guint8 *header;
+  guint len, i;
+
+  if (this->batch->len == 0)
+    return GST_FLOW_OK;
+
+  if (!gst_dp_header_from_buffers ((GstBuffer **) this->batch->pdata,
+          this->batch->len, this->header_flag, &len, &header))
+    goto no_buffer;
+
+  GST_LOG_OBJECT (this, "creating GDP packet from %u buffers",
+      this->batch->len);
+  outbuffer = gst_buffer_new_wrapped (header, len);
+  for (i = 0; i < this->batch->len; i++) {
+    GstBuffer *buffer = g_ptr_array_index (this->batch, i);
+
+    gst_gdp_pay_append_payload (outbuffer, buffer);
+    if (GST_CLOCK_TIME_IS_VALID (duration) &&
+        GST_BUFFER_DURATION_IS_VALID (buffer))
+      duration += GST_BUFFER_DURATION (buffer);
+    else
+      duration = GST_CLOCK_TIME_NONE;
+  }
+
+  first = g_ptr_array_index (this->batch, 0);
+  gst_gdp_stamp_buffer (this, outbuffer);
+  GST_BUFFER_TIMESTAMP (outbuffer) = GST_BUFFER_TIMESTAMP (first);
+  GST_BUFFER_DURATION (outbuffer) = duration;
+  g_ptr_array_set_size (this->batch, 0);
+
+  return gst_gdp_queue_buffer (this, outbuffer);
+
+  /* ERRORS */
+no_buffer:
+  {
+    g_ptr_array_set_size (this->batch, 0);
+    GST_ELEMENT_ERROR (this, STREAM, ENCODE, (NULL),
+        ("Could not create GDP buffer from buffers"));
+    return GST_FLOW_ERROR;
+  }
+}
+
 static GstFlowReturn
 gst_gdp_pay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 {
@@ -555,6 +736,8 @@ gst_gdp_pay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   this = GST_GDP_PAY (parent);
 
+  gst_gdp_pay_update_version (this);
+
   /* we should have received a new_segment before, otherwise it's a bug.
    * fake one in that case */
   if (!this->new_segment_buf) {
@@ -585,6 +768,21 @@ gst_gdp_pay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   if (!this->caps)
     goto no_caps;
 
+  /* 2.0 can carry several buffers in one packet; streamheader buffers
+   * always go out on their own */
+  if (this->packetizer->version == GST_DP_VERSION_2_0 && this->batch_size > 1) {
+    if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_HEADER)) {
+      g_ptr_array_add (this->batch, gst_buffer_ref (buffer));
+      ret = GST_FLOW_OK;
+      if (this->batch->len >= this->batch_size)
+        ret = gst_gdp_pay_flush_batch (this);
+      goto done;
+    }
+    ret = gst_gdp_pay_flush_batch (this);
+    if (ret != GST_FLOW_OK)
+      goto done;
+  }
+
   /* create a GDP header packet,
    * then create a GST buffer of the header packet and the buffer contents */
   outbuffer = gst_gdp_pay_buffer_from_buffer (this, buffer);
@@ -652,6 +850,17 @@ gst_gdp_pay_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
   GST_DEBUG_OBJECT (this, "received event %p of type %s (%d)",
       event, gst_event_type_get_name (event->type), event->type);
 
+  gst_gdp_pay_update_version (this);
+
+  /* buffers collected for a batch go out before any serialized event */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP) {
+    g_ptr_array_set_size (this->batch, 0);
+  } else if (GST_EVENT_IS_SERIALIZED (event)) {
+    flowret = gst_gdp_pay_flush_batch (this);
+    if (flowret != GST_FLOW_OK)
+      goto push_error;
+  }
+
   /* now turn the event into a buffer */
   outbuffer = gst_gdp_buffer_from_event (this, event);
   if (!outbuffer)
@@ -796,6 +1005,10 @@ gst_gdp_pay_set_property (GObject * object, guint prop_id,
       break;
     case PROP_VERSION:
       this->version = g_value_get_enum (value);
+      this->version_set = FALSE;
+      break;
+    case PROP_BATCH_SIZE:
+      this->batch_size = g_value_get_uint (value);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -822,6 +1035,9 @@ gst_gdp_pay_get_property (GObject * object, guint prop_id,
     case PROP_VERSION:
       g_value_set_enum (value, this->version);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, this->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
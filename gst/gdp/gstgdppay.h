@@ -65,6 +65,12 @@ struct _GstGDPPay
   GstDPHeaderFlag header_flag;
   GstDPVersion version;
   GstDPPacketizer *packetizer;
+  gboolean version_set; /* TRUE once the packetizer uses @version */
+
+  /* 2.0 only */
+  guint batch_size;
+  GPtrArray *batch; /* buffers waiting to go out in one packet */
+  GPtrArray *caps_table; /* caps sent with id index + 1 */
 };
 
 struct _GstGDPPayClass
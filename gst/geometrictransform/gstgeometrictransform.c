@@ -49,7 +49,9 @@ static GstVideoFilterClass *parent_class = NULL;
 enum
 {
   PROP_0,
-  PROP_OFF_EDGE_PIXELS
+  PROP_OFF_EDGE_PIXELS,
+  PROP_INTERPOLATION,
+  PROP_THREADS
 };
 
 #define GST_GT_OFF_EDGES_PIXELS_METHOD_TYPE ( \
@@ -74,7 +76,70 @@ gst_geometric_transform_off_edges_pixels_method_get_type (void)
   return method_type;
 }
 
+#define GST_GT_INTERPOLATION_TYPE ( \
+    gst_geometric_transform_interpolation_get_type())
+static GType
+gst_geometric_transform_interpolation_get_type (void)
+{
+  static GType interpolation_type = 0;
+
+  static const GEnumValue interpolation_types[] = {
+    {GST_GT_INTERPOLATION_NEAREST, "Nearest neighbour", "nearest"},
+    {GST_GT_INTERPOLATION_BILINEAR, "Bilinear", "bilinear"},
+    {0, NULL, NULL}
+  };
+
+  if (!interpolation_type) {
+    interpolation_type =
+        g_enum_register_static ("GstGeometricTransformInterpolation",
+        interpolation_types);
+  }
+  return interpolation_type;
+}
+
 #define DEFAULT_OFF_EDGE_PIXELS GST_GT_OFF_EDGES_PIXELS_IGNORE
+#define DEFAULT_INTERPOLATION GST_GT_INTERPOLATION_NEAREST
+#define DEFAULT_THREADS 0
+
+#define MAX_THREADS 16
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+/* the output is remapped in tiles so that the input pixels read for
+ * neighbouring output pixels stay in cache for maps that don't follow
+ * the rows (rotations, twirls...) */
+#define TILE_WIDTH 64
+#define TILE_HEIGHT 16
+
+/* Applies the off edge pixels method and converts the input position to
+ * fixed point. Returns FALSE if the pixel has no input pixel. Nearest
+ * neighbour sampling truncates, so anything in ]-1, size[ is valid */
+static inline gboolean
+gst_geometric_transform_fixed_coord (gint off_edge_pixels, gdouble in,
+    gint size, gint32 * out)
+{
+  switch (off_edge_pixels) {
+    case GST_GT_OFF_EDGES_PIXELS_CLAMP:
+      in = CLAMP (in, 0, size - 1);
+      break;
+
+    case GST_GT_OFF_EDGES_PIXELS_WRAP:
+      in = mod_float (in, size);
+      if (in < 0)
+        in += size;
+      break;
+
+    default:
+      if (!(in > -1 && in < size))
+        return FALSE;
+      break;
+  }
+
+  in *= FIXED_ONE;
+  *out = (gint32) CLAMP (in, 0, size * FIXED_ONE - 1);
+  return TRUE;
+}
 
 /* must be called with the object lock */
 static gboolean
@@ -84,13 +149,9 @@ gst_geometric_transform_generate_map (GstGeometricTransform * gt)
   gdouble in_x, in_y;
   gboolean ret = TRUE;
   GstGeometricTransformClass *klass;
-  gdouble *ptr;
-
-  GST_INFO_OBJECT (gt, "Generating new transform map");
+  gint32 *ptr;
 
-  /* cleanup old map */
-  g_free (gt->map);
-  gt->map = NULL;
+  GST_LOG_OBJECT (gt, "Generating new transform map");
 
   klass = GST_GEOMETRIC_TRANSFORM_GET_CLASS (gt);
 
@@ -98,9 +159,12 @@ gst_geometric_transform_generate_map (GstGeometricTransform * gt)
   g_return_val_if_fail (klass->map_func, FALSE);
 
   /*
-   * (x,y) pairs of the inverse mapping
+   * (x,y) pairs of the inverse mapping, the map is only reallocated on size
+   * changes as subclasses without a precalculated map regenerate it for
+   * every frame
    */
-  gt->map = g_malloc0 (sizeof (gdouble) * gt->width * gt->height * 2);
+  if (gt->map == NULL)
+    gt->map = g_malloc (sizeof (gint32) * gt->width * gt->height * 2);
   ptr = gt->map;
 
   for (y = 0; y < gt->height; y++) {
@@ -111,8 +175,11 @@ gst_geometric_transform_generate_map (GstGeometricTransform * gt)
         goto end;
       }
 
-      ptr[0] = in_x;
-      ptr[1] = in_y;
+      if (!gst_geometric_transform_fixed_coord (gt->off_edge_pixels, in_x,
+              gt->width, &ptr[0])
+          || !gst_geometric_transform_fixed_coord (gt->off_edge_pixels, in_y,
+              gt->height, &ptr[1]))
+        ptr[0] = -1;
       ptr += 2;
     }
   }
@@ -145,6 +212,7 @@ gst_geometric_transform_set_info (GstVideoFilter * vfilter, GstCaps * incaps,
 
   gt->width = in_info->width;
   gt->height = in_info->height;
+  gt->format = GST_VIDEO_INFO_FORMAT (in_info);
   gt->row_stride = in_info->stride[0];
   gt->pixel_stride = GST_VIDEO_INFO_COMP_PSTRIDE (in_info, 0);
 
@@ -152,6 +220,9 @@ gst_geometric_transform_set_info (GstVideoFilter * vfilter, GstCaps * incaps,
   GST_OBJECT_LOCK (gt);
   if (gt->map == NULL || old_width == 0 || old_height == 0
       || gt->width != old_width || gt->height != old_height) {
+    g_free (gt->map);
+    gt->map = NULL;
+
     if (klass->prepare_func)
       if (!klass->prepare_func (gt)) {
         GST_OBJECT_UNLOCK (gt);
@@ -164,48 +235,266 @@ gst_geometric_transform_set_info (GstVideoFilter * vfilter, GstCaps * incaps,
   return ret;
 }
 
+static inline void
+gst_geometric_transform_copy_pixel (guint8 * out, const guint8 * in,
+    gint pixel_stride)
+{
+  switch (pixel_stride) {
+    case 4:
+      memcpy (out, in, 4);
+      break;
+    case 3:
+      memcpy (out, in, 3);
+      break;
+    case 2:
+      memcpy (out, in, 2);
+      break;
+    case 1:
+      out[0] = in[0];
+      break;
+    default:
+      memcpy (out, in, pixel_stride);
+      break;
+  }
+}
+
 static void
-gst_geometric_transform_do_map (GstGeometricTransform * gt, guint8 * in_data,
-    guint8 * out_data, gint x, gint y, gdouble in_x, gdouble in_y)
+gst_geometric_transform_remap_nearest (GstGeometricTransform * gt,
+    const guint8 * in_data, gint in_stride, guint8 * out_data,
+    gint out_stride, gint x0, gint y0, gint x1, gint y1)
 {
-  gint in_offset;
-  gint out_offset;
+  gint pixel_stride = gt->pixel_stride;
+  gint x, y;
 
-  out_offset = y * gt->row_stride + x * gt->pixel_stride;
+  for (y = y0; y < y1; y++) {
+    const gint32 *ptr = gt->map + 2 * (y * gt->width + x0);
+    guint8 *out = out_data + y * out_stride + x0 * pixel_stride;
 
-  /* operate on out of edge pixels */
-  switch (gt->off_edge_pixels) {
-    case GST_GT_OFF_EDGES_PIXELS_CLAMP:
-      in_x = CLAMP (in_x, 0, gt->width - 1);
-      in_y = CLAMP (in_y, 0, gt->height - 1);
-      break;
+    for (x = x0; x < x1; x++, ptr += 2, out += pixel_stride) {
+      if (ptr[0] < 0)
+        continue;
 
-    case GST_GT_OFF_EDGES_PIXELS_WRAP:
-      in_x = mod_float (in_x, gt->width);
-      in_y = mod_float (in_y, gt->height);
-      if (in_x < 0)
-        in_x += gt->width;
-      if (in_y < 0)
-        in_y += gt->height;
-      break;
+      gst_geometric_transform_copy_pixel (out,
+          in_data + (ptr[1] >> FIXED_SHIFT) * in_stride +
+          (ptr[0] >> FIXED_SHIFT) * pixel_stride, pixel_stride);
+    }
+  }
+}
 
-    default:
-      break;
+/* 8 bits of fraction are used for the weights so that everything stays in
+ * 32 bits for 16 bits components too */
+#define BILINEAR(p00,p01,p10,p11,ax,ay) \
+    ((((((p00) * (256 - (ax)) + (p01) * (ax)) >> 8) * (256 - (ay))) + \
+      ((((p10) * (256 - (ax)) + (p11) * (ax)) >> 8) * (ay)) + 128) >> 8)
+
+static void
+gst_geometric_transform_remap_bilinear (GstGeometricTransform * gt,
+    const guint8 * in_data, gint in_stride, guint8 * out_data,
+    gint out_stride, gint x0, gint y0, gint x1, gint y1)
+{
+  gint pixel_stride = gt->pixel_stride;
+  gboolean wrap = gt->off_edge_pixels == GST_GT_OFF_EDGES_PIXELS_WRAP;
+  gint x, y, c;
+
+  for (y = y0; y < y1; y++) {
+    const gint32 *ptr = gt->map + 2 * (y * gt->width + x0);
+    guint8 *out = out_data + y * out_stride + x0 * pixel_stride;
+
+    for (x = x0; x < x1; x++, ptr += 2, out += pixel_stride) {
+      const guint8 *row0, *row1;
+      gint sx0, sx1, sy0, sy1;
+      guint ax, ay;
+
+      if (ptr[0] < 0)
+        continue;
+
+      sx0 = ptr[0] >> FIXED_SHIFT;
+      sy0 = ptr[1] >> FIXED_SHIFT;
+      ax = (ptr[0] >> (FIXED_SHIFT - 8)) & 0xff;
+      ay = (ptr[1] >> (FIXED_SHIFT - 8)) & 0xff;
+
+      /* neighbours past the edge wrap around or repeat the edge */
+      sx1 = sx0 + 1;
+      if (sx1 >= gt->width)
+        sx1 = wrap ? 0 : gt->width - 1;
+      sy1 = sy0 + 1;
+      if (sy1 >= gt->height)
+        sy1 = wrap ? 0 : gt->height - 1;
+
+      row0 = in_data + sy0 * in_stride;
+      row1 = in_data + sy1 * in_stride;
+      sx0 *= pixel_stride;
+      sx1 *= pixel_stride;
+
+      switch (gt->format) {
+        case GST_VIDEO_FORMAT_GRAY16_LE:
+          GST_WRITE_UINT16_LE (out,
+              BILINEAR (GST_READ_UINT16_LE (row0 + sx0),
+                  GST_READ_UINT16_LE (row0 + sx1),
+                  GST_READ_UINT16_LE (row1 + sx0),
+                  GST_READ_UINT16_LE (row1 + sx1), ax, ay));
+          break;
+        case GST_VIDEO_FORMAT_GRAY16_BE:
+          GST_WRITE_UINT16_BE (out,
+              BILINEAR (GST_READ_UINT16_BE (row0 + sx0),
+                  GST_READ_UINT16_BE (row0 + sx1),
+                  GST_READ_UINT16_BE (row1 + sx0),
+                  GST_READ_UINT16_BE (row1 + sx1), ax, ay));
+          break;
+        default:
+          /* all the other formats have 8 bits components */
+          for (c = 0; c < pixel_stride; c++) {
+            out[c] = BILINEAR (row0[sx0 + c], row0[sx1 + c], row1[sx0 + c],
+                row1[sx1 + c], ax, ay);
+          }
+          break;
+      }
+    }
   }
+}
+
+static void
+gst_geometric_transform_remap_band (GstGeometricTransformBand * band)
+{
+  GstGeometricTransform *gt = band->gt;
+  gint x, y;
 
-  {
-    gint trunc_x = (gint) in_x;
-    gint trunc_y = (gint) in_y;
-    /* only set the values if the values are valid */
-    if (trunc_x >= 0 && trunc_x < gt->width && trunc_y >= 0 &&
-        trunc_y < gt->height) {
-      in_offset = trunc_y * gt->row_stride + trunc_x * gt->pixel_stride;
+  /* only pixels without an input pixel are not written */
+  if (gt->off_edge_pixels == GST_GT_OFF_EDGES_PIXELS_IGNORE)
+    memset (band->out_data + band->y0 * band->out_stride, 0,
+        (band->y1 - band->y0) * band->out_stride);
 
-      memcpy (out_data + out_offset, in_data + in_offset, gt->pixel_stride);
+  for (y = band->y0; y < band->y1; y += TILE_HEIGHT) {
+    gint y1 = MIN (y + TILE_HEIGHT, band->y1);
+
+    for (x = 0; x < gt->width; x += TILE_WIDTH) {
+      gint x1 = MIN (x + TILE_WIDTH, gt->width);
+
+      if (gt->interpolation == GST_GT_INTERPOLATION_BILINEAR)
+        gst_geometric_transform_remap_bilinear (gt, band->in_data,
+            band->in_stride, band->out_data, band->out_stride, x, y, x1, y1);
+      else
+        gst_geometric_transform_remap_nearest (gt, band->in_data,
+            band->in_stride, band->out_data, band->out_stride, x, y, x1, y1);
     }
   }
 }
 
+static void
+gst_geometric_transform_band_thread (gpointer data, gpointer user_data)
+{
+  GstGeometricTransform *gt = user_data;
+  GstGeometricTransformBand *band = data;
+
+  gst_geometric_transform_remap_band (band);
+
+  g_mutex_lock (&gt->bands_lock);
+  if (--gt->bands_pending == 0)
+    g_cond_signal (&gt->bands_cond);
+  g_mutex_unlock (&gt->bands_lock);
+}
+
+static void
+gst_geometric_transform_free_bands (GstGeometricTransform * gt)
+{
+  if (gt->pool) {
+    g_thread_pool_free (gt->pool, FALSE, TRUE);
+    gt->pool = NULL;
+  }
+
+  g_free (gt->bands);
+  gt->bands = NULL;
+  gt->n_bands = 0;
+}
+
+static guint
+gst_geometric_transform_get_n_bands (GstGeometricTransform * gt)
+{
+  guint n_bands = gt->threads;
+
+  if (n_bands == 0) {
+#if GLIB_CHECK_VERSION(2,36,0)
+    n_bands = g_get_num_processors ();
+#else
+    n_bands = 1;
+#endif
+  }
+
+  return CLAMP (n_bands, 1, MAX_THREADS);
+}
+
+/* (re)allocates the bands if the number of threads changed */
+static void
+gst_geometric_transform_setup_bands (GstGeometricTransform * gt)
+{
+  const guint n_bands = gst_geometric_transform_get_n_bands (gt);
+
+  if (gt->bands && n_bands == gt->n_bands)
+    return;
+
+  gst_geometric_transform_free_bands (gt);
+
+  GST_DEBUG_OBJECT (gt, "using %u bands", n_bands);
+
+  gt->bands = g_new0 (GstGeometricTransformBand, n_bands);
+  gt->n_bands = n_bands;
+
+  if (n_bands > 1) {
+    gt->pool = g_thread_pool_new (gst_geometric_transform_band_thread, gt,
+        n_bands - 1, FALSE, NULL);
+    if (!gt->pool)
+      GST_WARNING_OBJECT (gt, "failed to create thread pool, remapping "
+          "bands sequentially");
+  }
+}
+
+/* splits the output rows into bands of whole tiles and remaps them, the
+ * first band on the calling thread and the others on the thread pool */
+static void
+gst_geometric_transform_run_bands (GstGeometricTransform * gt,
+    const guint8 * in_data, gint in_stride, guint8 * out_data,
+    gint out_stride)
+{
+  guint i, n_bands;
+  gint n_tiles;
+
+  gst_geometric_transform_setup_bands (gt);
+
+  n_tiles = (gt->height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+  n_bands = MIN (gt->n_bands, MAX (n_tiles, 1));
+  for (i = 0; i < n_bands; i++) {
+    GstGeometricTransformBand *band = &gt->bands[i];
+
+    band->gt = gt;
+    band->in_data = in_data;
+    band->in_stride = in_stride;
+    band->out_data = out_data;
+    band->out_stride = out_stride;
+    band->y0 = MIN ((gint) (n_tiles * i / n_bands) * TILE_HEIGHT, gt->height);
+    band->y1 =
+        MIN ((gint) (n_tiles * (i + 1) / n_bands) * TILE_HEIGHT, gt->height);
+  }
+
+  if (gt->pool && n_bands > 1) {
+    g_mutex_lock (&gt->bands_lock);
+    gt->bands_pending = n_bands - 1;
+    g_mutex_unlock (&gt->bands_lock);
+
+    for (i = 1; i < n_bands; i++)
+      g_thread_pool_push (gt->pool, &gt->bands[i], NULL);
+
+    gst_geometric_transform_remap_band (&gt->bands[0]);
+
+    g_mutex_lock (&gt->bands_lock);
+    while (gt->bands_pending > 0)
+      g_cond_wait (&gt->bands_cond, &gt->bands_lock);
+    g_mutex_unlock (&gt->bands_lock);
+  } else {
+    for (i = 0; i < n_bands; i++)
+      gst_geometric_transform_remap_band (&gt->bands[i]);
+  }
+}
+
 static void
 gst_geometric_transform_before_transform (GstBaseTransform * trans,
     GstBuffer * outbuf)
@@ -229,55 +518,48 @@ gst_geometric_transform_transform_frame (GstVideoFilter * vfilter,
 {
   GstGeometricTransform *gt;
   GstGeometricTransformClass *klass;
-  gint x, y;
   GstFlowReturn ret = GST_FLOW_OK;
-  gdouble *ptr;
   guint8 *in_data;
   guint8 *out_data;
+  gint in_stride, out_stride;
 
   gt = GST_GEOMETRIC_TRANSFORM_CAST (vfilter);
   klass = GST_GEOMETRIC_TRANSFORM_GET_CLASS (gt);
 
   in_data = GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0);
   out_data = GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0);
-  memset (out_data, 0, out_frame->map[0].size);
+  in_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 0);
+  out_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 0);
 
   GST_OBJECT_LOCK (gt);
   if (gt->precalc_map) {
     if (gt->needs_remap) {
       if (klass->prepare_func)
         if (!klass->prepare_func (gt)) {
-          ret = FALSE;
+          ret = GST_FLOW_ERROR;
           goto end;
         }
       gst_geometric_transform_generate_map (gt);
     }
-    g_return_val_if_fail (gt->map, GST_FLOW_ERROR);
-    ptr = gt->map;
-    for (y = 0; y < gt->height; y++) {
-      for (x = 0; x < gt->width; x++) {
-        /* do the mapping */
-        gst_geometric_transform_do_map (gt, in_data, out_data, x, y, ptr[0],
-            ptr[1]);
-        ptr += 2;
-      }
-    }
   } else {
-    for (y = 0; y < gt->height; y++) {
-      for (x = 0; x < gt->width; x++) {
-        gdouble in_x, in_y;
-
-        if (klass->map_func (gt, x, y, &in_x, &in_y)) {
-          gst_geometric_transform_do_map (gt, in_data, out_data, x, y, in_x,
-              in_y);
-        } else {
-          GST_WARNING_OBJECT (gt, "Failed to do mapping for %d %d", x, y);
-          ret = GST_FLOW_ERROR;
-          goto end;
-        }
-      }
+    /* the mapping is different for every frame */
+    if (!gst_geometric_transform_generate_map (gt)) {
+      ret = GST_FLOW_ERROR;
+      goto end;
     }
   }
+
+  if (gt->map == NULL) {
+    GST_WARNING_OBJECT (gt, "No transform map available");
+    ret = GST_FLOW_ERROR;
+    goto end;
+  }
+
+  /* the bands only read the map and the properties, which can't change
+   * while we hold the object lock */
+  gst_geometric_transform_run_bands (gt, in_data, in_stride, out_data,
+      out_stride);
+
 end:
   GST_OBJECT_UNLOCK (gt);
   return ret;
@@ -295,6 +577,18 @@ gst_geometric_transform_set_property (GObject * object, guint prop_id,
     case PROP_OFF_EDGE_PIXELS:
       GST_OBJECT_LOCK (gt);
       gt->off_edge_pixels = g_value_get_enum (value);
+      /* the method is applied when generating the map */
+      gst_geometric_transform_set_need_remap (gt);
+      GST_OBJECT_UNLOCK (gt);
+      break;
+    case PROP_INTERPOLATION:
+      GST_OBJECT_LOCK (gt);
+      gt->interpolation = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (gt);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (gt);
+      gt->threads = g_value_get_uint (value);
       GST_OBJECT_UNLOCK (gt);
       break;
     default:
@@ -315,6 +609,14 @@ gst_geometric_transform_get_property (GObject * object, guint prop_id,
     case PROP_OFF_EDGE_PIXELS:
       g_value_set_enum (value, gt->off_edge_pixels);
       break;
+    case PROP_INTERPOLATION:
+      g_value_set_enum (value, gt->interpolation);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (gt);
+      g_value_set_uint (value, gt->threads);
+      GST_OBJECT_UNLOCK (gt);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -335,9 +637,25 @@ gst_geometric_transform_stop (GstBaseTransform * trans)
   g_free (gt->map);
   gt->map = NULL;
 
+  gst_geometric_transform_free_bands (gt);
+
   return TRUE;
 }
 
+static void
+gst_geometric_transform_finalize (GObject * object)
+{
+  GstGeometricTransform *gt = GST_GEOMETRIC_TRANSFORM_CAST (object);
+
+  gst_geometric_transform_free_bands (gt);
+  g_free (gt->map);
+  gt->map = NULL;
+  g_mutex_clear (&gt->bands_lock);
+  g_cond_clear (&gt->bands_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_geometric_transform_base_init (gpointer g_class)
 {
@@ -366,6 +684,7 @@ gst_geometric_transform_class_init (gpointer klass, gpointer class_data)
       GST_DEBUG_FUNCPTR (gst_geometric_transform_set_property);
   obj_class->get_property =
       GST_DEBUG_FUNCPTR (gst_geometric_transform_get_property);
+  obj_class->finalize = GST_DEBUG_FUNCPTR (gst_geometric_transform_finalize);
 
   trans_class->stop = GST_DEBUG_FUNCPTR (gst_geometric_transform_stop);
   trans_class->before_transform =
@@ -381,6 +700,16 @@ gst_geometric_transform_class_init (gpointer klass, gpointer class_data)
           "What to do with off edge pixels",
           GST_GT_OFF_EDGES_PIXELS_METHOD_TYPE, DEFAULT_OFF_EDGE_PIXELS,
           GST_PARAM_CONTROLLABLE | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_INTERPOLATION,
+      g_param_spec_enum ("interpolation", "Interpolation",
+          "How input pixels are sampled",
+          GST_GT_INTERPOLATION_TYPE, DEFAULT_INTERPOLATION,
+          GST_PARAM_CONTROLLABLE | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_THREADS,
+      g_param_spec_uint ("threads", "Threads",
+          "Number of threads used to remap the frames (0 = automatic)",
+          0, MAX_THREADS, DEFAULT_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -389,8 +718,13 @@ gst_geometric_transform_init (GTypeInstance * instance, gpointer g_class)
   GstGeometricTransform *gt = GST_GEOMETRIC_TRANSFORM_CAST (instance);
 
   gt->off_edge_pixels = DEFAULT_OFF_EDGE_PIXELS;
+  gt->interpolation = DEFAULT_INTERPOLATION;
+  gt->threads = DEFAULT_THREADS;
   gt->precalc_map = TRUE;
   gt->needs_remap = TRUE;
+
+  g_mutex_init (&gt->bands_lock);
+  g_cond_init (&gt->bands_cond);
 }
 
 GType
@@ -46,9 +46,26 @@ enum
   GST_GT_OFF_EDGES_PIXELS_WRAP
 };
 
+enum
+{
+  GST_GT_INTERPOLATION_NEAREST = 0,
+  GST_GT_INTERPOLATION_BILINEAR
+};
+
 typedef struct _GstGeometricTransform GstGeometricTransform;
 typedef struct _GstGeometricTransformClass GstGeometricTransformClass;
 
+/* a band of output rows remapped by one thread */
+typedef struct
+{
+  GstGeometricTransform *gt;
+  const guint8 *in_data;
+  gint in_stride;
+  guint8 *out_data;
+  gint out_stride;
+  gint y0, y1;
+} GstGeometricTransformBand;
+
 /**
  * GstGeometricTransformMapFunc:
  *
@@ -99,8 +116,21 @@ struct _GstGeometricTransform {
 
   /* properties */
   gint off_edge_pixels;
-
-  gdouble *map;
+  gint interpolation;
+  guint threads;
+
+  /* the output is remapped in bands of rows in parallel */
+  GThreadPool *pool;
+  GstGeometricTransformBand *bands;
+  guint n_bands;
+  GMutex bands_lock;
+  GCond bands_cond;
+  guint bands_pending;
+
+  /* (x,y) pairs of the inverse mapping in 16.16 fixed point, with the
+   * off edge pixels method already applied. x is negative for pixels that
+   * have no input pixel */
+  gint32 *map;
 };
 
 struct _GstGeometricTransformClass {
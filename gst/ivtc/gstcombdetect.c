@@ -213,12 +213,15 @@ gst_comb_detect_transform_frame (GstVideoFilter * filter,
   {
     int j;
     int thisline[MAX_WIDTH];
+    guint8 combed[MAX_WIDTH];
+    gboolean thisline_clear;
     int score = 0;
 
     height = GST_VIDEO_FRAME_COMP_HEIGHT (outframe, 0);
     width = GST_VIDEO_FRAME_COMP_WIDTH (outframe, 0);
 
     memset (thisline, 0, sizeof (thisline));
+    thisline_clear = TRUE;
 
     k = 0;
     for (j = 0; j < height; j++) {
@@ -234,10 +237,31 @@ gst_comb_detect_transform_frame (GstVideoFilter * filter,
         guint8 *src1 = GET_LINE (inframe, 0, j - 1);
         guint8 *src2 = GET_LINE (inframe, 0, j);
         guint8 *src3 = GET_LINE (inframe, 0, j + 1);
+        guint8 any_combed = 0;
 
+        /* first mark the combed samples of the line. this has no
+         * dependencies between samples so the compiler can vectorise it */
         for (i = 0; i < width; i++) {
-          if (src2[i] < MIN (src1[i], src3[i]) - 5 ||
-              src2[i] > MAX (src1[i], src3[i]) + 5) {
+          int lo = MIN (src1[i], src3[i]);
+          int hi = MAX (src1[i], src3[i]);
+
+          combed[i] = (src2[i] < lo - 5) | (src2[i] > hi + 5);
+          any_combed |= combed[i];
+        }
+
+        /* a line without combing resets all the runs and is copied */
+        if (!any_combed) {
+          if (!thisline_clear) {
+            memset (thisline, 0, width * sizeof (int));
+            thisline_clear = TRUE;
+          }
+          memcpy (dest, src2, width);
+          continue;
+        }
+        thisline_clear = FALSE;
+
+        for (i = 0; i < width; i++) {
+          if (combed[i]) {
             if (i > 0) {
               thisline[i] += thisline[i - 1];
             }
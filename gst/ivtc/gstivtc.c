@@ -73,7 +73,8 @@ static void gst_ivtc_flush (GstIvtc * ivtc);
 static void gst_ivtc_retire_fields (GstIvtc * ivtc, int n_fields);
 static void gst_ivtc_construct_frame (GstIvtc * itvc, GstBuffer * outbuf);
 
-static int get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom);
+static int get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom,
+    int max_score);
 
 enum
 {
@@ -284,6 +285,7 @@ add_field (GstIvtc * ivtc, GstBuffer * buffer, int parity, int index)
   field->buffer = gst_buffer_ref (buffer);
   field->parity = parity;
   field->ts = ts;
+  field->next_score = -1;
 
   gst_video_frame_map (&ivtc->fields[i].frame, &ivtc->sink_video_info,
       buffer, GST_MAP_READ);
@@ -291,6 +293,11 @@ add_field (GstIvtc * ivtc, GstBuffer * buffer, int parity, int index)
   ivtc->n_fields++;
 }
 
+#define THRESHOLD 100
+/* the decisions in gst_ivtc_construct_frame() don't depend on the exact
+ * value of scores above this, so scoring stops there */
+#define MAX_SCORE (THRESHOLD * 2)
+
 static int
 similarity (GstIvtc * ivtc, int i1, int i2)
 {
@@ -303,12 +310,22 @@ similarity (GstIvtc * ivtc, int i1, int i2)
   f1 = &ivtc->fields[i1];
   f2 = &ivtc->fields[i2];
 
+  /* neighbouring fields are compared again for the next frame when only the
+   * fields before them were retired, so keep their score */
+  if (i2 == i1 + 1 && f1->next_score >= 0) {
+    GST_DEBUG ("cached score %d", f1->next_score);
+    return f1->next_score;
+  }
+
   if (f1->parity == TOP_FIELD) {
-    score = get_comb_score (&f1->frame, &f2->frame);
+    score = get_comb_score (&f1->frame, &f2->frame, MAX_SCORE);
   } else {
-    score = get_comb_score (&f2->frame, &f1->frame);
+    score = get_comb_score (&f2->frame, &f1->frame, MAX_SCORE);
   }
 
+  if (i2 == i1 + 1)
+    f1->next_score = score;
+
   GST_DEBUG ("score %d", score);
 
   return score;
@@ -479,7 +496,6 @@ gst_ivtc_construct_frame (GstIvtc * ivtc, GstBuffer * outbuf)
   gst_video_frame_map (&dest_frame, &ivtc->src_video_info, outbuf,
       GST_MAP_WRITE);
 
-#define THRESHOLD 100
   if (prev_score < THRESHOLD) {
     if (forward_ok && next_score < prev_score) {
       reconstruct (ivtc, &dest_frame, anchor_index, anchor_index + 1);
@@ -526,11 +542,15 @@ gst_ivtc_construct_frame (GstIvtc * ivtc, GstBuffer * outbuf)
 
 }
 
+/* scores how combed the frame woven from the two fields is. scoring stops
+ * once max_score is reached, the return value is then max_score */
 static int
-get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom)
+get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom, int max_score)
 {
   int j;
   int thisline[MAX_WIDTH];
+  guint8 combed[MAX_WIDTH];
+  gboolean thisline_clear;
   int score = 0;
   int height;
   int width;
@@ -540,6 +560,7 @@ get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom)
   width = GST_VIDEO_FRAME_COMP_WIDTH (top, 0);
 
   memset (thisline, 0, sizeof (thisline));
+  thisline_clear = TRUE;
 
   k = 0;
   /* remove a few lines from top and bottom, as they sometimes contain
@@ -548,11 +569,31 @@ get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom)
     guint8 *src1 = GET_LINE_IL (top, bottom, 0, j - 1);
     guint8 *src2 = GET_LINE_IL (top, bottom, 0, j);
     guint8 *src3 = GET_LINE_IL (top, bottom, 0, j + 1);
+    guint8 any_combed = 0;
     int i;
 
+    /* first mark the combed samples of the line. this has no dependencies
+     * between samples so the compiler can vectorise it */
     for (i = 0; i < width; i++) {
-      if (src2[i] < MIN (src1[i], src3[i]) - 5 ||
-          src2[i] > MAX (src1[i], src3[i]) + 5) {
+      int lo = MIN (src1[i], src3[i]);
+      int hi = MAX (src1[i], src3[i]);
+
+      combed[i] = (src2[i] < lo - 5) | (src2[i] > hi + 5);
+      any_combed |= combed[i];
+    }
+
+    /* a line without combing resets all the runs and adds nothing */
+    if (!any_combed) {
+      if (!thisline_clear) {
+        memset (thisline, 0, width * sizeof (int));
+        thisline_clear = TRUE;
+      }
+      continue;
+    }
+    thisline_clear = FALSE;
+
+    for (i = 0; i < width; i++) {
+      if (combed[i]) {
         if (i > 0) {
           thisline[i] += thisline[i - 1];
         }
@@ -566,6 +607,11 @@ get_comb_score (GstVideoFrame * top, GstVideoFrame * bottom)
         score++;
       }
     }
+
+    if (score >= max_score) {
+      score = max_score;
+      break;
+    }
   }
 
   GST_DEBUG ("score %d", score);
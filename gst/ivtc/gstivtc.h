@@ -41,6 +41,8 @@ struct _GstIvtcField
   int parity;
   GstVideoFrame frame;
   GstClockTime ts;
+  /* comb score against the following field, -1 if not computed yet */
+  int next_score;
 };
 
 #define GST_IVTC_MAX_FIELDS 10
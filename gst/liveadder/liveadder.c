@@ -43,6 +43,7 @@
 #endif
 
 #include "liveadder.h"
+#include "gstliveadderorc.h"
 
 #include <gst/audio/audio.h>
 
@@ -131,31 +132,21 @@ static gboolean gst_live_adder_sink_event (GstPad * pad, GstObject * parent,
 
 static void reset_pad_private (GstPad * pad);
 
-/* clipping versions */
-#define MAKE_FUNC(name,type,ttype,min,max)                      \
+/* the integer kernels saturate, the float ones don't clip */
+#define MAKE_FUNC(name,type,orcfunc)                            \
 static void name (type *out, type *in, gint bytes) {            \
-  gint i;                                                       \
-  for (i = 0; i < bytes / sizeof (type); i++)                   \
-    out[i] = CLAMP ((ttype)out[i] + (ttype)in[i], min, max);    \
-}
-
-/* non-clipping versions (for float) */
-#define MAKE_FUNC_NC(name,type,ttype)                           \
-static void name (type *out, type *in, gint bytes) {            \
-  gint i;                                                       \
-  for (i = 0; i < bytes / sizeof (type); i++)                   \
-    out[i] = (ttype)out[i] + (ttype)in[i];                      \
+  orcfunc (out, in, bytes / sizeof (type));                     \
 }
 
 /* *INDENT-OFF* */
-MAKE_FUNC (add_int32, gint32, gint64, G_MININT32, G_MAXINT32)
-MAKE_FUNC (add_int16, gint16, gint32, G_MININT16, G_MAXINT16)
-MAKE_FUNC (add_int8, gint8, gint16, G_MININT8, G_MAXINT8)
-MAKE_FUNC (add_uint32, guint32, guint64, 0, G_MAXUINT32)
-MAKE_FUNC (add_uint16, guint16, guint32, 0, G_MAXUINT16)
-MAKE_FUNC (add_uint8, guint8, guint16, 0, G_MAXUINT8)
-MAKE_FUNC_NC (add_float64, gdouble, gdouble)
-MAKE_FUNC_NC (add_float32, gfloat, gfloat)
+MAKE_FUNC (add_int32, gint32, live_adder_orc_add_int32)
+MAKE_FUNC (add_int16, gint16, live_adder_orc_add_int16)
+MAKE_FUNC (add_int8, gint8, live_adder_orc_add_int8)
+MAKE_FUNC (add_uint32, guint32, live_adder_orc_add_uint32)
+MAKE_FUNC (add_uint16, guint16, live_adder_orc_add_uint16)
+MAKE_FUNC (add_uint8, guint8, live_adder_orc_add_uint8)
+MAKE_FUNC (add_float64, gdouble, live_adder_orc_add_float64)
+MAKE_FUNC (add_float32, gfloat, live_adder_orc_add_float32)
 /* *INDENT-ON* */
 
 
@@ -932,10 +923,13 @@ gst_live_live_adder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   GList *item = NULL;
   GstClockTime skip = 0;
   gint64 drift = 0;             /* Positive if new buffer after old buffer */
+  gint rate, bpf;
 
   GST_OBJECT_LOCK (adder);
-
   ret = adder->srcresult;
+  rate = GST_AUDIO_INFO_RATE (&adder->info);
+  bpf = GST_AUDIO_INFO_BPF (&adder->info);
+  GST_OBJECT_UNLOCK (adder);
 
   GST_DEBUG ("Incoming buffer time:%" GST_TIME_FORMAT " duration:%"
       GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
@@ -945,22 +939,24 @@ gst_live_live_adder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     GST_DEBUG_OBJECT (adder, "Passing non-ok result from src: %s",
         gst_flow_get_name (ret));
     gst_buffer_unref (buffer);
-    goto out;
+    return ret;
   }
 
+  /* The pad private data is only modified from the streaming thread of its
+   * pad (or when it is not streaming) and only freed after the pad has been
+   * deactivated in release_pad, so everything up to the mixing is done without holding the
+   * element lock, so that the inputs don't contend on it */
   padprivate = gst_pad_get_element_private (pad);
 
   if (!padprivate) {
-    ret = GST_FLOW_NOT_LINKED;
     gst_buffer_unref (buffer);
-    goto out;
+    return GST_FLOW_NOT_LINKED;
   }
 
   if (padprivate->eos) {
     GST_DEBUG_OBJECT (adder, "Received buffer after EOS");
-    ret = GST_FLOW_EOS;
     gst_buffer_unref (buffer);
-    goto out;
+    return GST_FLOW_EOS;
   }
 
   if (!GST_BUFFER_TIMESTAMP_IS_VALID (buffer))
@@ -998,8 +994,7 @@ gst_live_live_adder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   /* If there is no duration, lets set one */
   if (!GST_BUFFER_DURATION_IS_VALID (buffer)) {
     GST_BUFFER_DURATION (buffer) = (gst_buffer_get_size (buffer) * GST_SECOND) /
-        (GST_AUDIO_INFO_BPF (&adder->info) *
-        GST_AUDIO_INFO_RATE (&adder->info));
+        (bpf * rate);
     padprivate->expected_timestamp = GST_CLOCK_TIME_NONE;
   } else {
     padprivate->expected_timestamp = GST_BUFFER_TIMESTAMP (buffer) +
@@ -1014,13 +1009,12 @@ gst_live_live_adder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
    * durations afterwards
    */
 
-  buffer = gst_audio_buffer_clip (buffer, &padprivate->segment,
-      GST_AUDIO_INFO_RATE (&adder->info), GST_AUDIO_INFO_BPF (&adder->info));
+  buffer = gst_audio_buffer_clip (buffer, &padprivate->segment, rate, bpf);
 
   /* buffer can be NULL if it's completely outside of the segment */
   if (!buffer) {
     GST_DEBUG ("Buffer completely outside of configured segment, dropping it");
-    goto out;
+    return GST_FLOW_OK;
   }
 
   /*
@@ -1030,6 +1024,17 @@ gst_live_live_adder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       gst_segment_to_running_time (&padprivate->segment,
       padprivate->segment.format, GST_BUFFER_TIMESTAMP (buffer));
 
+  GST_OBJECT_LOCK (adder);
+
+  /* the src may have been flushed or stopped while we weren't holding the
+   * lock, don't queue a stale buffer after that */
+  ret = adder->srcresult;
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (adder, "Passing non-ok result from src: %s",
+        gst_flow_get_name (ret));
+    gst_buffer_unref (buffer);
+    goto out;
+  }
 
   if (GST_CLOCK_TIME_IS_VALID (adder->next_timestamp) &&
       GST_BUFFER_TIMESTAMP (buffer) < adder->next_timestamp) {
@@ -1158,7 +1163,6 @@ out:
 
 invalid_timestamp:
 
-  GST_OBJECT_UNLOCK (adder);
   gst_buffer_unref (buffer);
   GST_ELEMENT_ERROR (adder, STREAM, FAILED,
       ("Buffer without a valid timestamp received"),
@@ -1469,15 +1473,19 @@ gst_live_adder_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (adder, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  /* deactivating takes the stream lock, so this waits for the chain function
+   * that might still be using the private data without the lock */
+  gst_pad_set_active (pad, FALSE);
+
   GST_OBJECT_LOCK (element);
   padprivate = gst_pad_get_element_private (pad);
   gst_pad_set_element_private (pad, NULL);
   adder->sinkpads = g_list_remove_all (adder->sinkpads, pad);
   GST_OBJECT_UNLOCK (element);
 
-  g_free (padprivate);
-
   gst_element_remove_pad (element, pad);
+
+  g_free (padprivate);
 }
 
 static void
@@ -66,6 +66,15 @@
 
 #define DURATION_SCAN_LIMIT         4 * 1024 * 1024
 
+/* Minimum SCR distance between two seek index entries, seeks that end up
+ * closer than this to an index entry start from that entry */
+#define SCR_INDEX_INTERVAL          (CLOCK_FREQ / 2)
+/* Number of points probed by the index scan, one after every block that is
+ * pulled on the streaming thread */
+#define INDEX_SCAN_ENTRIES          256
+
+#define DEFAULT_SCAN_INDEX          FALSE
+
 typedef enum
 {
   SCAN_SCR,
@@ -94,6 +103,7 @@ enum
 {
   ARG_0,
   ARG_SYNC,
+  ARG_SCAN_INDEX,
   /* FILL ME */
 };
 
@@ -142,6 +152,10 @@ static void gst_flups_demux_class_init (GstFluPSDemuxClass * klass);
 static void gst_flups_demux_init (GstFluPSDemux * demux);
 static void gst_flups_demux_finalize (GstFluPSDemux * demux);
 static void gst_flups_demux_reset (GstFluPSDemux * demux);
+static void gst_flups_demux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_flups_demux_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_flups_demux_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
@@ -248,6 +262,15 @@ gst_flups_demux_class_init (GstFluPSDemuxClass * klass)
   gstelement_class = (GstElementClass *) klass;
 
   gobject_class->finalize = (GObjectFinalizeFunc) gst_flups_demux_finalize;
+  gobject_class->set_property = gst_flups_demux_set_property;
+  gobject_class->get_property = gst_flups_demux_get_property;
+
+  g_object_class_install_property (gobject_class, ARG_SCAN_INDEX,
+      g_param_spec_boolean ("scan-index", "Scan index",
+          "Build the seek index for the whole file while playing, probing "
+          "one more point of the file after every block read by the streaming "
+          "thread (pull mode only)", DEFAULT_SCAN_INDEX,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state = gst_flups_demux_change_state;
 }
@@ -278,6 +301,9 @@ gst_flups_demux_init (GstFluPSDemux * demux)
   demux->adapter = gst_adapter_new ();
   demux->rev_adapter = gst_adapter_new ();
 
+  demux->scr_index = g_array_new (FALSE, FALSE, sizeof (GstFluPSIndexEntry));
+  demux->scan_index = DEFAULT_SCAN_INDEX;
+
   gst_flups_demux_reset (demux);
 }
 
@@ -290,10 +316,47 @@ gst_flups_demux_finalize (GstFluPSDemux * demux)
 
   g_object_unref (demux->adapter);
   g_object_unref (demux->rev_adapter);
+  g_array_free (demux->scr_index, TRUE);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (demux));
 }
 
+static void
+gst_flups_demux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstFluPSDemux *demux = GST_FLUPS_DEMUX (object);
+
+  switch (prop_id) {
+    case ARG_SCAN_INDEX:
+      GST_OBJECT_LOCK (demux);
+      demux->scan_index = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_flups_demux_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstFluPSDemux *demux = GST_FLUPS_DEMUX (object);
+
+  switch (prop_id) {
+    case ARG_SCAN_INDEX:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_boolean (value, demux->scan_index);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_flups_demux_reset (GstFluPSDemux * demux)
 {
@@ -340,6 +403,8 @@ gst_flups_demux_reset (GstFluPSDemux * demux)
   gst_flups_demux_flush (demux);
   demux->have_group_id = FALSE;
   demux->group_id = G_MAXUINT;
+  g_array_set_size (demux->scr_index, 0);
+  demux->index_scan_offset = 0;
 }
 
 static GstFluPSStream *
@@ -852,6 +917,7 @@ gst_flups_demux_flush (GstFluPSDemux * demux)
   gst_pes_filter_drain (&demux->filter);
   gst_flups_demux_clear_times (demux);
   demux->adapter_offset = G_MAXUINT64;
+  demux->adapter_end_offset = G_MAXUINT64;
   demux->current_scr = G_MAXUINT64;
   demux->bytes_since_scr = 0;
 }
@@ -1069,6 +1135,77 @@ not_supported:
   }
 }
 
+/* Returns the position of the first index entry with an SCR bigger
+ * than @scr */
+static guint
+gst_flups_demux_index_upper_bound (GstFluPSDemux * demux, guint64 scr)
+{
+  guint lo = 0, hi = demux->scr_index->len;
+
+  while (lo < hi) {
+    guint mid = (lo + hi) / 2;
+
+    if (g_array_index (demux->scr_index, GstFluPSIndexEntry, mid).scr <= scr)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+static void
+gst_flups_demux_index_add (GstFluPSDemux * demux, guint64 scr,
+    guint64 offset)
+{
+  GstFluPSIndexEntry entry;
+  GstFluPSIndexEntry *prev = NULL, *next = NULL;
+  guint pos;
+
+  pos = gst_flups_demux_index_upper_bound (demux, scr);
+  if (pos > 0)
+    prev = &g_array_index (demux->scr_index, GstFluPSIndexEntry, pos - 1);
+  if (pos < demux->scr_index->len)
+    next = &g_array_index (demux->scr_index, GstFluPSIndexEntry, pos);
+
+  /* Entries have to be ordered by SCR and offset at the same time, anything
+   * else is an SCR discontinuity we can't use for seeking */
+  if ((prev && prev->offset >= offset) || (next && next->offset <= offset))
+    return;
+
+  /* keep the index sparse */
+  if ((prev && scr - prev->scr < SCR_INDEX_INTERVAL) ||
+      (next && next->scr - scr < SCR_INDEX_INTERVAL))
+    return;
+
+  GST_LOG_OBJECT (demux, "adding index entry SCR %" G_GUINT64_FORMAT
+      " at offset %" G_GUINT64_FORMAT, scr, offset);
+
+  entry.scr = scr;
+  entry.offset = offset;
+  g_array_insert_val (demux->scr_index, pos, entry);
+}
+
+/* Probes one more point of the file for the seek index */
+static void
+gst_flups_demux_scan_index_step (GstFluPSDemux * demux)
+{
+  guint64 offset, scr, stride;
+
+  if (demux->sink_segment.stop == (guint64) - 1 ||
+      demux->index_scan_offset >= demux->sink_segment.stop)
+    return;
+
+  stride = MAX (demux->sink_segment.stop / INDEX_SCAN_ENTRIES, BLOCK_SZ);
+
+  offset = demux->index_scan_offset;
+  if (gst_flups_demux_scan_forward_ts (demux, &offset, SCAN_SCR, &scr,
+          BLOCK_SZ))
+    gst_flups_demux_index_add (demux, scr, offset);
+
+  demux->index_scan_offset += stride;
+}
+
 #define MAX_RECURSION_COUNT 100
 
 /* Binary search for requested SCR */
@@ -1087,6 +1224,11 @@ find_offset (GstFluPSDemux * demux, guint64 scr,
     return -1;
   }
 
+  /* close enough, start from the lower bound */
+  if (scr - min_scr <= SCR_INDEX_INTERVAL) {
+    return min_scr_offset;
+  }
+
   offset = min_scr_offset +
       MIN (gst_util_uint64_scale (scr - min_scr, scr_rate_n,
           scr_rate_d), demux->sink_segment.stop);
@@ -1098,6 +1240,10 @@ find_offset (GstFluPSDemux * demux, guint64 scr,
         gst_flups_demux_scan_backward_ts (demux, &offset, SCAN_SCR, &fscr, 0);
   }
 
+  /* remember what we found for the next seeks */
+  if (found)
+    gst_flups_demux_index_add (demux, fscr, offset);
+
   if (fscr == scr || fscr == min_scr || fscr == max_scr) {
     return offset;
   }
@@ -1117,6 +1263,8 @@ gst_flups_demux_do_seek (GstFluPSDemux * demux, GstSegment * seeksegment)
   gboolean found = FALSE;
   guint64 fscr, offset;
   guint64 scr = GSTTIME_TO_MPEGTIME (seeksegment->position + demux->base_time);
+  guint64 min_scr, min_scr_offset, max_scr, max_scr_offset;
+  guint pos;
 
   /* In some clips the PTS values are completely unaligned with SCR values.
    * To improve the seek in that situation we apply a factor considering the
@@ -1131,9 +1279,40 @@ gst_flups_demux_do_seek (GstFluPSDemux * demux, GstSegment * seeksegment)
   GST_INFO_OBJECT (demux, "sink segment configured %" GST_SEGMENT_FORMAT
       ", trying to go at SCR: %" G_GUINT64_FORMAT, &demux->sink_segment, scr);
 
+  /* narrow down the search with the index entries around the target */
+  min_scr = demux->first_scr;
+  min_scr_offset = demux->first_scr_offset;
+  max_scr = demux->last_scr;
+  max_scr_offset = demux->last_scr_offset;
+
+  pos = gst_flups_demux_index_upper_bound (demux, scr);
+  if (pos > 0) {
+    GstFluPSIndexEntry *entry =
+        &g_array_index (demux->scr_index, GstFluPSIndexEntry, pos - 1);
+
+    if (entry->scr > min_scr) {
+      min_scr = entry->scr;
+      min_scr_offset = entry->offset;
+    }
+  }
+  if (pos < demux->scr_index->len) {
+    GstFluPSIndexEntry *entry =
+        &g_array_index (demux->scr_index, GstFluPSIndexEntry, pos);
+
+    if (entry->scr < max_scr) {
+      max_scr = entry->scr;
+      max_scr_offset = entry->offset;
+    }
+  }
+
+  GST_DEBUG_OBJECT (demux, "searching between SCR %" G_GUINT64_FORMAT
+      " at %" G_GUINT64_FORMAT " and SCR %" G_GUINT64_FORMAT " at %"
+      G_GUINT64_FORMAT " (%u index entries)", min_scr, min_scr_offset,
+      max_scr, max_scr_offset, demux->scr_index->len);
+
   offset =
-      find_offset (demux, scr, demux->first_scr, demux->first_scr_offset,
-      demux->last_scr, demux->last_scr_offset, 0);
+      find_offset (demux, scr, min_scr, min_scr_offset, max_scr,
+      max_scr_offset, 0);
 
   if (offset == (guint64) - 1) {
     return FALSE;
@@ -1669,6 +1848,12 @@ gst_flups_demux_parse_pack_start (GstFluPSDemux * demux)
       scr, scr_adjusted, new_rate,
       GST_TIME_ARGS (MPEGTIME_TO_GSTTIME ((guint64) scr)));
 
+  /* index the packs we play through so later seeks can start from them */
+  if (demux->random_access && demux->sink_segment.rate >= 0.0 &&
+      demux->adapter_end_offset != G_MAXUINT64)
+    gst_flups_demux_index_add (demux, scr,
+        demux->adapter_end_offset - avail);
+
   /* keep the first src in order to calculate delta time */
   if (G_UNLIKELY (demux->first_scr == G_MAXUINT64)) {
     gint64 diff;
@@ -2800,6 +2985,7 @@ gst_flups_demux_loop (GstPad * pad)
   GstFluPSDemux *demux;
   GstFlowReturn ret = GST_FLOW_OK;
   guint64 offset = 0;
+  gboolean scan_index;
 
   demux = GST_FLUPS_DEMUX (gst_pad_get_parent (pad));
 
@@ -2828,6 +3014,12 @@ gst_flups_demux_loop (GstPad * pad)
     offset += size;
     gst_segment_set_position (&demux->sink_segment, GST_FORMAT_BYTES, offset);
 
+    GST_OBJECT_LOCK (demux);
+    scan_index = demux->scan_index;
+    GST_OBJECT_UNLOCK (demux);
+    if (G_UNLIKELY (scan_index))
+      gst_flups_demux_scan_index_step (demux);
+
     /* check EOS condition */
     if ((demux->src_segment.flags & GST_SEEK_FLAG_SEGMENT) &&
         ((demux->sink_segment.position >= demux->sink_segment.stop) ||
@@ -3076,6 +3268,12 @@ gst_flups_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   /* We keep the offset to interpolate SCR */
   demux->adapter_offset = GST_BUFFER_OFFSET (buffer);
+  if (GST_BUFFER_OFFSET_IS_VALID (buffer) &&
+      gst_adapter_available (demux->rev_adapter) == 0)
+    demux->adapter_end_offset =
+        GST_BUFFER_OFFSET (buffer) + gst_buffer_get_size (buffer);
+  else
+    demux->adapter_end_offset = G_MAXUINT64;
 
   gst_adapter_push (demux->adapter, buffer);
   demux->bytes_since_scr += gst_buffer_get_size (buffer);
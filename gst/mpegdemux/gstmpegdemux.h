@@ -80,6 +80,14 @@ typedef enum
   STATE_FLUPS_DEMUX_NEED_MORE_DATA,
 } GstFluPSDemuxState;
 
+/* An entry of the seek index, maps the SCR of a pack to the byte offset
+ * of its pack start code */
+typedef struct
+{
+  guint64 scr;
+  guint64 offset;
+} GstFluPSIndexEntry;
+
 /* Information associated with a single FluPS stream. */
 struct _GstFluPSStream
 {
@@ -113,6 +121,7 @@ struct _GstFluPSDemux
   GstAdapter *adapter;
   GstAdapter *rev_adapter;
   guint64 adapter_offset;
+  guint64 adapter_end_offset;
   guint32 last_sync_code;
   GstPESFilter filter;
 
@@ -151,6 +160,11 @@ struct _GstFluPSDemux
 
   /* Indicates an MPEG-2 stream */
   gboolean is_mpeg2_pack;
+
+  /* Seek index in pull mode, sorted by SCR */
+  GArray *scr_index;
+  gboolean scan_index;
+  guint64 index_scan_offset;
 };
 
 struct _GstFluPSDemuxClass
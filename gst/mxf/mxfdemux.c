@@ -76,6 +76,13 @@ GST_STATIC_PAD_TEMPLATE ("track_%u",
 GST_DEBUG_CATEGORY_STATIC (mxfdemux_debug);
 #define GST_CAT_DEFAULT mxfdemux_debug
 
+/* In pull mode small reads are served from aligned chunks of this size */
+#define READ_AHEAD_SIZE (256 * 1024)
+#define READ_AHEAD_ALIGN (4096)
+
+/* How long to wait for new data at the end of a growing file */
+#define GROWING_FILE_POLL_INTERVAL (100 * G_TIME_SPAN_MILLISECOND)
+
 GType gst_mxf_demux_pad_get_type (void);
 G_DEFINE_TYPE (GstMXFDemuxPad, gst_mxf_demux_pad, GST_TYPE_PAD);
 
@@ -112,7 +119,8 @@ enum
   PROP_0,
   PROP_PACKAGE,
   PROP_MAX_DRIFT,
-  PROP_STRUCTURE
+  PROP_STRUCTURE,
+  PROP_GROWING_FILE
 };
 
 static gboolean gst_mxf_demux_sink_event (GstPad * pad, GstObject * parent,
@@ -168,6 +176,8 @@ gst_mxf_demux_reset_mxf_state (GstMXFDemux * demux)
 
     if (t->offsets)
       g_array_free (t->offsets, TRUE);
+    if (t->keyframes)
+      g_array_free (t->keyframes, TRUE);
 
     g_free (t->mapping_data);
 
@@ -223,6 +233,14 @@ gst_mxf_demux_reset_metadata (GstMXFDemux * demux)
   }
   demux->metadata = mxf_metadata_hash_table_new ();
 
+  if (demux->metadata_data) {
+    g_hash_table_destroy (demux->metadata_data);
+  }
+  demux->metadata_data =
+      g_hash_table_new_full ((GHashFunc) mxf_uuid_hash,
+      (GEqualFunc) mxf_uuid_is_equal, (GDestroyNotify) g_free,
+      (GDestroyNotify) g_bytes_unref);
+
   if (demux->tags) {
     gst_tag_list_unref (demux->tags);
     demux->tags = NULL;
@@ -263,17 +281,21 @@ gst_mxf_demux_reset (GstMXFDemux * demux)
     demux->random_index_pack = NULL;
   }
 
-  if (demux->pending_index_table_segments) {
-    GList *l;
+  if (demux->index_table_segments) {
+    guint i;
 
-    for (l = demux->pending_index_table_segments; l; l = l->next) {
-      MXFIndexTableSegment *s = l->data;
-      mxf_index_table_segment_reset (s);
-      g_free (s);
+    for (i = 0; i < demux->index_table_segments->len; i++) {
+      GstMXFDemuxIndexTableSegment *s =
+          &g_array_index (demux->index_table_segments,
+          GstMXFDemuxIndexTableSegment, i);
+      mxf_index_table_segment_reset (&s->segment);
     }
-    g_list_free (demux->pending_index_table_segments);
-    demux->pending_index_table_segments = NULL;
+    g_array_free (demux->index_table_segments, TRUE);
+    demux->index_table_segments = NULL;
   }
+  demux->pulled_index_table_segments = FALSE;
+
+  gst_buffer_replace (&demux->read_ahead, NULL);
 
   gst_mxf_demux_reset_mxf_state (demux);
   gst_mxf_demux_reset_metadata (demux);
@@ -320,29 +342,99 @@ gst_mxf_demux_pull_range (GstMXFDemux * demux, guint64 offset,
     guint size, GstBuffer ** buffer)
 {
   GstFlowReturn ret;
+  guint64 chunk_offset;
+  guint chunk_size;
+  GstBuffer *chunk = NULL;
+  GstBuffer *prefix = NULL;
+
+  if (demux->read_ahead && offset >= demux->read_ahead_offset) {
+    guint64 read_ahead_end =
+        demux->read_ahead_offset + gst_buffer_get_size (demux->read_ahead);
+
+    /* Serve from the read-ahead chunk if possible */
+    if (offset + size <= read_ahead_end) {
+      *buffer =
+          gst_buffer_copy_region (demux->read_ahead, GST_BUFFER_COPY_ALL,
+          offset - demux->read_ahead_offset, size);
+      return GST_FLOW_OK;
+    }
 
-  ret = gst_pad_pull_range (demux->sinkpad, offset, size, buffer);
+    /* A read starting inside the chunk, usually a KLV value right after the
+     * key and length that were read from it, takes the part we already
+     * have and only pulls the rest */
+    if (offset < read_ahead_end) {
+      guint prefix_size = read_ahead_end - offset;
+
+      prefix =
+          gst_buffer_copy_region (demux->read_ahead, GST_BUFFER_COPY_ALL,
+          offset - demux->read_ahead_offset, prefix_size);
+      offset += prefix_size;
+      size -= prefix_size;
+    }
+  }
+
+  /* Large reads don't benefit from reading ahead */
+  if (size >= READ_AHEAD_SIZE) {
+    chunk_offset = offset;
+    chunk_size = size;
+  } else {
+    chunk_offset = offset - offset % READ_AHEAD_ALIGN;
+    chunk_size = MAX (READ_AHEAD_SIZE, offset + size - chunk_offset);
+  }
+
+  ret = gst_pad_pull_range (demux->sinkpad, chunk_offset, chunk_size, &chunk);
   if (G_UNLIKELY (ret != GST_FLOW_OK)) {
     GST_WARNING_OBJECT (demux,
         "failed when pulling %u bytes from offset %" G_GUINT64_FORMAT ": %s",
         size, offset, gst_flow_get_name (ret));
+    if (prefix)
+      gst_buffer_unref (prefix);
     *buffer = NULL;
     return ret;
   }
 
-  if (G_UNLIKELY (*buffer && gst_buffer_get_size (*buffer) != size)) {
+  if (G_UNLIKELY (gst_buffer_get_size (chunk) < offset + size - chunk_offset)) {
     GST_WARNING_OBJECT (demux,
         "partial pull got %" G_GSIZE_FORMAT " when expecting %u from offset %"
-        G_GUINT64_FORMAT, gst_buffer_get_size (*buffer), size, offset);
-    gst_buffer_unref (*buffer);
+        G_GUINT64_FORMAT, gst_buffer_get_size (chunk), chunk_size,
+        chunk_offset);
+    gst_buffer_unref (chunk);
+    if (prefix)
+      gst_buffer_unref (prefix);
     ret = GST_FLOW_EOS;
     *buffer = NULL;
     return ret;
   }
 
+  if (chunk_offset == offset && chunk_size == size) {
+    *buffer = chunk;
+  } else {
+    /* Near the end of the file the chunk can be shorter than requested */
+    gst_buffer_replace (&demux->read_ahead, chunk);
+    demux->read_ahead_offset = chunk_offset;
+    gst_buffer_unref (chunk);
+
+    *buffer =
+        gst_buffer_copy_region (demux->read_ahead, GST_BUFFER_COPY_ALL,
+        offset - chunk_offset, size);
+  }
+
+  /* The memory of both parts is shared, nothing is copied */
+  if (prefix)
+    *buffer = gst_buffer_append (prefix, *buffer);
+
   return ret;
 }
 
+/* A growing file is finished once its footer partition was seen */
+static gboolean
+gst_mxf_demux_is_growing (GstMXFDemux * demux)
+{
+  return demux->growing_file && demux->random_access
+      && demux->footer_partition_pack_offset == 0
+      && !demux->random_index_pack;
+}
+
 static gboolean
 gst_mxf_demux_push_src_event (GstMXFDemux * demux, GstEvent * event)
 {
@@ -433,6 +525,9 @@ gst_mxf_demux_handle_partition_pack (GstMXFDemux * demux, const MXFUL * key,
 
   if (partition.type == MXF_PARTITION_PACK_HEADER)
     demux->footer_partition_pack_offset = partition.footer_partition;
+  else if (partition.type == MXF_PARTITION_PACK_FOOTER
+      && demux->footer_partition_pack_offset == 0)
+    demux->footer_partition_pack_offset = partition.this_partition;
 
   for (l = demux->partitions; l; l = l->next) {
     GstMXFDemuxPartition *tmp = l->data;
@@ -670,6 +765,253 @@ done:
   return ret;
 }
 
+static gint
+gst_mxf_demux_index_table_segment_compare (const GstMXFDemuxIndexTableSegment *
+    a, const GstMXFDemuxIndexTableSegment * b)
+{
+  if (a->segment.body_sid != b->segment.body_sid)
+    return (a->segment.body_sid < b->segment.body_sid) ? -1 : 1;
+  if (a->segment.index_sid != b->segment.index_sid)
+    return (a->segment.index_sid < b->segment.index_sid) ? -1 : 1;
+  if (a->segment.index_start_position != b->segment.index_start_position)
+    return (a->segment.index_start_position <
+        b->segment.index_start_position) ? -1 : 1;
+
+  return 0;
+}
+
+/* Returns the index in etrack->keyframes of the last keyframe at or before
+ * position, or -1 */
+static gint
+gst_mxf_demux_find_keyframe (GstMXFDemuxEssenceTrack * etrack,
+    gint64 position)
+{
+  guint lo = 0, hi;
+
+  if (!etrack->keyframes)
+    return -1;
+
+  hi = etrack->keyframes->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (etrack->keyframes, gint64, mid) <= position)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return (gint) lo - 1;
+}
+
+static void
+gst_mxf_demux_set_keyframe (GstMXFDemuxEssenceTrack * etrack,
+    gint64 position, gboolean keyframe)
+{
+  gint i = gst_mxf_demux_find_keyframe (etrack, position);
+  gboolean found = (i >= 0
+      && g_array_index (etrack->keyframes, gint64, i) == position);
+
+  if (keyframe && !found) {
+    if (!etrack->keyframes)
+      etrack->keyframes = g_array_new (FALSE, FALSE, sizeof (gint64));
+    g_array_insert_val (etrack->keyframes, i + 1, position);
+  } else if (!keyframe && found) {
+    g_array_remove_index (etrack->keyframes, i);
+  }
+}
+
+/* Fills the offsets of all essence tracks of the segment's body
+ * with the stream offsets of the segment's index entries, mapped to
+ * file offsets via the partitions we know the essence start of */
+static void
+gst_mxf_demux_resolve_index_table_segment (GstMXFDemux * demux,
+    GstMXFDemuxIndexTableSegment * s)
+{
+  MXFIndexTableSegment *segment = &s->segment;
+  GList *l;
+  guint i, j;
+  gboolean complete = TRUE, found_track = FALSE;
+
+  if (s->resolved)
+    return;
+
+  /* CBE segments are handled by peeking at the essence */
+  if (segment->n_index_entries == 0 || segment->body_sid == 0
+      || segment->index_start_position < 0) {
+    s->resolved = TRUE;
+    return;
+  }
+
+  for (l = demux->partitions; l; l = l->next) {
+    GstMXFDemuxPartition *p = l->data;
+
+    if (p->partition.body_sid == segment->body_sid)
+      break;
+  }
+
+  for (i = 0; i < segment->n_index_entries; i++) {
+    MXFIndexEntry *entry = &segment->index_entries[i];
+    gint64 position = segment->index_start_position + i;
+    guint64 offset = 0;
+
+    while (l) {
+      GstMXFDemuxPartition *p = l->data;
+      guint64 next_partition = G_MAXUINT64;
+
+      if (l->next)
+        next_partition =
+            ((GstMXFDemuxPartition *) l->next->data)->partition.this_partition;
+
+      if (p->partition.major_version != 0 && p->essence_container_offset != 0) {
+        if (entry->stream_offset < p->partition.body_offset)
+          break;
+
+        offset = p->partition.this_partition + p->essence_container_offset +
+            (entry->stream_offset - p->partition.body_offset);
+        if (offset < next_partition)
+          break;
+        offset = 0;
+      }
+
+      /* Not in this partition, try the next one of this body */
+      for (l = l->next; l; l = l->next) {
+        GstMXFDemuxPartition *tmp = l->data;
+
+        if (tmp->partition.body_sid == segment->body_sid)
+          break;
+      }
+    }
+
+    if (offset == 0) {
+      complete = FALSE;
+      continue;
+    }
+
+    for (j = 0; j < demux->essence_tracks->len; j++) {
+      GstMXFDemuxEssenceTrack *etrack =
+          &g_array_index (demux->essence_tracks, GstMXFDemuxEssenceTrack, j);
+      GstMXFDemuxIndex *idx;
+
+      if (etrack->body_sid != segment->body_sid || !etrack->source_track)
+        continue;
+
+      /* Only frame wrapped essence has one element per edit unit */
+      if ((gint64) etrack->source_track->edit_rate.n *
+          segment->index_edit_rate.d !=
+          (gint64) segment->index_edit_rate.n *
+          etrack->source_track->edit_rate.d)
+        continue;
+
+      found_track = TRUE;
+
+      if (!etrack->offsets)
+        etrack->offsets = g_array_new (FALSE, TRUE, sizeof (GstMXFDemuxIndex));
+      if ((gint64) etrack->offsets->len <= position)
+        g_array_set_size (etrack->offsets, position + 1);
+
+      idx = &g_array_index (etrack->offsets, GstMXFDemuxIndex, position);
+      if (idx->offset != 0)
+        continue;
+
+      idx->offset = offset;
+      /* The random access flag is about the picture of the edit unit,
+       * all elements of other tracks can be decoded on their own */
+      idx->keyframe = (entry->flags & 0x80)
+          || etrack->source_track->parent.type !=
+          MXF_METADATA_TRACK_PICTURE_ESSENCE;
+      idx->from_index = TRUE;
+      gst_mxf_demux_set_keyframe (etrack, position, idx->keyframe);
+    }
+  }
+
+  s->resolved = complete && found_track;
+
+  GST_DEBUG_OBJECT (demux, "Index table segment for body %u starting at %"
+      G_GINT64_FORMAT " with %u entries %s", segment->body_sid,
+      segment->index_start_position, segment->n_index_entries,
+      s->resolved ? "resolved" : "not resolved yet");
+}
+
+static void
+gst_mxf_demux_resolve_index_table_segments (GstMXFDemux * demux)
+{
+  guint i;
+
+  if (!demux->index_table_segments)
+    return;
+
+  for (i = 0; i < demux->index_table_segments->len; i++) {
+    GstMXFDemuxIndexTableSegment *s =
+        &g_array_index (demux->index_table_segments,
+        GstMXFDemuxIndexTableSegment, i);
+
+    gst_mxf_demux_resolve_index_table_segment (demux, s);
+  }
+}
+
+/* Returns the essence track position of the element at offset, or -1 */
+static gint64
+gst_mxf_demux_find_index_position (GstMXFDemuxEssenceTrack * etrack,
+    guint64 offset)
+{
+  gint lo = 0, hi, found = -1, start = 0, i;
+  GstMXFDemuxIndex *idx;
+
+  if (!etrack->offsets || etrack->offsets->len == 0)
+    return -1;
+
+  /* Offsets are increasing but not all positions are known. Keyframes
+   * always have a known offset, so find the last keyframe before or at
+   * offset and look for the last known position from there on. This
+   * stops at the next keyframe at the latest */
+  if (etrack->keyframes) {
+    hi = etrack->keyframes->len;
+    while (lo < hi) {
+      gint mid = lo + (hi - lo) / 2;
+      gint64 position = g_array_index (etrack->keyframes, gint64, mid);
+
+      if (g_array_index (etrack->offsets, GstMXFDemuxIndex,
+              position).offset <= offset)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo > 0)
+      start = g_array_index (etrack->keyframes, gint64, lo - 1);
+  }
+
+  for (i = start; i < (gint) etrack->offsets->len; i++) {
+    idx = &g_array_index (etrack->offsets, GstMXFDemuxIndex, i);
+
+    if (idx->offset == 0)
+      continue;
+    if (idx->offset > offset)
+      break;
+    found = i;
+  }
+
+  if (found == -1)
+    return -1;
+
+  idx = &g_array_index (etrack->offsets, GstMXFDemuxIndex, found);
+  if (idx->offset == offset)
+    return found;
+
+  /* Index table entries point to the start of the edit unit, the
+   * element can be anywhere before the next edit unit */
+  if (!idx->from_index)
+    return -1;
+
+  if (found + 1 < (gint) etrack->offsets->len) {
+    idx = &g_array_index (etrack->offsets, GstMXFDemuxIndex, found + 1);
+    if (idx->offset == 0)
+      return -1;
+  }
+
+  return found;
+}
+
 static GstFlowReturn
 gst_mxf_demux_update_essence_tracks (GstMXFDemux * demux)
 {
@@ -903,6 +1245,8 @@ gst_mxf_demux_update_essence_tracks (GstMXFDemux * demux)
 
   }
 
+  gst_mxf_demux_resolve_index_table_segments (demux);
+
   return GST_FLOW_OK;
 }
 
@@ -1275,6 +1619,7 @@ gst_mxf_demux_handle_metadata (GstMXFDemux * demux, const MXFUL * key,
 {
   guint16 type;
   MXFMetadata *metadata = NULL, *old = NULL;
+  GBytes *data;
   GstMapInfo map;
   GstFlowReturn ret = GST_FLOW_OK;
 
@@ -1343,6 +1688,28 @@ gst_mxf_demux_handle_metadata (GstMXFDemux * demux, const MXFUL * key,
     return GST_FLOW_OK;
   }
 
+  /* Header metadata is repeated in later partitions, usually with most
+   * sets unchanged. Only changed sets require resolving everything again */
+  data = g_hash_table_lookup (demux->metadata_data,
+      &MXF_METADATA_BASE (metadata)->instance_uid);
+  if (old && data && g_bytes_get_size (data) == gst_buffer_get_size (buffer)
+      && gst_buffer_memcmp (buffer, 0, g_bytes_get_data (data, NULL),
+          g_bytes_get_size (data)) == 0) {
+    MXF_METADATA_BASE (old)->offset = MXF_METADATA_BASE (metadata)->offset;
+    g_object_unref (metadata);
+    return GST_FLOW_OK;
+  }
+
+  {
+    gsize size = gst_buffer_get_size (buffer);
+    guint8 *copy = g_malloc (size);
+
+    gst_buffer_extract (buffer, 0, copy, size);
+    g_hash_table_replace (demux->metadata_data,
+        g_memdup (&MXF_METADATA_BASE (metadata)->instance_uid,
+            sizeof (MXFUUID)), g_bytes_new_take (copy, size));
+  }
+
   g_rw_lock_writer_lock (&demux->metadata_lock);
   demux->update_metadata = TRUE;
 
@@ -1667,17 +2034,9 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
   if (etrack->position == -1) {
     GST_DEBUG_OBJECT (demux,
         "Unknown essence track position, looking into index");
-    if (etrack->offsets) {
-      for (i = 0; i < etrack->offsets->len; i++) {
-        GstMXFDemuxIndex *idx =
-            &g_array_index (etrack->offsets, GstMXFDemuxIndex, i);
-
-        if (idx->offset != 0 && idx->offset == demux->offset - demux->run_in) {
-          etrack->position = i;
-          break;
-        }
-      }
-    }
+    etrack->position =
+        gst_mxf_demux_find_index_position (etrack,
+        demux->offset - demux->run_in);
 
     if (etrack->position == -1) {
       GST_WARNING_OBJECT (demux, "Essence track position not in index");
@@ -1686,8 +2045,13 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
   }
 
   if (etrack->offsets && etrack->offsets->len > etrack->position) {
-    keyframe = g_array_index (etrack->offsets, GstMXFDemuxIndex,
-        etrack->position).keyframe;
+    GstMXFDemuxIndex *idx =
+        &g_array_index (etrack->offsets, GstMXFDemuxIndex, etrack->position);
+
+    if (etrack->source_track
+        && etrack->source_track->parent.type ==
+        MXF_METADATA_TRACK_PICTURE_ESSENCE)
+      keyframe = idx->keyframe;
   }
 
   /* Create subbuffer to be able to change metadata */
@@ -1730,17 +2094,27 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
       GstMXFDemuxIndex *index =
           &g_array_index (etrack->offsets, GstMXFDemuxIndex, etrack->position);
 
-      index->offset = demux->offset - demux->run_in;
-      index->keyframe = keyframe;
+      /* Entries from index table segments are authoritative */
+      if (!index->from_index) {
+        index->offset = demux->offset - demux->run_in;
+        index->keyframe = keyframe;
+        gst_mxf_demux_set_keyframe (etrack, etrack->position, keyframe);
+      }
     } else {
       GstMXFDemuxIndex index;
 
       index.offset = demux->offset - demux->run_in;
       index.keyframe = keyframe;
+      index.from_index = FALSE;
       g_array_insert_val (etrack->offsets, etrack->position, index);
+      gst_mxf_demux_set_keyframe (etrack, etrack->position, keyframe);
     }
   }
 
+  if (etrack->duration > 0 && etrack->position >= etrack->duration
+      && gst_mxf_demux_is_growing (demux))
+    etrack->duration = etrack->position + 1;
+
   if (peek)
     goto out;
 
@@ -1850,7 +2224,10 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
 
     pad->current_essence_track_position++;
 
-    if (pad->current_component) {
+    /* Durations are only preliminary while the file is still growing */
+    if (gst_mxf_demux_is_growing (demux)) {
+      /* Nothing to do */
+    } else if (pad->current_component) {
       if (pad->current_component_duration > 0 &&
           pad->current_essence_track_position - pad->current_component_start
           >= pad->current_component_duration) {
@@ -1978,9 +2355,10 @@ static GstFlowReturn
 gst_mxf_demux_handle_index_table_segment (GstMXFDemux * demux,
     const MXFUL * key, GstBuffer * buffer)
 {
-  MXFIndexTableSegment *segment;
+  GstMXFDemuxIndexTableSegment s, *tmp;
   GstMapInfo map;
   gboolean ret;
+  guint lo, hi;
 
   GST_DEBUG_OBJECT (demux,
       "Handling index table segment of size %" G_GSIZE_FORMAT " at offset %"
@@ -1990,10 +2368,10 @@ gst_mxf_demux_handle_index_table_segment (GstMXFDemux * demux,
     GST_WARNING_OBJECT (demux, "Invalid primer pack");
   }
 
-  segment = g_new0 (MXFIndexTableSegment, 1);
+  memset (&s, 0, sizeof (s));
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
-  ret = mxf_index_table_segment_parse (key, segment,
+  ret = mxf_index_table_segment_parse (key, &s.segment,
       &demux->current_partition->primer, map.data, map.size);
   gst_buffer_unmap (buffer, &map);
 
@@ -2002,20 +2380,56 @@ gst_mxf_demux_handle_index_table_segment (GstMXFDemux * demux,
     return GST_FLOW_ERROR;
   }
 
-  demux->pending_index_table_segments =
-      g_list_prepend (demux->pending_index_table_segments, segment);
+  if (!demux->index_table_segments)
+    demux->index_table_segments =
+        g_array_new (FALSE, FALSE, sizeof (GstMXFDemuxIndexTableSegment));
 
+  /* Keep the segments sorted, the same segment is usually repeated in
+   * several partitions and only the most complete one is kept */
+  lo = 0;
+  hi = demux->index_table_segments->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    gint cmp;
+
+    tmp = &g_array_index (demux->index_table_segments,
+        GstMXFDemuxIndexTableSegment, mid);
+    cmp = gst_mxf_demux_index_table_segment_compare (tmp, &s);
+
+    if (cmp == 0) {
+      if (tmp->segment.n_index_entries >= s.segment.n_index_entries) {
+        GST_DEBUG_OBJECT (demux, "Already have this index table segment");
+        mxf_index_table_segment_reset (&s.segment);
+        return GST_FLOW_OK;
+      }
+
+      mxf_index_table_segment_reset (&tmp->segment);
+      *tmp = s;
+      gst_mxf_demux_resolve_index_table_segment (demux, tmp);
+      return GST_FLOW_OK;
+    } else if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  g_array_insert_val (demux->index_table_segments, lo, s);
+  tmp = &g_array_index (demux->index_table_segments,
+      GstMXFDemuxIndexTableSegment, lo);
+  gst_mxf_demux_resolve_index_table_segment (demux, tmp);
 
   return GST_FLOW_OK;
 }
 
+/* Pulls only the key and length of the KLV packet at offset */
 static GstFlowReturn
-gst_mxf_demux_pull_klv_packet (GstMXFDemux * demux, guint64 offset, MXFUL * key,
-    GstBuffer ** outbuf, guint * read)
+gst_mxf_demux_pull_klv_header (GstMXFDemux * demux, guint64 offset, MXFUL * key,
+    guint * data_offset_out, guint64 * length_out)
 {
   GstBuffer *buffer = NULL;
   const guint8 *data;
-  guint64 data_offset = 0;
+  guint data_offset = 0;
   guint64 length;
   GstFlowReturn ret = GST_FLOW_OK;
   GstMapInfo map;
@@ -2089,21 +2503,39 @@ gst_mxf_demux_pull_klv_packet (GstMXFDemux * demux, guint64 offset, MXFUL * key,
   GST_DEBUG_OBJECT (demux, "KLV packet with key %s has length "
       "%" G_GUINT64_FORMAT, mxf_ul_to_string (key, str), length);
 
+  *data_offset_out = data_offset;
+  *length_out = length;
+
+beach:
+  if (buffer)
+    gst_buffer_unref (buffer);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_mxf_demux_pull_klv_packet (GstMXFDemux * demux, guint64 offset, MXFUL * key,
+    GstBuffer ** outbuf, guint * read)
+{
+  GstBuffer *buffer = NULL;
+  guint data_offset = 0;
+  guint64 length;
+  GstFlowReturn ret;
+
+  if ((ret = gst_mxf_demux_pull_klv_header (demux, offset, key, &data_offset,
+              &length)) != GST_FLOW_OK)
+    return ret;
+
   /* Pull the complete KLV packet */
   if ((ret = gst_mxf_demux_pull_range (demux, offset + data_offset, length,
               &buffer)) != GST_FLOW_OK)
-    goto beach;
+    return ret;
 
   *outbuf = buffer;
-  buffer = NULL;
   if (read)
     *read = data_offset + length;
 
-beach:
-  if (buffer)
-    gst_buffer_unref (buffer);
-
-  return ret;
+  return GST_FLOW_OK;
 }
 
 static void
@@ -2346,6 +2778,103 @@ out:
   demux->current_partition = old_partition;
 }
 
+/* Collects the index table segments of all partitions we know about and
+ * the essence start offset of each partition to be able to seek without
+ * peeking at all essence elements */
+static void
+gst_mxf_demux_pull_index_table_segments (GstMXFDemux * demux)
+{
+  guint64 old_offset = demux->offset;
+  GstMXFDemuxPartition *old_partition = demux->current_partition;
+  GList *l;
+
+  demux->pulled_index_table_segments = TRUE;
+
+  for (l = demux->partitions; l; l = l->next) {
+    GstMXFDemuxPartition *p = l->data;
+    guint64 next_partition = G_MAXUINT64;
+    GstBuffer *buffer = NULL;
+    MXFUL key;
+    guint read = 0, data_offset = 0;
+    guint64 length = 0;
+    GstFlowReturn ret;
+
+    if (l->next)
+      next_partition = demux->run_in +
+          ((GstMXFDemuxPartition *) l->next->data)->partition.this_partition;
+
+    demux->offset = demux->run_in + p->partition.this_partition;
+    ret =
+        gst_mxf_demux_pull_klv_packet (demux, demux->offset, &key, &buffer,
+        &read);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      break;
+
+    if (!mxf_is_partition_pack (&key)
+        || gst_mxf_demux_handle_partition_pack (demux, &key,
+            buffer) != GST_FLOW_OK) {
+      gst_buffer_unref (buffer);
+      continue;
+    }
+    gst_buffer_unref (buffer);
+    buffer = NULL;
+    p = demux->current_partition;
+    demux->offset += read;
+
+    if (p->partition.index_byte_count == 0 && (p->partition.body_sid == 0
+            || p->essence_container_offset != 0))
+      continue;
+
+    /* Skip the header metadata, it starts with the primer pack after
+     * the fill following the partition pack */
+    if (p->partition.header_byte_count != 0) {
+      while ((ret = gst_mxf_demux_pull_klv_header (demux, demux->offset, &key,
+                  &data_offset, &length)) == GST_FLOW_OK && mxf_is_fill (&key))
+        demux->offset += data_offset + length;
+      if (ret != GST_FLOW_OK)
+        continue;
+
+      demux->offset += p->partition.header_byte_count;
+    }
+
+    while (demux->offset < next_partition) {
+      ret =
+          gst_mxf_demux_pull_klv_header (demux, demux->offset, &key,
+          &data_offset, &length);
+      if (G_UNLIKELY (ret != GST_FLOW_OK))
+        break;
+
+      if (mxf_is_index_table_segment (&key)) {
+        ret =
+            gst_mxf_demux_pull_range (demux, demux->offset + data_offset,
+            length, &buffer);
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          break;
+
+        gst_mxf_demux_handle_index_table_segment (demux, &key, buffer);
+        gst_buffer_unref (buffer);
+        buffer = NULL;
+      } else if (mxf_is_generic_container_system_item (&key) ||
+          mxf_is_generic_container_essence_element (&key) ||
+          mxf_is_avid_essence_container_essence_element (&key)) {
+        if (p->essence_container_offset == 0)
+          p->essence_container_offset =
+              demux->offset - p->partition.this_partition - demux->run_in;
+        break;
+      } else if (!mxf_is_fill (&key)) {
+        break;
+      }
+
+      demux->offset += data_offset + length;
+    }
+  }
+
+  demux->offset = old_offset;
+  demux->current_partition = old_partition;
+
+  gst_mxf_demux_resolve_index_table_segments (demux);
+}
+
 static GstFlowReturn
 gst_mxf_demux_handle_klv_packet (GstMXFDemux * demux, const MXFUL * key,
     GstBuffer * buffer, gboolean peek)
@@ -2368,6 +2897,11 @@ gst_mxf_demux_handle_klv_packet (GstMXFDemux * demux, const MXFUL * key,
         (ret = gst_mxf_demux_update_tracks (demux)) != GST_FLOW_OK) {
       goto beach;
     }
+
+    /* Updated header metadata of a growing file has new durations */
+    if (gst_mxf_demux_is_growing (demux))
+      gst_element_post_message (GST_ELEMENT_CAST (demux),
+          gst_message_new_duration_changed (GST_OBJECT_CAST (demux)));
   } else if (demux->metadata_resolved && demux->requested_package_string) {
     if ((ret = gst_mxf_demux_update_tracks (demux)) != GST_FLOW_OK) {
       goto beach;
@@ -2491,7 +3025,8 @@ gst_mxf_demux_find_essence_element (GstMXFDemux * demux,
 
 from_index:
 
-  if (etrack->duration > 0 && *position >= etrack->duration) {
+  if (etrack->duration > 0 && *position >= etrack->duration
+      && !gst_mxf_demux_is_growing (demux)) {
     GST_WARNING_OBJECT (demux, "Position after end of essence track");
     return -1;
   }
@@ -2506,20 +3041,12 @@ from_index:
     if (idx->offset != 0 && (!keyframe || idx->keyframe)) {
       current_offset = idx->offset;
     } else if (idx->offset != 0) {
-      current_position--;
-      while (current_position >= 0) {
-        idx =
-            &g_array_index (etrack->offsets, GstMXFDemuxIndex,
-            current_position);
-        if (idx->offset == 0) {
-          break;
-        } else if (!idx->keyframe) {
-          current_position--;
-          continue;
-        } else {
-          current_offset = idx->offset;
-          break;
-        }
+      gint k = gst_mxf_demux_find_keyframe (etrack, current_position);
+
+      if (k >= 0) {
+        current_position = g_array_index (etrack->keyframes, gint64, k);
+        current_offset = g_array_index (etrack->offsets, GstMXFDemuxIndex,
+            current_position).offset;
       }
     }
 
@@ -2537,11 +3064,11 @@ from_index:
     gint64 new_position = -1;
 
     if (etrack->offsets && etrack->offsets->len) {
-      for (i = etrack->offsets->len - 1; i >= 0; i--) {
+      for (i = MIN (etrack->offsets->len - 1, *position); i >= 0; i--) {
         GstMXFDemuxIndex *idx =
             &g_array_index (etrack->offsets, GstMXFDemuxIndex, i);
 
-        if (idx->offset != 0 && i <= *position && (!keyframe || idx->keyframe)) {
+        if (idx->offset != 0 && (!keyframe || idx->keyframe)) {
           new_offset = idx->offset;
           new_position = i;
           break;
@@ -2556,11 +3083,11 @@ from_index:
   } else if (demux->random_access) {
     demux->offset = demux->run_in;
     if (etrack->offsets && etrack->offsets->len) {
-      for (i = etrack->offsets->len - 1; i >= 0; i--) {
+      for (i = MIN (etrack->offsets->len - 1, *position); i >= 0; i--) {
         GstMXFDemuxIndex *idx =
             &g_array_index (etrack->offsets, GstMXFDemuxIndex, i);
 
-        if (idx->offset != 0 && i <= *position) {
+        if (idx->offset != 0) {
           demux->offset = idx->offset + demux->run_in;
           break;
         }
@@ -2587,7 +3114,7 @@ from_index:
           gst_mxf_demux_pull_klv_packet (demux, demux->offset, &key, &buffer,
           &read);
 
-      if (ret == GST_FLOW_EOS) {
+      if (ret == GST_FLOW_EOS && !gst_mxf_demux_is_growing (demux)) {
         for (i = 0; i < demux->essence_tracks->len; i++) {
           GstMXFDemuxEssenceTrack *t =
               &g_array_index (demux->essence_tracks, GstMXFDemuxEssenceTrack,
@@ -2667,7 +3194,11 @@ gst_mxf_demux_pull_and_handle_klv_packet (GstMXFDemux * demux)
       gst_mxf_demux_pull_klv_packet (demux, demux->offset, &key, &buffer,
       &read);
 
-  if (ret == GST_FLOW_EOS && demux->src->len > 0) {
+  if (ret == GST_FLOW_EOS && gst_mxf_demux_is_growing (demux)) {
+    GST_LOG_OBJECT (demux, "No complete KLV packet at offset %"
+        G_GUINT64_FORMAT " of growing file yet", demux->offset);
+    goto beach;
+  } else if (ret == GST_FLOW_EOS && demux->src->len > 0) {
     guint i;
     GstMXFDemuxPad *p = NULL;
 
@@ -2780,6 +3311,17 @@ beach:
   return ret;
 }
 
+/* Interrupts the wait for new data of a growing file so that the
+ * streaming task can be paused or stopped right away */
+static void
+gst_mxf_demux_cancel_poll (GstMXFDemux * demux, gboolean cancel)
+{
+  g_mutex_lock (&demux->poll_lock);
+  demux->poll_cancelled = cancel;
+  g_cond_signal (&demux->poll_cond);
+  g_mutex_unlock (&demux->poll_lock);
+}
+
 static void
 gst_mxf_demux_loop (GstPad * pad)
 {
@@ -2834,6 +3376,22 @@ gst_mxf_demux_loop (GstPad * pad)
   /* Now actually do something */
   ret = gst_mxf_demux_pull_and_handle_klv_packet (demux);
 
+  /* Wait for the writer if we're at the end of a growing file */
+  if (ret == GST_FLOW_EOS && gst_mxf_demux_is_growing (demux)
+      && (demux->src->len == 0 || gst_mxf_demux_get_earliest_pad (demux))) {
+    gint64 end_time = g_get_monotonic_time () + GROWING_FILE_POLL_INTERVAL;
+
+    gst_buffer_replace (&demux->read_ahead, NULL);
+    g_mutex_lock (&demux->poll_lock);
+    while (!demux->poll_cancelled) {
+      if (!g_cond_wait_until (&demux->poll_cond, &demux->poll_lock, end_time))
+        break;
+    }
+    g_mutex_unlock (&demux->poll_lock);
+    gst_object_unref (demux);
+    return;
+  }
+
   /* pause if something went wrong */
   if (G_UNLIKELY (ret != GST_FLOW_OK))
     goto pause;
@@ -3340,6 +3898,8 @@ gst_mxf_demux_seek_pull (GstMXFDemux * demux, GstEvent * event)
   flush = ! !(flags & GST_SEEK_FLAG_FLUSH);
   keyframe = ! !(flags & GST_SEEK_FLAG_KEY_UNIT);
 
+  gst_mxf_demux_cancel_poll (demux, TRUE);
+
   if (flush) {
     GstEvent *e;
 
@@ -3357,6 +3917,10 @@ gst_mxf_demux_seek_pull (GstMXFDemux * demux, GstEvent * event)
   /* Take the stream lock */
   GST_PAD_STREAM_LOCK (demux->sinkpad);
 
+  gst_mxf_demux_cancel_poll (demux, FALSE);
+
+  gst_buffer_replace (&demux->read_ahead, NULL);
+
   if (flush) {
     GstEvent *e;
 
@@ -3389,6 +3953,9 @@ gst_mxf_demux_seek_pull (GstMXFDemux * demux, GstEvent * event)
       }
     }
 
+    if (!demux->pulled_index_table_segments)
+      gst_mxf_demux_pull_index_table_segments (demux);
+
     /* Do the actual seeking */
     for (i = 0; i < demux->src->len; i++) {
       GstMXFDemuxPad *p = g_ptr_array_index (demux->src, i);
@@ -3708,10 +4275,12 @@ gst_mxf_demux_sink_activate_mode (GstPad * sinkpad, GstObject * parent,
   } else {
     if (active) {
       demux->random_access = TRUE;
+      gst_mxf_demux_cancel_poll (demux, FALSE);
       return gst_pad_start_task (sinkpad, (GstTaskFunction) gst_mxf_demux_loop,
           sinkpad, NULL);
     } else {
       demux->random_access = FALSE;
+      gst_mxf_demux_cancel_poll (demux, TRUE);
       return gst_pad_stop_task (sinkpad);
     }
   }
@@ -4012,6 +4581,9 @@ gst_mxf_demux_set_property (GObject * object, guint prop_id,
     case PROP_MAX_DRIFT:
       demux->max_drift = g_value_get_uint64 (value);
       break;
+    case PROP_GROWING_FILE:
+      demux->growing_file = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4031,6 +4603,9 @@ gst_mxf_demux_get_property (GObject * object, guint prop_id,
     case PROP_MAX_DRIFT:
       g_value_set_uint64 (value, demux->max_drift);
       break;
+    case PROP_GROWING_FILE:
+      g_value_set_boolean (value, demux->growing_file);
+      break;
     case PROP_STRUCTURE:{
       GstStructure *s;
 
@@ -4082,8 +4657,11 @@ gst_mxf_demux_finalize (GObject * object)
   demux->essence_tracks = NULL;
 
   g_hash_table_destroy (demux->metadata);
+  g_hash_table_destroy (demux->metadata_data);
 
   g_rw_lock_clear (&demux->metadata_lock);
+  g_mutex_clear (&demux->poll_lock);
+  g_cond_clear (&demux->poll_cond);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -4118,6 +4696,12 @@ gst_mxf_demux_class_init (GstMXFDemuxClass * klass)
           "Structural metadata of the MXF file",
           GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_GROWING_FILE,
+      g_param_spec_boolean ("growing-file", "Growing file",
+          "Wait for more data at the end of a file that is still being "
+          "written instead of going EOS (pull mode only)", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_mxf_demux_change_state);
   gstelement_class->query = GST_DEBUG_FUNCPTR (gst_mxf_demux_query);
@@ -4152,6 +4736,8 @@ gst_mxf_demux_init (GstMXFDemux * demux)
 
   demux->adapter = gst_adapter_new ();
   g_rw_lock_init (&demux->metadata_lock);
+  g_mutex_init (&demux->poll_lock);
+  g_cond_init (&demux->poll_cond);
 
   demux->src = g_ptr_array_new ();
   demux->essence_tracks =
@@ -59,8 +59,17 @@ typedef struct
 {
   guint64 offset;
   gboolean keyframe;
+  /* offset is the start of the edit unit as given by an
+   * index table segment, not the offset of the element itself */
+  gboolean from_index;
 } GstMXFDemuxIndex;
 
+typedef struct
+{
+  MXFIndexTableSegment segment;
+  gboolean resolved;
+} GstMXFDemuxIndexTableSegment;
+
 typedef struct
 {
   guint32 body_sid;
@@ -73,6 +82,8 @@ typedef struct
   gint64 duration;
 
   GArray *offsets;
+  /* sorted positions (gint64) of the offsets that are keyframes */
+  GArray *keyframes;
 
   MXFMetadataSourcePackage *source_package;
   MXFMetadataTimelineTrack *source_track;
@@ -138,9 +149,19 @@ struct _GstMXFDemux
 
   guint64 offset;
 
+  /* Pull mode read-ahead chunk */
+  GstBuffer *read_ahead;
+  guint64 read_ahead_offset;
+
   gboolean random_access;
   gboolean flushing;
 
+  /* Waiting for new data at the end of a growing file, interrupted
+   * when the streaming task is paused or stopped */
+  GMutex poll_lock;
+  GCond poll_cond;
+  gboolean poll_cancelled;
+
   guint64 run_in;
 
   guint64 header_partition_pack_offset;
@@ -151,7 +172,9 @@ struct _GstMXFDemux
   GstMXFDemuxPartition *current_partition;
 
   GArray *essence_tracks;
-  GList *pending_index_table_segments;
+  /* GstMXFDemuxIndexTableSegment sorted by body/index SID and start */
+  GArray *index_table_segments;
+  gboolean pulled_index_table_segments;
 
   GArray *random_index_pack;
 
@@ -163,6 +186,8 @@ struct _GstMXFDemux
   gboolean metadata_resolved;
   MXFMetadataPreface *preface;
   GHashTable *metadata;
+  /* Raw data of the metadata sets to detect unchanged sets in updates */
+  GHashTable *metadata_data;
 
   MXFUMID current_package_uid;
   MXFMetadataGenericPackage *current_package;
@@ -173,6 +198,7 @@ struct _GstMXFDemux
   /* Properties */
   gchar *requested_package_string;
   GstClockTime max_drift;
+  gboolean growing_file;
 };
 
 struct _GstMXFDemuxClass
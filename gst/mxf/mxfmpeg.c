@@ -1152,6 +1152,24 @@ done:
   return ret;
 }
 
+/* Prepends the headers collected in the adapter to the frame by
+ * appending memories instead of copying the data */
+static GstBuffer *
+mxf_mpeg_video_take_frame (GstAdapter * adapter, GstBuffer * buffer)
+{
+  guint av = gst_adapter_available (adapter);
+  GstBuffer *ret;
+
+  if (av == 0)
+    return buffer;
+
+  ret = gst_adapter_take_buffer (adapter, av);
+  if (buffer)
+    ret = gst_buffer_append (ret, buffer);
+
+  return ret;
+}
+
 static GstFlowReturn
 mxf_mpeg_video_write_func (GstBuffer * buffer,
     gpointer mapping_data, GstAdapter * adapter, GstBuffer ** outbuf,
@@ -1168,33 +1186,7 @@ mxf_mpeg_video_write_func (GstBuffer * buffer,
       *outbuf = NULL;
       return GST_FLOW_OK;
     } else if (buffer || gst_adapter_available (adapter)) {
-      guint av = gst_adapter_available (adapter);
-      GstBuffer *ret;
-      GstMapInfo map;
-
-      if (buffer)
-        ret = gst_buffer_new_and_alloc (gst_buffer_get_size (buffer) + av);
-      else
-        ret = gst_buffer_new_and_alloc (av);
-
-      gst_buffer_map (ret, &map, GST_MAP_WRITE);
-      if (av) {
-        gconstpointer data = gst_adapter_map (adapter, av);
-        memcpy (map.data, data, av);
-        gst_adapter_unmap (adapter);
-      }
-
-      if (buffer) {
-        GstMapInfo buffermap;
-        gst_buffer_map (buffer, &buffermap, GST_MAP_READ);
-        memcpy (map.data + av, buffermap.data, buffermap.size);
-        gst_buffer_unmap (buffer, &buffermap);
-        gst_buffer_unref (buffer);
-      }
-
-      gst_buffer_unmap (ret, &map);
-
-      *outbuf = ret;
+      *outbuf = mxf_mpeg_video_take_frame (adapter, buffer);
       return GST_FLOW_OK;
     }
   } else if (type == MXF_MPEG_ESSENCE_TYPE_VIDEO_MPEG4) {
@@ -1203,33 +1195,7 @@ mxf_mpeg_video_write_func (GstBuffer * buffer,
       *outbuf = NULL;
       return GST_FLOW_OK;
     } else if (buffer || gst_adapter_available (adapter)) {
-      guint av = gst_adapter_available (adapter);
-      GstBuffer *ret;
-      GstMapInfo map;
-
-      if (buffer)
-        ret = gst_buffer_new_and_alloc (gst_buffer_get_size (buffer) + av);
-      else
-        ret = gst_buffer_new_and_alloc (av);
-
-      gst_buffer_map (ret, &map, GST_MAP_WRITE);
-      if (av) {
-        gconstpointer data = gst_adapter_map (adapter, av);
-        memcpy (map.data, data, av);
-        gst_adapter_unmap (adapter);
-      }
-
-      if (buffer) {
-        GstMapInfo buffermap;
-        gst_buffer_map (buffer, &buffermap, GST_MAP_READ);
-        memcpy (map.data + av, buffermap.data, buffermap.size);
-        gst_buffer_unmap (buffer, &buffermap);
-        gst_buffer_unref (buffer);
-      }
-
-      gst_buffer_unmap (ret, &map);
-
-      *outbuf = ret;
+      *outbuf = mxf_mpeg_video_take_frame (adapter, buffer);
       return GST_FLOW_OK;
     }
   }
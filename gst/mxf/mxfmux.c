@@ -52,9 +52,16 @@ static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS ("application/mxf")
     );
 
+/* Local tag lengths are 16 bit, which limits the number of index entries
+ * per index table segment */
+#define INDEX_SEGMENT_MAX_ENTRIES (4096)
+
+#define DEFAULT_PARTITION_DURATION 0
+
 enum
 {
-  PROP_0
+  PROP_0,
+  PROP_PARTITION_DURATION
 };
 
 #define gst_mxf_mux_parent_class parent_class
@@ -81,6 +88,7 @@ static GstStateChangeReturn
 gst_mxf_mux_change_state (GstElement * element, GstStateChange transition);
 
 static void gst_mxf_mux_reset (GstMXFMux * mux);
+static GstFlowReturn gst_mxf_mux_write_body_partition (GstMXFMux * mux);
 
 static GstFlowReturn
 gst_mxf_mux_push (GstMXFMux * mux, GstBuffer * buf)
@@ -110,6 +118,14 @@ gst_mxf_mux_class_init (GstMXFMuxClass * klass)
   gobject_class->set_property = gst_mxf_mux_set_property;
   gobject_class->get_property = gst_mxf_mux_get_property;
 
+  g_object_class_install_property (gobject_class, PROP_PARTITION_DURATION,
+      g_param_spec_uint64 ("partition-duration", "Partition duration",
+          "Start a new body partition with the index table segments of the "
+          "previous one after this much time (0 = only when the index of the "
+          "current one is full)", 0, G_MAXUINT64,
+          DEFAULT_PARTITION_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_mxf_mux_change_state);
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_mxf_mux_request_new_pad);
@@ -149,6 +165,11 @@ gst_mxf_mux_init (GstMXFMux * mux)
   gst_collect_pads_set_function (mux->collect,
       GST_DEBUG_FUNCPTR (gst_mxf_mux_collected), mux);
 
+  mux->partition_duration = DEFAULT_PARTITION_DURATION;
+  mux->partitions =
+      g_array_new (FALSE, FALSE, sizeof (MXFRandomIndexPackEntry));
+  mux->index_entries = g_array_new (FALSE, TRUE, sizeof (MXFIndexEntry));
+
   gst_mxf_mux_reset (mux);
 }
 
@@ -166,6 +187,9 @@ gst_mxf_mux_finalize (GObject * object)
     mux->metadata_list = NULL;
   }
 
+  g_array_free (mux->partitions, TRUE);
+  g_array_free (mux->index_entries, TRUE);
+
   gst_object_unref (mux->collect);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -175,9 +199,12 @@ static void
 gst_mxf_mux_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
 {
-  //GstMXFMux *mux = GST_MXF_MUX (object);
+  GstMXFMux *mux = GST_MXF_MUX (object);
 
   switch (prop_id) {
+    case PROP_PARTITION_DURATION:
+      mux->partition_duration = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -188,9 +215,12 @@ static void
 gst_mxf_mux_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
 {
-  //GstMXFMux *mux = GST_MXF_MUX (object);
+  GstMXFMux *mux = GST_MXF_MUX (object);
 
   switch (prop_id) {
+    case PROP_PARTITION_DURATION:
+      g_value_set_uint64 (value, mux->partition_duration);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -228,6 +258,13 @@ gst_mxf_mux_reset (GstMXFMux * mux)
   mux->last_gc_timestamp = 0;
   mux->last_gc_position = 0;
   mux->offset = 0;
+
+  mux->body_offset = 0;
+  mux->last_partition = 0;
+  g_array_set_size (mux->partitions, 0);
+  g_array_set_size (mux->index_entries, 0);
+  mux->index_start_position = 0;
+  mux->index_pad = NULL;
 }
 
 static gboolean
@@ -473,6 +510,10 @@ gst_mxf_mux_create_metadata (GstMXFMux * mux)
       cpad->writer->update_descriptor (cpad->descriptor,
           caps, cpad->mapping_data, cpad->collect.buffer);
     gst_caps_unref (caps);
+
+    if (!mux->index_pad
+        && MXF_IS_METADATA_GENERIC_PICTURE_ESSENCE_DESCRIPTOR (cpad->descriptor))
+      mux->index_pad = cpad;
   }
 
   /* Preface */
@@ -946,7 +987,7 @@ gst_mxf_mux_create_metadata (GstMXFMux * mux)
 
     cstorage->essence_container_data[0]->linked_package =
         MXF_METADATA_SOURCE_PACKAGE (cstorage->packages[1]);
-    cstorage->essence_container_data[0]->index_sid = 0;
+    cstorage->essence_container_data[0]->index_sid = 1;
     cstorage->essence_container_data[0]->body_sid = 1;
   }
 
@@ -1104,11 +1145,12 @@ gst_mxf_mux_handle_buffer (GstMXFMux * mux, GstMXFMuxPad * cpad)
   GstBuffer *outbuf = NULL;
   GstBuffer *packet;
   GstMapInfo map;
-  GstMapInfo readmap;
   GstFlowReturn ret = GST_FLOW_OK;
   guint8 slen, ber[9];
   gboolean flush = ((cpad->collect.state & GST_COLLECT_PADS_STATE_EOS)
       && !cpad->have_complete_edit_unit && cpad->collect.buffer == NULL);
+  gboolean keyframe = TRUE;
+  gsize size;
 
   if (cpad->have_complete_edit_unit) {
     GST_DEBUG_OBJECT (cpad->collect.pad,
@@ -1124,6 +1166,7 @@ gst_mxf_mux_handle_buffer (GstMXFMux * mux, GstMXFMuxPad * cpad)
         "Handling buffer of size %" G_GSIZE_FORMAT " for track %u at position %"
         G_GINT64_FORMAT, gst_buffer_get_size (buf),
         cpad->source_track->parent.track_id, cpad->pos);
+    keyframe = !GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
   } else {
     flush = TRUE;
     GST_DEBUG_OBJECT (cpad->collect.pad,
@@ -1151,30 +1194,74 @@ gst_mxf_mux_handle_buffer (GstMXFMux * mux, GstMXFMuxPad * cpad)
   if (buf == NULL)
     return ret;
 
-  gst_buffer_map (buf, &readmap, GST_MAP_READ);
-  slen = mxf_ber_encode_size (readmap.size, ber);
-  packet = gst_buffer_new_and_alloc (16 + slen + readmap.size);
+  /* Only the KLV key and length are written into a new memory, the essence
+   * itself is appended to the packet without copying */
+  size = gst_buffer_get_size (buf);
+  slen = mxf_ber_encode_size (size, ber);
+  packet = gst_buffer_new_and_alloc (16 + slen);
   gst_buffer_map (packet, &map, GST_MAP_WRITE);
   memcpy (map.data, _gc_essence_element_ul, 16);
   map.data[7] = cpad->descriptor->essence_container.u[7];
   GST_WRITE_UINT32_BE (map.data + 12, cpad->source_track->parent.track_number);
   memcpy (map.data + 16, ber, slen);
-  memcpy (map.data + 16 + slen, readmap.data, readmap.size);
-  gst_buffer_unmap (buf, &readmap);
+  gst_buffer_unmap (packet, &map);
 
-  gst_buffer_unref (buf);
+  packet = gst_buffer_append (packet, buf);
 
   GST_DEBUG_OBJECT (cpad->collect.pad,
-      "Pushing buffer of size %" G_GSIZE_FORMAT " for track %u", map.size,
-      cpad->source_track->parent.track_id);
-  gst_buffer_unmap (packet, &map);
+      "Pushing buffer of size %" G_GSIZE_FORMAT " for track %u",
+      16 + slen + size, cpad->source_track->parent.track_id);
+
+  /* The first element of a new edit unit starts a new index entry, and
+   * possibly a new body partition. The index of a partition is kept in
+   * memory until the next one is written, so a partition is also started
+   * once it has a full index table segment */
+  if (mux->last_gc_position >=
+      mux->index_start_position + mux->index_entries->len) {
+    if ((mux->partition_duration > 0 && mux->index_entries->len > 0
+            && gst_util_uint64_scale ((mux->last_gc_position -
+                    mux->index_start_position) * GST_SECOND,
+                mux->min_edit_rate.d,
+                mux->min_edit_rate.n) >= mux->partition_duration)
+        || mux->index_entries->len >= INDEX_SEGMENT_MAX_ENTRIES) {
+      if ((ret = gst_mxf_mux_write_body_partition (mux)) != GST_FLOW_OK) {
+        GST_ERROR_OBJECT (mux, "Failed pushing body partition: %s",
+            gst_flow_get_name (ret));
+        gst_buffer_unref (packet);
+        return ret;
+      }
+    }
+
+    /* Without video every edit unit is a random access point, otherwise
+     * the video element of the edit unit sets the flags below */
+    while (mux->index_start_position + mux->index_entries->len <=
+        mux->last_gc_position) {
+      MXFIndexEntry entry;
 
+      memset (&entry, 0, sizeof (entry));
+      entry.flags = mux->index_pad ? 0x00 : 0x80;
+      entry.stream_offset = mux->body_offset;
+      g_array_append_val (mux->index_entries, entry);
+    }
+  }
+
+  if (cpad == mux->index_pad
+      && mux->last_gc_position >= mux->index_start_position
+      && mux->last_gc_position <
+      mux->index_start_position + mux->index_entries->len) {
+    g_array_index (mux->index_entries, MXFIndexEntry,
+        mux->last_gc_position - mux->index_start_position).flags =
+        keyframe ? 0x80 : 0x00;
+  }
+
+  size = gst_buffer_get_size (packet);
   if ((ret = gst_mxf_mux_push (mux, packet)) != GST_FLOW_OK) {
     GST_ERROR_OBJECT (cpad->collect.pad,
         "Failed pushing buffer for track %u, reason %s",
         cpad->source_track->parent.track_id, gst_flow_get_name (ret));
     return ret;
   }
+  mux->body_offset += size;
 
   cpad->pos++;
   cpad->last_timestamp =
@@ -1184,24 +1271,82 @@ gst_mxf_mux_handle_buffer (GstMXFMux * mux, GstMXFMuxPad * cpad)
   return ret;
 }
 
+/* Creates index table segments for all edit units since the last call,
+ * or NULL if there are none */
+static GstBuffer *
+gst_mxf_mux_create_index_table_segments (GstMXFMux * mux)
+{
+  MXFMetadataEssenceContainerData *edata =
+      mux->preface->content_storage->essence_container_data[0];
+  GstBuffer *ret = NULL;
+  guint i;
+
+  for (i = 0; i < mux->index_entries->len; i += INDEX_SEGMENT_MAX_ENTRIES) {
+    MXFIndexTableSegment segment;
+    GstBuffer *buf;
+
+    memset (&segment, 0, sizeof (segment));
+    mxf_uuid_init (&segment.instance_id, mux->metadata);
+    memcpy (&segment.index_edit_rate, &mux->min_edit_rate,
+        sizeof (MXFFraction));
+    segment.index_start_position = mux->index_start_position + i;
+    segment.n_index_entries =
+        MIN (INDEX_SEGMENT_MAX_ENTRIES, mux->index_entries->len - i);
+    segment.index_duration = segment.n_index_entries;
+    segment.index_sid = edata->index_sid;
+    segment.body_sid = edata->body_sid;
+    segment.index_entries =
+        &g_array_index (mux->index_entries, MXFIndexEntry, i);
+
+    buf = mxf_index_table_segment_to_buffer (&segment);
+    ret = ret ? gst_buffer_append (ret, buf) : buf;
+  }
+
+  mux->index_start_position += mux->index_entries->len;
+  g_array_set_size (mux->index_entries, 0);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_mxf_mux_write_body_partition (GstMXFMux * mux)
 {
-  GstBuffer *buf;
+  MXFMetadataEssenceContainerData *edata =
+      mux->preface->content_storage->essence_container_data[0];
+  MXFRandomIndexPackEntry entry;
+  GstBuffer *buf, *index;
+  GstFlowReturn ret;
+
+  /* The index table segments of the previous partition are written
+   * before the essence of this one */
+  index = gst_mxf_mux_create_index_table_segments (mux);
 
   mux->partition.type = MXF_PARTITION_PACK_BODY;
   mux->partition.this_partition = mux->offset;
-  mux->partition.prev_partition = 0;
+  mux->partition.prev_partition = mux->last_partition;
   mux->partition.footer_partition = 0;
   mux->partition.header_byte_count = 0;
-  mux->partition.index_byte_count = 0;
-  mux->partition.index_sid = 0;
-  mux->partition.body_offset = 0;
-  mux->partition.body_sid =
-      mux->preface->content_storage->essence_container_data[0]->body_sid;
+  mux->partition.index_byte_count = index ? gst_buffer_get_size (index) : 0;
+  mux->partition.index_sid = index ? edata->index_sid : 0;
+  mux->partition.body_offset = mux->body_offset;
+  mux->partition.body_sid = edata->body_sid;
+
+  entry.offset = mux->offset;
+  entry.body_sid = edata->body_sid;
+  g_array_append_val (mux->partitions, entry);
+  mux->last_partition = mux->offset;
 
   buf = mxf_partition_pack_to_buffer (&mux->partition);
-  return gst_mxf_mux_push (mux, buf);
+  if ((ret = gst_mxf_mux_push (mux, buf)) != GST_FLOW_OK) {
+    if (index)
+      gst_buffer_unref (index);
+    return ret;
+  }
+
+  if (index)
+    ret = gst_mxf_mux_push (mux, index);
+
+  return ret;
 }
 
 static GstFlowReturn
@@ -1296,35 +1441,40 @@ gst_mxf_mux_handle_eos (GstMXFMux * mux)
   }
 
   {
-    guint64 body_partition = mux->partition.this_partition;
-    guint32 body_sid = mux->partition.body_sid;
     guint64 footer_partition = mux->offset;
     GArray *rip;
     GstFlowReturn ret;
     GstSegment segment;
     MXFRandomIndexPackEntry entry;
+    GstBuffer *index;
+
+    index = gst_mxf_mux_create_index_table_segments (mux);
 
     mux->partition.type = MXF_PARTITION_PACK_FOOTER;
     mux->partition.closed = TRUE;
     mux->partition.complete = TRUE;
     mux->partition.this_partition = mux->offset;
-    mux->partition.prev_partition = body_partition;
+    mux->partition.prev_partition = mux->last_partition;
     mux->partition.footer_partition = mux->offset;
     mux->partition.header_byte_count = 0;
-    mux->partition.index_byte_count = 0;
-    mux->partition.index_sid = 0;
+    mux->partition.index_byte_count = index ? gst_buffer_get_size (index) : 0;
+    mux->partition.index_sid = index ?
+        mux->preface->content_storage->essence_container_data[0]->index_sid :
+        0;
     mux->partition.body_offset = 0;
     mux->partition.body_sid = 0;
 
     gst_mxf_mux_write_header_metadata (mux);
+    if (index && (ret = gst_mxf_mux_push (mux, index)) != GST_FLOW_OK) {
+      GST_ERROR_OBJECT (mux, "Failed pushing index table segments");
+    }
 
-    rip = g_array_sized_new (FALSE, FALSE, sizeof (MXFRandomIndexPackEntry), 3);
+    rip = g_array_sized_new (FALSE, FALSE, sizeof (MXFRandomIndexPackEntry),
+        mux->partitions->len + 2);
     entry.offset = 0;
     entry.body_sid = 0;
     g_array_append_val (rip, entry);
-    entry.offset = body_partition;
-    entry.body_sid = body_sid;
-    g_array_append_val (rip, entry);
+    g_array_append_vals (rip, mux->partitions->data, mux->partitions->len);
     entry.offset = footer_partition;
     entry.body_sid = 0;
     g_array_append_val (rip, entry);
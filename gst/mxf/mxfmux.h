@@ -92,7 +92,22 @@ typedef struct _GstMXFMux {
   guint64 last_gc_position;
   GstClockTime last_gc_timestamp;
 
+  /* Essence bytes written to the body so far */
+  guint64 body_offset;
+  guint64 last_partition;
+  GArray *partitions;
+
+  /* MXFIndexEntry of the edit units since the last index table segment */
+  GArray *index_entries;
+  guint64 index_start_position;
+  /* the first video track, its key frames are the random access points of
+   * the index. NULL if there is no video track */
+  GstMXFMuxPad *index_pad;
+
   gchar *application;
+
+  /* Properties */
+  GstClockTime partition_duration;
 } GstMXFMux;
 
 typedef struct _GstMXFMuxClass {
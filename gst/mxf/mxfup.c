@@ -391,33 +391,46 @@ mxf_up_write_func (GstBuffer * buffer, gpointer mapping_data,
     GstAdapter * adapter, GstBuffer ** outbuf, gboolean flush)
 {
   MXFUPMappingData *data = mapping_data;
+  GstVideoMeta *meta;
+  gsize offset = 0, row_size, size;
+  gint stride;
 
   if (!buffer)
     return GST_FLOW_OK;
 
-  if (gst_buffer_get_size (buffer) !=
-      GST_ROUND_UP_4 (data->bpp * data->width) * data->height) {
+  row_size = data->width * data->bpp;
+  stride = GST_ROUND_UP_4 (row_size);
+  meta = gst_buffer_get_video_meta (buffer);
+  if (meta) {
+    offset = meta->offset[0];
+    stride = meta->stride[0];
+  }
+  size = row_size * data->height;
+
+  if (stride < 0 || (gsize) stride < row_size
+      || gst_buffer_get_size (buffer) <
+      offset + (gsize) stride * (data->height - 1) + row_size) {
     GST_ERROR ("Invalid buffer size");
     return GST_FLOW_ERROR;
   }
 
-  if (data->bpp != 4
-      || GST_ROUND_UP_4 (data->width * data->bpp) != data->width * data->bpp) {
+  if ((gsize) stride != row_size) {
     guint y;
     GstBuffer *ret;
     GstMapInfo inmap, outmap;
     guint8 *indata, *outdata;
 
-    ret = gst_buffer_new_and_alloc (data->width * data->bpp * data->height);
+    /* Strip the row padding */
+    ret = gst_buffer_new_and_alloc (size);
     gst_buffer_map (buffer, &inmap, GST_MAP_READ);
     gst_buffer_map (ret, &outmap, GST_MAP_WRITE);
-    indata = inmap.data;
+    indata = inmap.data + offset;
     outdata = outmap.data;
 
     for (y = 0; y < data->height; y++) {
-      memcpy (outdata, indata, data->width * data->bpp);
-      indata += GST_ROUND_UP_4 (data->width * data->bpp);
-      outdata += data->width * data->bpp;
+      memcpy (outdata, indata, row_size);
+      indata += stride;
+      outdata += row_size;
     }
 
     gst_buffer_unmap (buffer, &inmap);
@@ -425,6 +438,11 @@ mxf_up_write_func (GstBuffer * buffer, gpointer mapping_data,
     gst_buffer_unref (buffer);
 
     *outbuf = ret;
+  } else if (offset != 0 || gst_buffer_get_size (buffer) != size) {
+    /* The rows are contiguous, only take the image by reference */
+    *outbuf = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, offset,
+        size);
+    gst_buffer_unref (buffer);
   } else {
     *outbuf = buffer;
   }
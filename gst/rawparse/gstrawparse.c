@@ -197,6 +197,17 @@ gst_raw_parse_class_set_multiple_frames_per_buffer (GstRawParseClass * klass,
   klass->multiple_frames_per_buffer = multiple_frames;
 }
 
+static void
+gst_raw_parse_release_pool (GstRawParse * rp)
+{
+  if (rp->pool) {
+    gst_buffer_pool_set_active (rp->pool, FALSE);
+    gst_object_unref (rp->pool);
+    rp->pool = NULL;
+  }
+  rp->pool_checked = FALSE;
+}
+
 static void
 gst_raw_parse_reset (GstRawParse * rp)
 {
@@ -205,6 +216,74 @@ gst_raw_parse_reset (GstRawParse * rp)
 
   gst_segment_init (&rp->segment, GST_FORMAT_TIME);
   gst_adapter_clear (rp->adapter);
+  gst_raw_parse_release_pool (rp);
+}
+
+/* in pull mode frames can be read straight into buffers from a downstream
+ * pool, which saves downstream from copying them into its own memory. this
+ * is only done when the pool's buffers are exactly one frame, anything else
+ * means they have a layout (padding, strides) that differs from the raw
+ * data */
+static void
+gst_raw_parse_decide_allocation (GstRawParse * rp)
+{
+  GstRawParseClass *rp_class = GST_RAW_PARSE_GET_CLASS (rp);
+  GstQuery *query;
+  GstCaps *caps;
+  GstBufferPool *pool = NULL;
+  GstStructure *config;
+  GstBuffer *buffer = NULL;
+  guint size, min, max;
+
+  rp->pool_checked = TRUE;
+
+  if (rp_class->multiple_frames_per_buffer)
+    return;
+
+  caps = gst_pad_get_current_caps (rp->srcpad);
+  if (caps == NULL)
+    return;
+
+  query = gst_query_new_allocation (caps, TRUE);
+  if (gst_pad_peer_query (rp->srcpad, query)
+      && gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+  gst_query_unref (query);
+
+  if (pool == NULL) {
+    GST_DEBUG_OBJECT (rp, "no downstream pool, upstream allocates frames");
+    gst_caps_unref (caps);
+    return;
+  }
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, rp->framesize, min, max);
+  gst_caps_unref (caps);
+
+  if (!gst_buffer_pool_set_config (pool, config)
+      || !gst_buffer_pool_set_active (pool, TRUE))
+    goto unusable;
+
+  if (gst_buffer_pool_acquire_buffer (pool, &buffer, NULL) != GST_FLOW_OK)
+    goto unusable;
+  size = gst_buffer_get_size (buffer);
+  gst_buffer_unref (buffer);
+  if (size != rp->framesize)
+    goto unusable;
+
+  GST_DEBUG_OBJECT (rp, "pulling frames into downstream pool %" GST_PTR_FORMAT,
+      pool);
+  rp->pool = pool;
+  return;
+
+unusable:
+  {
+    GST_DEBUG_OBJECT (rp, "downstream pool %" GST_PTR_FORMAT " not usable",
+        pool);
+    gst_buffer_pool_set_active (pool, FALSE);
+    gst_object_unref (pool);
+    return;
+  }
 }
 
 static gboolean
@@ -311,7 +390,9 @@ gst_raw_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   }
 
   while (gst_adapter_available (rp->adapter) >= buffersize) {
-    buffer = gst_adapter_take_buffer (rp->adapter, buffersize);
+    /* frames that straddle input buffers are made of their memories
+     * instead of being copied together */
+    buffer = gst_adapter_take_buffer_fast (rp->adapter, buffersize);
 
     ret = gst_raw_parse_push_buffer (rp, buffer);
     if (ret != GST_FLOW_OK)
@@ -379,12 +460,27 @@ gst_raw_parse_loop (GstElement * element)
     rp->offset -= size;
   }
 
+  if (!rp->pool_checked)
+    gst_raw_parse_decide_allocation (rp);
+
   buffer = NULL;
+  if (rp->pool && size == rp->framesize) {
+    ret = gst_buffer_pool_acquire_buffer (rp->pool, &buffer, NULL);
+    if (ret != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (rp, "failed to acquire buffer, flow: %s",
+          gst_flow_get_name (ret));
+      goto pause;
+    }
+  }
+
+  /* with a buffer from the pool, upstream reads into it */
   ret = gst_pad_pull_range (rp->sinkpad, rp->offset, size, &buffer);
 
   if (ret != GST_FLOW_OK) {
     GST_DEBUG_OBJECT (rp, "pull_range (%" G_GINT64_FORMAT ", %u) "
         "failed, flow: %s", rp->offset, size, gst_flow_get_name (ret));
+    if (buffer)
+      gst_buffer_unref (buffer);
     buffer = NULL;
     goto pause;
   }
@@ -509,6 +605,7 @@ gst_raw_parse_sink_activatemode (GstPad * sinkpad, GstObject * parent,
         rp->mode = mode;
       } else {
         result = gst_pad_stop_task (sinkpad);
+        gst_raw_parse_release_pool (rp);
       }
       return result;
     case GST_PAD_MODE_PUSH:
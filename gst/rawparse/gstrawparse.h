@@ -69,6 +69,10 @@ struct _GstRawParse
   GstEvent *start_segment;
 
   gboolean negotiated;
+
+  /* downstream pool that frames are pulled into directly, if any */
+  GstBufferPool *pool;
+  gboolean pool_checked;
 };
 
 struct _GstRawParseClass
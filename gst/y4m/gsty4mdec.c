@@ -120,6 +120,9 @@ static void
 gst_y4m_dec_init (GstY4mDec * y4mdec)
 {
   y4mdec->adapter = gst_adapter_new ();
+  y4mdec->index = g_array_new (FALSE, FALSE, sizeof (guint64));
+  y4mdec->pending_seek_frame = -1;
+  y4mdec->seek_frame = -1;
 
   y4mdec->sinkpad =
       gst_pad_new_from_static_template (&gst_y4m_dec_sink_template, "sink");
@@ -186,9 +189,13 @@ gst_y4m_dec_dispose (GObject * object)
 void
 gst_y4m_dec_finalize (GObject * object)
 {
+  GstY4mDec *y4mdec;
+
   g_return_if_fail (GST_IS_Y4M_DEC (object));
+  y4mdec = GST_Y4M_DEC (object);
 
   /* clean up object here */
+  g_array_free (y4mdec->index, TRUE);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -225,6 +232,10 @@ gst_y4m_dec_change_state (GstElement * element, GstStateChange transition)
         gst_object_unref (y4mdec->pool);
       }
       y4mdec->pool = NULL;
+      g_array_set_size (y4mdec->index, 0);
+      y4mdec->frame_params = FALSE;
+      y4mdec->pending_seek_frame = -1;
+      y4mdec->seek_frame = -1;
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       break;
@@ -255,26 +266,77 @@ gst_y4m_dec_timestamp_to_frames (GstY4mDec * y4mdec, GstClockTime timestamp)
       GST_SECOND * y4mdec->info.fps_d);
 }
 
+/* frames past the end of the index are estimated assuming frame headers
+ * without parameters ("FRAME\n", 6 bytes) */
 static gint64
 gst_y4m_dec_bytes_to_frames (GstY4mDec * y4mdec, gint64 bytes)
 {
+  const guint64 *offsets = (const guint64 *) y4mdec->index->data;
+  const guint len = y4mdec->index->len;
+  guint lo, hi;
+
   if (bytes == -1)
     return -1;
 
   if (bytes < y4mdec->header_size)
     return 0;
-  return (bytes - y4mdec->header_size) / (y4mdec->info.size + 6);
+
+  if (len == 0)
+    return (bytes - y4mdec->header_size) / (y4mdec->info.size + 6);
+
+  if (bytes >= offsets[len - 1])
+    return (len - 1) + (bytes - offsets[len - 1]) / (y4mdec->info.size + 6);
+
+  /* find the last frame starting at or before bytes, the first frame starts
+   * right after the stream header */
+  lo = 0;
+  hi = len - 1;
+  while (hi - lo > 1) {
+    guint mid = (lo + hi) / 2;
+
+    if (offsets[mid] <= bytes)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return lo;
 }
 
 static guint64
 gst_y4m_dec_frames_to_bytes (GstY4mDec * y4mdec, gint64 frame_index)
 {
+  const guint64 *offsets = (const guint64 *) y4mdec->index->data;
+  const guint len = y4mdec->index->len;
+
   if (frame_index == -1)
     return -1;
 
+  if (frame_index < len)
+    return offsets[frame_index];
+
+  if (len > 0)
+    return offsets[len - 1] + (y4mdec->info.size + 6) * (frame_index -
+        (len - 1));
+
   return y4mdec->header_size + (y4mdec->info.size + 6) * frame_index;
 }
 
+/* returns TRUE if bytes is the offset of an indexed frame, or of the first
+ * frame */
+static gboolean
+gst_y4m_dec_bytes_is_indexed (GstY4mDec * y4mdec, gint64 bytes)
+{
+  gint64 frame_index;
+
+  if (bytes <= y4mdec->header_size)
+    return TRUE;
+
+  frame_index = gst_y4m_dec_bytes_to_frames (y4mdec, bytes);
+  return frame_index < y4mdec->index->len &&
+      g_array_index (y4mdec->index, guint64, frame_index) == bytes;
+}
+
 static GstClockTime
 gst_y4m_dec_bytes_to_timestamp (GstY4mDec * y4mdec, gint64 bytes)
 {
@@ -529,6 +591,7 @@ gst_y4m_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
     y4mdec->header_size = strlen (header) + 1;
     gst_adapter_flush (y4mdec->adapter, y4mdec->header_size);
+    y4mdec->offset += y4mdec->header_size;
 
     caps = gst_video_info_to_caps (&y4mdec->info);
     ret = gst_pad_set_caps (y4mdec->srcpad, caps);
@@ -623,6 +686,18 @@ gst_y4m_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         y4mdec->segment.time);
     GstSegment seg;
 
+    GST_OBJECT_LOCK (y4mdec);
+    y4mdec->seek_frame = y4mdec->pending_seek_frame;
+    y4mdec->pending_seek_frame = -1;
+    GST_OBJECT_UNLOCK (y4mdec);
+
+    /* upstream restarts at an indexed frame before the seek target, the
+     * segment starts at the target */
+    if (y4mdec->seek_frame != -1) {
+      start = gst_y4m_dec_frames_to_timestamp (y4mdec, y4mdec->seek_frame);
+      time = start;
+    }
+
     gst_segment_init (&seg, GST_FORMAT_TIME);
     seg.start = start;
     seg.stop = stop;
@@ -635,7 +710,10 @@ gst_y4m_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     y4mdec->have_new_segment = FALSE;
     y4mdec->frame_index = gst_y4m_dec_bytes_to_frames (y4mdec,
         y4mdec->segment.time);
-    GST_DEBUG ("new frame_index %d", y4mdec->frame_index);
+    y4mdec->index_exact = gst_y4m_dec_bytes_is_indexed (y4mdec,
+        y4mdec->segment.time);
+    GST_DEBUG ("new frame_index %d (%s)", y4mdec->frame_index,
+        y4mdec->index_exact ? "exact" : "estimated");
 
   }
 
@@ -651,13 +729,39 @@ gst_y4m_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         header[i] = 0;
     }
     if (memcmp (header, "FRAME", 5) != 0) {
-      GST_ELEMENT_ERROR (y4mdec, STREAM, DECODE,
-          ("Failed to parse YUV4MPEG frame"), (NULL));
-      flow_ret = GST_FLOW_ERROR;
-      break;
+      gint skip;
+
+      if (y4mdec->index_exact) {
+        GST_ELEMENT_ERROR (y4mdec, STREAM, DECODE,
+            ("Failed to parse YUV4MPEG frame"), (NULL));
+        flow_ret = GST_FLOW_ERROR;
+        break;
+      }
+
+      /* a seek past the index that did not land on a frame, or a byte
+       * segment from upstream that starts anywhere, skip to the next frame;
+       * the frame numbers are estimated from here on and not indexed. the
+       * computed offsets are off, so only go to indexed offsets from now on */
+      GST_OBJECT_LOCK (y4mdec);
+      y4mdec->frame_params = TRUE;
+      GST_OBJECT_UNLOCK (y4mdec);
+      skip = gst_adapter_masked_scan_uint32 (y4mdec->adapter, 0xffffffff,
+          0x4652414d /* FRAM */ , 1, n_avail - 4);
+      if (skip < 0)
+        skip = n_avail - 4;
+      GST_DEBUG_OBJECT (y4mdec, "resyncing, skipping %d bytes", skip);
+      gst_adapter_flush (y4mdec->adapter, skip);
+      y4mdec->offset += skip;
+      continue;
     }
 
     len = strlen (header);
+    if (len > 5 && !y4mdec->frame_params) {
+      GST_DEBUG_OBJECT (y4mdec, "frame header with parameters");
+      GST_OBJECT_LOCK (y4mdec);
+      y4mdec->frame_params = TRUE;
+      GST_OBJECT_UNLOCK (y4mdec);
+    }
     if (n_avail < y4mdec->info.size + len + 1) {
       /* not enough data */
       GST_DEBUG ("not enough data for frame %d < %" G_GSIZE_FORMAT,
@@ -665,7 +769,21 @@ gst_y4m_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       break;
     }
 
+    if (y4mdec->index_exact && y4mdec->frame_index == y4mdec->index->len) {
+      GST_OBJECT_LOCK (y4mdec);
+      g_array_append_val (y4mdec->index, y4mdec->offset);
+      GST_OBJECT_UNLOCK (y4mdec);
+    }
+
     gst_adapter_flush (y4mdec->adapter, len + 1);
+    y4mdec->offset += len + 1 + y4mdec->info.size;
+
+    if (y4mdec->frame_index < y4mdec->seek_frame) {
+      /* walking forward to the seek target, only the index is needed */
+      gst_adapter_flush (y4mdec->adapter, y4mdec->info.size);
+      y4mdec->frame_index++;
+      continue;
+    }
 
     buffer = gst_adapter_take_buffer (y4mdec->adapter, y4mdec->info.size);
 
@@ -749,6 +867,7 @@ gst_y4m_dec_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       res = gst_pad_push_event (y4mdec->srcpad, event);
       break;
     case GST_EVENT_FLUSH_STOP:
+      gst_adapter_clear (y4mdec->adapter);
       res = gst_pad_push_event (y4mdec->srcpad, event);
       break;
     case GST_EVENT_SEGMENT:
@@ -762,6 +881,8 @@ gst_y4m_dec_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       if (seg.format == GST_FORMAT_BYTES) {
         y4mdec->segment = seg;
         y4mdec->have_new_segment = TRUE;
+        /* upstream pushes data from the start of the segment */
+        y4mdec->offset = seg.start;
       }
 
       res = TRUE;
@@ -798,7 +919,7 @@ gst_y4m_dec_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GstSeekFlags flags;
       GstSeekType start_type, stop_type;
       gint64 start, stop;
-      gint64 framenum;
+      gint64 framenum, start_frame;
       guint64 byte;
 
       gst_event_parse_seek (event, &rate, &format, &flags, &start_type,
@@ -816,8 +937,20 @@ gst_y4m_dec_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         break;
       }
 
-      byte = gst_y4m_dec_frames_to_bytes (y4mdec, framenum);
-      GST_DEBUG ("offset %" G_GUINT64_FORMAT, (guint64) byte);
+      /* the offset of a frame past the index is computed assuming frame
+       * headers without parameters. once one with parameters was seen,
+       * start at the last indexed frame (or the first frame) instead and let
+       * the chain function parse forward to the target */
+      GST_OBJECT_LOCK (y4mdec);
+      if (y4mdec->frame_params)
+        start_frame = MIN (framenum, (gint64) MAX (y4mdec->index->len, 1) - 1);
+      else
+        start_frame = framenum;
+      byte = gst_y4m_dec_frames_to_bytes (y4mdec, start_frame);
+      y4mdec->pending_seek_frame = framenum;
+      GST_OBJECT_UNLOCK (y4mdec);
+      GST_DEBUG ("offset %" G_GUINT64_FORMAT " of frame %" G_GINT64_FORMAT,
+          (guint64) byte, start_frame);
       if (byte == -1) {
         res = FALSE;
         break;
@@ -828,6 +961,11 @@ gst_y4m_dec_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
           start_type, byte, stop_type, -1);
 
       res = gst_pad_push_event (y4mdec->sinkpad, event);
+      if (!res) {
+        GST_OBJECT_LOCK (y4mdec);
+        y4mdec->pending_seek_frame = -1;
+        GST_OBJECT_UNLOCK (y4mdec);
+      }
     }
       break;
     default:
@@ -47,6 +47,24 @@ struct _GstY4mDec
   int frame_index;
   int header_size;
 
+  /* byte offset of the data at the start of the adapter */
+  guint64 offset;
+  /* byte offsets of the frames seen so far, by frame number. frame headers
+   * can carry parameters and vary in length, so only offsets of frames whose
+   * number is known exactly are added */
+  GArray *index;
+  gboolean index_exact;
+  /* a frame header with parameters was seen, so the offsets of frames past
+   * the index can't be computed. protected by the object lock */
+  gboolean frame_params;
+  /* frame a seek past the end of the index asked for. upstream is sent to
+   * the computed offset of the frame, or if frame_params is set to the last
+   * indexed frame and the frames up to the target are parsed to extend the
+   * index and dropped. pending_seek_frame is set by the seek and taken
+   * with the segment it causes, both under the object lock */
+  gint64 pending_seek_frame;
+  gint64 seek_frame;
+
   gboolean have_new_segment;
   GstSegment segment;
 
@@ -92,7 +92,8 @@ enum
   ARG_DVBSRC_INVERSION,
   ARG_DVBSRC_STATS_REPORTING_INTERVAL,
   ARG_DVBSRC_TIMEOUT,
-  ARG_DVBSRC_DVB_BUFFER_SIZE
+  ARG_DVBSRC_DVB_BUFFER_SIZE,
+  ARG_DVBSRC_LOW_LATENCY
 };
 
 #define DEFAULT_ADAPTER 0
@@ -113,7 +114,8 @@ enum
 #define DEFAULT_STATS_REPORTING_INTERVAL 100
 #define DEFAULT_TIMEOUT 1000000 /* 1 second */
 #define DEFAULT_DVB_BUFFER_SIZE (10*188*1024)   /* Default is the same as the kernel default */
-#define DEFAULT_BUFFER_SIZE 8192        /* not a property */
+#define DEFAULT_BUFFER_SIZE (TS_SIZE * 87)      /* ~16kB of whole packets, default blocksize */
+#define DEFAULT_LOW_LATENCY FALSE
 
 static void gst_dvbsrc_output_frontend_stats (GstDvbSrc * src);
 
@@ -275,8 +277,8 @@ static void gst_dvbsrc_set_property (GObject * object, guint prop_id,
 static void gst_dvbsrc_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 
-static GstFlowReturn gst_dvbsrc_create (GstPushSrc * element,
-    GstBuffer ** buffer);
+static GstFlowReturn gst_dvbsrc_fill (GstPushSrc * element,
+    GstBuffer * buffer);
 
 static gboolean gst_dvbsrc_start (GstBaseSrc * bsrc);
 static gboolean gst_dvbsrc_stop (GstBaseSrc * bsrc);
@@ -287,6 +289,8 @@ static gboolean gst_dvbsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_dvbsrc_unlock_stop (GstBaseSrc * bsrc);
 static gboolean gst_dvbsrc_is_seekable (GstBaseSrc * bsrc);
 static gboolean gst_dvbsrc_get_size (GstBaseSrc * src, guint64 * size);
+static gboolean gst_dvbsrc_decide_allocation (GstBaseSrc * bsrc,
+    GstQuery * query);
 
 static gboolean gst_dvbsrc_tune (GstDvbSrc * object);
 static void gst_dvbsrc_set_pes_filters (GstDvbSrc * object);
@@ -348,8 +352,10 @@ gst_dvbsrc_class_init (GstDvbSrcClass * klass)
   gstbasesrc_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_dvbsrc_unlock_stop);
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_dvbsrc_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_dvbsrc_get_size);
+  gstbasesrc_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_dvbsrc_decide_allocation);
 
-  gstpushsrc_class->create = GST_DEBUG_FUNCPTR (gst_dvbsrc_create);
+  gstpushsrc_class->fill = GST_DEBUG_FUNCPTR (gst_dvbsrc_fill);
 
   g_object_class_install_property (gobject_class, ARG_DVBSRC_ADAPTER,
       g_param_spec_int ("adapter", "The adapter device number",
@@ -457,6 +463,12 @@ gst_dvbsrc_class_init (GstDvbSrcClass * klass)
           "dvb-buffer-size",
           "The kernel buffer size used by the DVB api",
           0, G_MAXUINT, DEFAULT_DVB_BUFFER_SIZE, G_PARAM_READWRITE));
+
+  g_object_class_install_property (gobject_class,
+      ARG_DVBSRC_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low latency",
+          "Push the whole packets available after each read instead of "
+          "waiting for a full block", DEFAULT_LOW_LATENCY, G_PARAM_READWRITE));
 }
 
 /* initialize the new element
@@ -476,6 +488,8 @@ gst_dvbsrc_init (GstDvbSrc * object)
   /* And we wanted timestamped output */
   gst_base_src_set_do_timestamp (GST_BASE_SRC (object), TRUE);
   gst_base_src_set_format (GST_BASE_SRC (object), GST_FORMAT_TIME);
+  /* read in blocks of whole packets */
+  gst_base_src_set_blocksize (GST_BASE_SRC (object), DEFAULT_BUFFER_SIZE);
 
   object->fd_frontend = -1;
   object->fd_dvr = -1;
@@ -487,6 +501,7 @@ gst_dvbsrc_init (GstDvbSrc * object)
   /* Pid 8192 on DVB gets the whole transport stream */
   object->pids[0] = 8192;
   object->dvb_buffer_size = DEFAULT_DVB_BUFFER_SIZE;
+  object->low_latency = DEFAULT_LOW_LATENCY;
   object->adapter_number = DEFAULT_ADAPTER;
   object->frontend_number = DEFAULT_FRONTEND;
   object->diseqc_src = DEFAULT_DISEQC_SRC;
@@ -652,6 +667,9 @@ gst_dvbsrc_set_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_DVB_BUFFER_SIZE:
       object->dvb_buffer_size = g_value_get_uint (value);
       break;
+    case ARG_DVBSRC_LOW_LATENCY:
+      object->low_latency = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -721,6 +739,9 @@ gst_dvbsrc_get_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_DVB_BUFFER_SIZE:
       g_value_set_uint (value, object->dvb_buffer_size);
       break;
+    case ARG_DVBSRC_LOW_LATENCY:
+      g_value_set_boolean (value, object->low_latency);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -919,21 +940,54 @@ gst_dvbsrc_plugin_init (GstPlugin * plugin)
       GST_TYPE_DVBSRC);
 }
 
+/* returns the running time of the element clock, used to stamp buffers with
+ * their arrival time */
+static GstClockTime
+gst_dvbsrc_get_running_time (GstDvbSrc * object)
+{
+  GstClock *clock;
+  GstClockTime base_time, now;
+
+  GST_OBJECT_LOCK (object);
+  clock = GST_ELEMENT_CLOCK (object);
+  if (clock == NULL) {
+    GST_OBJECT_UNLOCK (object);
+    return GST_CLOCK_TIME_NONE;
+  }
+  gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (object)->base_time;
+  GST_OBJECT_UNLOCK (object);
+
+  now = gst_clock_get_time (clock);
+  gst_object_unref (clock);
+
+  return now > base_time ? now - base_time : 0;
+}
+
+/* fills buf with whole packets from the dvr device. in low latency mode the
+ * read returns as soon as some whole packets were read, a packet that was
+ * only partially read is completed by reading just its missing bytes.
+ * otherwise it waits for the buffer to be full */
 static GstFlowReturn
-gst_dvbsrc_read_device (GstDvbSrc * object, int size, GstBuffer ** buffer)
+gst_dvbsrc_read_device (GstDvbSrc * object, GstBuffer * buf)
 {
   gint count = 0;
   gint ret_val = 0;
-  GstBuffer *buf = gst_buffer_new_and_alloc (size);
+  gint size;
   GstClockTime timeout = object->timeout * GST_USECOND;
+  GstClockTime arrival;
   GstMapInfo map;
 
-  g_return_val_if_fail (GST_IS_BUFFER (buf), GST_FLOW_ERROR);
-
   if (object->fd_dvr < 0)
     return GST_FLOW_ERROR;
 
-  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  if (!gst_buffer_map (buf, &map, GST_MAP_WRITE))
+    goto map_error;
+
+  size = map.size - (map.size % TS_SIZE);
+  if (G_UNLIKELY (size == 0))
+    size = map.size;
+
   while (count < size) {
     ret_val = gst_poll_wait (object->poll, timeout);
     GST_LOG_OBJECT (object, "select returned %d", ret_val);
@@ -950,7 +1004,14 @@ gst_dvbsrc_read_device (GstDvbSrc * object, int size, GstBuffer ** buffer)
           gst_message_new_element (GST_OBJECT (object),
               gst_structure_new_empty ("dvb-read-failure")));
     } else {
-      int nread = read (object->fd_dvr, map.data + count, size - count);
+      gint want = size - count;
+      int nread;
+
+      /* don't wait for the next packets to finish a partial one */
+      if (object->low_latency && count % TS_SIZE != 0)
+        want = MIN (want, TS_SIZE - count % TS_SIZE);
+
+      nread = read (object->fd_dvr, map.data + count, want);
 
       if (G_UNLIKELY (nread < 0)) {
         GST_WARNING_OBJECT
@@ -960,47 +1021,68 @@ gst_dvbsrc_read_device (GstDvbSrc * object, int size, GstBuffer ** buffer)
         gst_element_post_message (GST_ELEMENT_CAST (object),
             gst_message_new_element (GST_OBJECT (object),
                 gst_structure_new_empty ("dvb-read-failure")));
-      } else
+      } else if (G_UNLIKELY (nread == 0)) {
+        /* the device never does this but a file or fifo standing in for it
+         * does at its end */
+        if (count == 0)
+          goto eos;
+        break;
+      } else {
         count = count + nread;
+        if (object->low_latency && count % TS_SIZE == 0)
+          break;
+      }
     }
   }
+  arrival = gst_dvbsrc_get_running_time (object);
+
   gst_buffer_unmap (buf, &map);
   gst_buffer_resize (buf, 0, count);
 
-  *buffer = buf;
+  GST_BUFFER_PTS (buf) = arrival;
+  GST_BUFFER_DTS (buf) = arrival;
+
+  GST_LOG_OBJECT (object, "read %d bytes at %" GST_TIME_FORMAT, count,
+      GST_TIME_ARGS (arrival));
 
   return GST_FLOW_OK;
 
+map_error:
+  {
+    GST_ELEMENT_ERROR (object, RESOURCE, WRITE, (NULL),
+        ("Failed to map buffer"));
+    return GST_FLOW_ERROR;
+  }
 stopped:
   {
     GST_DEBUG_OBJECT (object, "stop called");
     gst_buffer_unmap (buf, &map);
-    gst_buffer_unref (buf);
     return GST_FLOW_FLUSHING;
   }
+eos:
+  {
+    GST_DEBUG_OBJECT (object, "end of stream on dvr");
+    gst_buffer_unmap (buf, &map);
+    return GST_FLOW_EOS;
+  }
 select_error:
   {
     GST_ELEMENT_ERROR (object, RESOURCE, READ, (NULL),
         ("select error %d: %s (%d)", ret_val, g_strerror (errno), errno));
     gst_buffer_unmap (buf, &map);
-    gst_buffer_unref (buf);
     return GST_FLOW_ERROR;
   }
 }
 
 static GstFlowReturn
-gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
+gst_dvbsrc_fill (GstPushSrc * element, GstBuffer * buf)
 {
-  gint buffer_size;
   GstFlowReturn retval = GST_FLOW_ERROR;
   GstDvbSrc *object;
 
   object = GST_DVBSRC (element);
   GST_LOG ("fd_dvr: %d", object->fd_dvr);
 
-  //g_object_get(G_OBJECT(object), "blocksize", &buffer_size, NULL);
-  buffer_size = DEFAULT_BUFFER_SIZE;
-
   /* device can not be tuned during read */
   g_mutex_lock (&object->tune_mutex);
 
@@ -1008,7 +1090,7 @@ gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
   if (object->fd_dvr > -1) {
     /* --- Read TS from DVR device --- */
     GST_DEBUG_OBJECT (object, "Reading from DVR device");
-    retval = gst_dvbsrc_read_device (object, buffer_size, buf);
+    retval = gst_dvbsrc_read_device (object, buf);
 
     if (object->stats_interval != 0 &&
         ++object->stats_counter == object->stats_interval) {
@@ -1023,6 +1105,36 @@ gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
 
 }
 
+/* buffers come from a pool of blocks of whole packets so reading doesn't
+ * need an allocation each time */
+static gboolean
+gst_dvbsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
+{
+  GstBufferPool *pool = NULL;
+  guint size, min, max;
+  guint blocksize;
+
+  blocksize = gst_base_src_get_blocksize (bsrc);
+  if (blocksize >= TS_SIZE)
+    blocksize -= blocksize % TS_SIZE;
+
+  if (gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    if (pool == NULL)
+      pool = gst_buffer_pool_new ();
+    gst_query_set_nth_allocation_pool (query, 0, pool, MAX (size, blocksize),
+        min, max);
+  } else {
+    pool = gst_buffer_pool_new ();
+    gst_query_add_allocation_pool (query, pool, blocksize, 0, 0);
+  }
+  gst_object_unref (pool);
+
+  GST_DEBUG_OBJECT (bsrc, "using a pool of %u byte blocks", blocksize);
+
+  return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
+}
+
 static GstStateChangeReturn
 gst_dvbsrc_change_state (GstElement * element, GstStateChange transition)
 {
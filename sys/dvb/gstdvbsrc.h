@@ -78,6 +78,7 @@ struct _GstDvbSrc
   gboolean need_unlock;
 
   guint dvb_buffer_size;
+  gboolean low_latency;
 };
 
 struct _GstDvbSrcClass
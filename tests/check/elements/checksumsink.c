@@ -0,0 +1,211 @@
+/* GStreamer
+ *
+ * unit test for checksumsink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#define WIDTH 320
+#define HEIGHT 240
+
+/* extra bytes at the end of every row of the padded buffer */
+#define PADDING 64
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw, format = (string) I420")
+    );
+
+/* lines printed by checksumsink */
+static GList *printed;
+
+static void
+print_handler (const gchar * string)
+{
+  printed = g_list_append (printed, g_strdup (string));
+}
+
+static GstElement *
+setup_checksumsink (const gchar * hash)
+{
+  GstElement *checksumsink;
+  GstCaps *caps;
+
+  checksumsink = gst_check_setup_element ("checksumsink");
+  gst_util_set_object_arg (G_OBJECT (checksumsink), "hash", hash);
+  g_object_set (checksumsink, "per-plane", TRUE, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (checksumsink, &srctemplate);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  /* a sink changes state asynchronously, it prerolls on the first buffer */
+  fail_if (gst_element_set_state (checksumsink, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE, "could not set to playing");
+
+  caps = gst_caps_new_simple ("video/x-raw",
+      "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, WIDTH,
+      "height", G_TYPE_INT, HEIGHT,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  gst_check_setup_events (mysrcpad, checksumsink, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  return checksumsink;
+}
+
+static void
+cleanup_checksumsink (GstElement * checksumsink)
+{
+  gst_element_set_state (checksumsink, GST_STATE_NULL);
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (checksumsink);
+  gst_check_teardown_element (checksumsink);
+}
+
+/* the visible pixel at (x, y) of plane p, the same for both layouts */
+static guint8
+pixel_value (guint p, guint x, guint y)
+{
+  return (guint8) (x * 7 + y * 13 + p * 101);
+}
+
+/* create an I420 frame with the given extra row padding; the padding is
+ * filled with garbage that must not end up in the digest */
+static GstBuffer *
+create_frame (guint padding)
+{
+  GstVideoInfo info;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  gsize offset[GST_VIDEO_MAX_PLANES];
+  gint stride[GST_VIDEO_MAX_PLANES];
+  gsize size = 0;
+  guint p, x, y;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT);
+
+  for (p = 0; p < GST_VIDEO_INFO_N_PLANES (&info); p++) {
+    offset[p] = size;
+    stride[p] = GST_VIDEO_INFO_COMP_WIDTH (&info, p) + padding;
+    size += stride[p] * GST_VIDEO_INFO_COMP_HEIGHT (&info, p);
+  }
+
+  buffer = gst_buffer_new_allocate (NULL, size, NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  memset (map.data, 0xa5, size);
+  for (p = 0; p < GST_VIDEO_INFO_N_PLANES (&info); p++) {
+    for (y = 0; y < GST_VIDEO_INFO_COMP_HEIGHT (&info, p); y++) {
+      guint8 *row = map.data + offset[p] + y * stride[p];
+
+      for (x = 0; x < GST_VIDEO_INFO_COMP_WIDTH (&info, p); x++)
+        row[x] = pixel_value (p, x, y);
+    }
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_add_video_meta_full (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, WIDTH, HEIGHT, GST_VIDEO_INFO_N_PLANES (&info),
+      offset, stride);
+
+  GST_BUFFER_TIMESTAMP (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = GST_SECOND / 25;
+
+  return buffer;
+}
+
+static void
+check_padded_digests (const gchar * hash)
+{
+  GstElement *checksumsink;
+  GPrintFunc old_handler;
+  gchar **unpadded, **padded;
+
+  checksumsink = setup_checksumsink (hash);
+  old_handler = g_set_print_handler (print_handler);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, create_frame (0)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, create_frame (PADDING)),
+      GST_FLOW_OK);
+
+  g_set_print_handler (old_handler);
+  cleanup_checksumsink (checksumsink);
+
+  fail_unless_equals_int (g_list_length (printed), 2);
+
+  /* "<timestamp> <frame digest> <plane digest>..." */
+  unpadded = g_strsplit (g_strstrip (printed->data), " ", -1);
+  padded = g_strsplit (g_strstrip (printed->next->data), " ", -1);
+  fail_unless_equals_int (g_strv_length (unpadded), 2 + 3);
+  fail_unless_equals_int (g_strv_length (padded), 2 + 3);
+
+  /* the padding must not change the plane digests nor the frame digest */
+  fail_unless_equals_string (unpadded[2], padded[2]);
+  fail_unless_equals_string (unpadded[3], padded[3]);
+  fail_unless_equals_string (unpadded[4], padded[4]);
+  fail_unless_equals_string (unpadded[1], padded[1]);
+
+  /* the planes hold different pixels */
+  fail_if (g_str_equal (unpadded[2], unpadded[3]));
+  fail_if (g_str_equal (unpadded[3], unpadded[4]));
+
+  g_strfreev (unpadded);
+  g_strfreev (padded);
+  g_list_free_full (printed, g_free);
+  printed = NULL;
+}
+
+GST_START_TEST (test_padded_planes_xxh64)
+{
+  check_padded_digests ("xxh64");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_padded_planes_sha1)
+{
+  check_padded_digests ("sha1");
+}
+
+GST_END_TEST;
+
+static Suite *
+checksumsink_suite (void)
+{
+  Suite *s = suite_create ("checksumsink");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_padded_planes_xxh64);
+  tcase_add_test (tc_chain, test_padded_planes_sha1);
+
+  return s;
+}
+
+GST_CHECK_MAIN (checksumsink);
@@ -0,0 +1,402 @@
+/* GStreamer
+ *
+ * unit test for compare
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+#define WIDTH 16
+#define HEIGHT 16
+
+static GstPad *mysrcpad, *mycheckpad, *mysinkpad;
+static GstBus *bus;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw")
+    );
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw")
+    );
+
+static void
+setup_events (GstPad * pad, const gchar * stream_id, GstVideoFormat format)
+{
+  GstVideoInfo info;
+  GstCaps *caps;
+  GstSegment segment;
+
+  gst_video_info_set_format (&info, format, WIDTH, HEIGHT);
+  caps = gst_video_info_to_caps (&info);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  fail_unless (gst_pad_push_event (pad,
+          gst_event_new_stream_start (stream_id)));
+  fail_unless (gst_pad_push_event (pad, gst_event_new_caps (caps)));
+  fail_unless (gst_pad_push_event (pad, gst_event_new_segment (&segment)));
+  gst_caps_unref (caps);
+}
+
+static GstElement *
+setup_compare (const gchar * method, GstVideoFormat format,
+    GstVideoFormat check_format)
+{
+  GstElement *compare;
+
+  compare = gst_check_setup_element ("compare");
+  gst_util_set_object_arg (G_OBJECT (compare), "method", method);
+
+  mysrcpad = gst_check_setup_src_pad_by_name (compare, &srctemplate, "sink");
+  mycheckpad = gst_check_setup_src_pad_by_name (compare, &srctemplate,
+      "check");
+  mysinkpad = gst_check_setup_sink_pad (compare, &sinktemplate);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mycheckpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (compare, bus);
+
+  fail_unless (gst_element_set_state (compare,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  setup_events (mysrcpad, "sink", format);
+  setup_events (mycheckpad, "check", check_format);
+
+  return compare;
+}
+
+static void
+cleanup_compare (GstElement * compare)
+{
+  gst_element_set_state (compare, GST_STATE_NULL);
+  gst_element_set_bus (compare, NULL);
+  gst_object_unref (bus);
+  bus = NULL;
+
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mycheckpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_pad_by_name (compare, "sink");
+  gst_check_teardown_pad_by_name (compare, "check");
+  gst_check_teardown_sink_pad (compare);
+  gst_check_teardown_element (compare);
+}
+
+/* a frame with all samples of plane p set to values[p] */
+static GstBuffer *
+create_frame (GstVideoFormat format, const guint * values)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  guint p, x, y;
+
+  gst_video_info_set_format (&info, format, WIDTH, HEIGHT);
+  buffer = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_WRITE));
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame); p++) {
+    guint width = GST_VIDEO_FRAME_COMP_WIDTH (&frame, p);
+    guint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, p);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, p); y++) {
+      guint8 *row = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, p) +
+          y * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p);
+
+      for (x = 0; x < width; x++) {
+        if (pstride == 2)
+          GST_WRITE_UINT16_LE (row + 2 * x, values[p]);
+        else
+          row[x] = values[p];
+      }
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  GST_BUFFER_TIMESTAMP (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = GST_SECOND / 25;
+
+  return buffer;
+}
+
+static gpointer
+push_buffer_thread (gpointer data)
+{
+  return GINT_TO_POINTER (gst_pad_push (mysrcpad, GST_BUFFER (data)));
+}
+
+/* compare waits for a buffer on both sink pads, so one of them is pushed
+ * from another thread; returns the structure of the delta message, or NULL
+ * if none was posted */
+static GstStructure *
+compare_frames (GstBuffer * buffer, GstBuffer * check)
+{
+  GstMessage *message;
+  GstStructure *s = NULL;
+  GThread *thread;
+
+  thread = g_thread_new ("push", push_buffer_thread, buffer);
+  fail_unless_equals_int (gst_pad_push (mycheckpad, check), GST_FLOW_OK);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+
+  /* the buffer of the sink pad goes downstream in any case */
+  fail_unless_equals_int (g_list_length (buffers), 1);
+
+  message = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+  if (message) {
+    s = gst_structure_copy (gst_message_get_structure (message));
+    gst_message_unref (message);
+    fail_unless (gst_structure_has_name (s, "delta"));
+  }
+
+  return s;
+}
+
+static void
+check_field (const GstStructure * s, const gchar * field, gdouble expected)
+{
+  gdouble value;
+
+  fail_unless (gst_structure_get_double (s, field, &value),
+      "no %s in %" GST_PTR_FORMAT, field, s);
+  fail_unless (fabs (value - expected) < 1e-6, "%s is %f instead of %f",
+      field, value, expected);
+}
+
+static gdouble
+psnr (gdouble mse, gdouble peak)
+{
+  return 10.0 * log10 (peak * peak / mse);
+}
+
+static const guint i420_values[] = { 0x40, 0x80, 0x80 };
+
+/* plane 1 is offset by 4, the others are identical */
+static const guint i420_offset_values[] = { 0x40, 0x84, 0x80 };
+
+static const guint gray16_values[] = { 0x1000 };
+
+static const guint gray16_offset_values[] = { 0x1100 };
+
+GST_START_TEST (test_mse_identical)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("mse", GST_VIDEO_FORMAT_I420,
+      GST_VIDEO_FORMAT_I420);
+  /* report every frame */
+  g_object_set (compare, "upper", FALSE, "threshold", 1e9, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_I420, i420_values),
+      create_frame (GST_VIDEO_FORMAT_I420, i420_values));
+  fail_unless (s != NULL);
+  check_field (s, "content", 0.0);
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_mse_8bit)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("mse", GST_VIDEO_FORMAT_I420,
+      GST_VIDEO_FORMAT_I420);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_I420, i420_values),
+      create_frame (GST_VIDEO_FORMAT_I420, i420_offset_values));
+  fail_unless (s != NULL);
+  /* 8x8 samples with an error of 16 out of 16x16 + 2 * 8x8 samples */
+  check_field (s, "content", 64 * 16.0 / 384);
+  check_field (s, "plane-0", 0.0);
+  check_field (s, "plane-1", 16.0);
+  check_field (s, "plane-2", 0.0);
+  fail_if (gst_structure_has_field (s, "plane-3"));
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_mse_16bit)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("mse", GST_VIDEO_FORMAT_GRAY16_LE,
+      GST_VIDEO_FORMAT_GRAY16_LE);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_values), create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_offset_values));
+  fail_unless (s != NULL);
+  /* the plane MSE is in the sample range, the total is normalised to the
+   * 8 bit range */
+  check_field (s, "content", 65536 * (255.0 * 255.0) / (65535.0 * 65535.0));
+  check_field (s, "plane-0", 65536.0);
+  fail_if (gst_structure_has_field (s, "plane-1"));
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_psnr_identical)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("psnr", GST_VIDEO_FORMAT_GRAY16_LE,
+      GST_VIDEO_FORMAT_GRAY16_LE);
+  g_object_set (compare, "upper", FALSE, "threshold", 1e9, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_values), create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_values));
+  fail_unless (s != NULL);
+  check_field (s, "content", 100.0);
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_psnr_8bit)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("psnr", GST_VIDEO_FORMAT_I420,
+      GST_VIDEO_FORMAT_I420);
+  g_object_set (compare, "upper", FALSE, "threshold", 1e9, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_I420, i420_values),
+      create_frame (GST_VIDEO_FORMAT_I420, i420_offset_values));
+  fail_unless (s != NULL);
+  check_field (s, "content", psnr (64 * 16.0 / 384, 255.0));
+  check_field (s, "plane-0", 100.0);
+  check_field (s, "plane-1", psnr (16.0, 255.0));
+  check_field (s, "plane-2", 100.0);
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_psnr_16bit)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  compare = setup_compare ("psnr", GST_VIDEO_FORMAT_GRAY16_LE,
+      GST_VIDEO_FORMAT_GRAY16_LE);
+  g_object_set (compare, "upper", FALSE, "threshold", 1e9, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_values), create_frame (GST_VIDEO_FORMAT_GRAY16_LE,
+          gray16_offset_values));
+  fail_unless (s != NULL);
+  /* the plane uses the 16 bit peak, which the normalised total matches */
+  check_field (s, "content", psnr (65536.0, 65535.0));
+  check_field (s, "plane-0", psnr (65536.0, 65535.0));
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+/* I420 and YV12 frames have the same size, but never match */
+GST_START_TEST (test_format_mismatch)
+{
+  GstElement *compare;
+  GstStructure *s;
+
+  /* a lower bound the delta of a mismatch is above */
+  compare = setup_compare ("mse", GST_VIDEO_FORMAT_I420,
+      GST_VIDEO_FORMAT_YV12);
+  g_object_set (compare, "upper", FALSE, "threshold", 0.0, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_I420, i420_values),
+      create_frame (GST_VIDEO_FORMAT_YV12, i420_offset_values));
+  fail_unless (s != NULL);
+  fail_if (gst_structure_has_field (s, "plane-0"));
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+
+  /* an upper bound the delta of a mismatch is below */
+  compare = setup_compare ("psnr", GST_VIDEO_FORMAT_I420,
+      GST_VIDEO_FORMAT_YV12);
+  g_object_set (compare, "upper", TRUE, "threshold", 30.0, NULL);
+
+  s = compare_frames (create_frame (GST_VIDEO_FORMAT_I420, i420_values),
+      create_frame (GST_VIDEO_FORMAT_YV12, i420_offset_values));
+  fail_unless (s != NULL);
+  fail_if (gst_structure_has_field (s, "plane-0"));
+  gst_structure_free (s);
+
+  cleanup_compare (compare);
+}
+
+GST_END_TEST;
+
+static Suite *
+compare_suite (void)
+{
+  Suite *s = suite_create ("compare");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_mse_identical);
+  tcase_add_test (tc_chain, test_mse_8bit);
+  tcase_add_test (tc_chain, test_mse_16bit);
+  tcase_add_test (tc_chain, test_psnr_identical);
+  tcase_add_test (tc_chain, test_psnr_8bit);
+  tcase_add_test (tc_chain, test_psnr_16bit);
+  tcase_add_test (tc_chain, test_format_mismatch);
+
+  return s;
+}
+
+GST_CHECK_MAIN (compare);
@@ -0,0 +1,140 @@
+/* GStreamer
+ *
+ * unit test for dvbsrc, with a pipe standing in for the dvr device
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+/* the element can't start without a frontend to tune, so the reading code
+ * is tested directly on a pipe */
+#include "../../sys/dvb/gstdvbsrc.c"
+
+static gint pipe_fds[2];
+
+static GstDvbSrc *
+setup_dvbsrc (void)
+{
+  GstDvbSrc *src;
+
+  GST_DEBUG_CATEGORY_INIT (gstdvbsrc_debug, "dvbsrc", 0, "DVB Source Element");
+
+  fail_unless (pipe (pipe_fds) == 0);
+  /* the dvr device is opened non-blocking */
+  fcntl (pipe_fds[0], F_SETFL, O_NONBLOCK);
+
+  src = g_object_new (GST_TYPE_DVBSRC, NULL);
+  g_object_set (src, "low-latency", TRUE, NULL);
+
+  src->fd_dvr = pipe_fds[0];
+  src->poll = gst_poll_new (TRUE);
+  gst_poll_fd_init (&src->poll_fd_dvr);
+  src->poll_fd_dvr.fd = src->fd_dvr;
+  gst_poll_add_fd (src->poll, &src->poll_fd_dvr);
+  gst_poll_fd_ctl_read (src->poll, &src->poll_fd_dvr, TRUE);
+
+  return src;
+}
+
+static void
+cleanup_dvbsrc (GstDvbSrc * src)
+{
+  gst_poll_free (src->poll);
+  src->poll = NULL;
+  close (src->fd_dvr);
+  src->fd_dvr = -1;
+  gst_object_unref (src);
+}
+
+static void
+write_packets (gint fd, guint size)
+{
+  guint8 *data = g_malloc (size);
+
+  memset (data, 0x47, size);
+  fail_unless_equals_int (write (fd, data, size), size);
+  g_free (data);
+}
+
+/* waits until the reader took everything in the pipe, then completes the
+ * first packet and writes two more */
+static gpointer
+writer_thread (gpointer user_data)
+{
+  gint avail;
+
+  do {
+    g_usleep (1000);
+    if (ioctl (pipe_fds[0], FIONREAD, &avail) < 0)
+      break;
+  } while (avail > 0);
+
+  write_packets (pipe_fds[1], TS_SIZE - 100 + 2 * TS_SIZE);
+
+  return NULL;
+}
+
+GST_START_TEST (test_low_latency_partial_packet)
+{
+  GstDvbSrc *src;
+  GstBuffer *buf;
+  GThread *thread;
+
+  src = setup_dvbsrc ();
+
+  /* only part of the first packet is there when reading starts */
+  write_packets (pipe_fds[1], 100);
+  thread = g_thread_new ("writer", writer_thread, NULL);
+
+  /* the read that completes the packet must not take the next packets */
+  buf = gst_buffer_new_allocate (NULL, 8 * TS_SIZE, NULL);
+  fail_unless_equals_int (gst_dvbsrc_read_device (src, buf), GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buf), TS_SIZE);
+  gst_buffer_unref (buf);
+
+  g_thread_join (thread);
+
+  /* the next read returns the packets that are there */
+  buf = gst_buffer_new_allocate (NULL, 8 * TS_SIZE, NULL);
+  fail_unless_equals_int (gst_dvbsrc_read_device (src, buf), GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 2 * TS_SIZE);
+  gst_buffer_unref (buf);
+
+  /* a pipe ends the stream when the writer goes away */
+  close (pipe_fds[1]);
+  buf = gst_buffer_new_allocate (NULL, 8 * TS_SIZE, NULL);
+  fail_unless_equals_int (gst_dvbsrc_read_device (src, buf), GST_FLOW_EOS);
+  gst_buffer_unref (buf);
+
+  cleanup_dvbsrc (src);
+}
+
+GST_END_TEST;
+
+static Suite *
+dvbsrc_suite (void)
+{
+  Suite *s = suite_create ("dvbsrc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_low_latency_partial_packet);
+
+  return s;
+}
+
+GST_CHECK_MAIN (dvbsrc);
@@ -262,6 +262,145 @@ GST_START_TEST (test_audio_in_one_buffer)
 
 GST_END_TEST;
 
+/* 2.0 headers vary in length; caps ids, references to them and batches of
+ * buffers are all depayloaded */
+GST_START_TEST (test_version_2_0)
+{
+  GstCaps *caps, *outcaps;
+  GstPad *srcpad;
+  GstElement *gdpdepay;
+  GstBuffer *inbuffers[3], *outbuffer;
+  guint8 *header, *payload;
+  guint len, i;
+  GstDPHeaderFlag flags;
+
+  flags = GST_DP_HEADER_FLAG_CRC_HEADER | GST_DP_HEADER_FLAG_CRC_PAYLOAD;
+
+  gdpdepay = setup_gdpdepay ();
+  srcpad = gst_element_get_static_pad (gdpdepay, "src");
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_new_empty_simple ("application/x-gdp");
+  gst_check_setup_events (mysrcpad, gdpdepay, caps, GST_FORMAT_BYTES);
+  gst_caps_unref (caps);
+
+  /* caps with id 1, byte by byte so the header length is found piecewise */
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  fail_unless (gst_dp_packet_from_caps_with_id (caps, 1, flags, &len, &header,
+          &payload));
+  fail_unless (len < GST_DP_HEADER_LENGTH);
+  fail_unless_equals_int (gst_dp_header_caps_id (len, header), 1);
+  gdpdepay_push_per_byte ("caps header", header, len);
+  gdpdepay_push_per_byte ("caps payload", payload,
+      gst_dp_header_payload_length (header));
+  g_free (header);
+  g_free (payload);
+
+  outcaps = gst_pad_get_current_caps (srcpad);
+  fail_unless (outcaps != NULL);
+  fail_unless (gst_caps_is_equal (outcaps, caps));
+  gst_caps_unref (outcaps);
+
+  /* a batch of three buffers in one packet */
+  for (i = 0; i < 3; i++) {
+    inbuffers[i] = gst_buffer_new_and_alloc (4);
+    gst_buffer_fill (inbuffers[i], 0, "f00d", 4);
+    GST_BUFFER_TIMESTAMP (inbuffers[i]) = i * GST_SECOND;
+    GST_BUFFER_DURATION (inbuffers[i]) = GST_SECOND;
+  }
+  fail_unless (gst_dp_header_from_buffers (inbuffers, 3, flags, &len,
+          &header));
+  fail_unless_equals_int (gst_dp_header_payload_type (header),
+      GST_DP_PAYLOAD_BUFFER_LIST);
+  fail_unless_equals_int (gst_dp_header_payload_length (header), 12);
+  gdpdepay_push_per_byte ("list header", header, len);
+  gdpdepay_push_per_byte ("list payload", (const guint8 *) "f00df00df00d", 12);
+  g_free (header);
+
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  for (i = 0; i < 3; i++) {
+    outbuffer = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (outbuffer), 4);
+    fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (outbuffer),
+        i * GST_SECOND);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuffer), GST_SECOND);
+    fail_unless (gst_buffer_memcmp (outbuffer, 0, "f00d", 4) == 0);
+    gst_buffer_unref (inbuffers[i]);
+  }
+
+  /* a reference to caps id 1 has no payload and keeps the caps */
+  fail_unless (gst_dp_packet_from_caps_with_id (NULL, 1, flags, &len,
+          &header, &payload));
+  fail_unless (payload == NULL);
+  fail_unless_equals_int (gst_dp_header_payload_length (header), 0);
+  gdpdepay_push_per_byte ("caps reference", header, len);
+  g_free (header);
+
+  outcaps = gst_pad_get_current_caps (srcpad);
+  fail_unless (outcaps != NULL);
+  fail_unless (gst_caps_is_equal (outcaps, caps));
+  gst_caps_unref (outcaps);
+  gst_caps_unref (caps);
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_object_unref (srcpad);
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+  ASSERT_OBJECT_REFCOUNT (gdpdepay, "gdpdepay", 1);
+  cleanup_gdpdepay (gdpdepay);
+}
+
+GST_END_TEST;
+
+/* receivers only remember a bounded number of caps ids */
+GST_START_TEST (test_version_2_0_caps_id_limit)
+{
+  GstCaps *caps;
+  GstElement *gdpdepay;
+  GstBuffer *inbuffer;
+  guint8 *header, *payload;
+  guint len, plen;
+
+  gdpdepay = setup_gdpdepay ();
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_new_empty_simple ("application/x-gdp");
+  gst_check_setup_events (mysrcpad, gdpdepay, caps, GST_FORMAT_BYTES);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  fail_unless (gst_dp_packet_from_caps_with_id (caps,
+          GST_DP_MAX_CAPS_IDS + 1, GST_DP_HEADER_FLAG_NONE, &len, &header,
+          &payload));
+  gst_caps_unref (caps);
+
+  plen = gst_dp_header_payload_length (header);
+  inbuffer = gst_buffer_new_and_alloc (len + plen);
+  gst_buffer_fill (inbuffer, 0, header, len);
+  gst_buffer_fill (inbuffer, len, payload, plen);
+  g_free (header);
+  g_free (payload);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_ERROR);
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  ASSERT_OBJECT_REFCOUNT (gdpdepay, "gdpdepay", 1);
+  cleanup_gdpdepay (gdpdepay);
+}
+
+GST_END_TEST;
+
 static GstStaticPadTemplate shsinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -403,6 +542,8 @@ gdpdepay_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_audio_per_byte);
   tcase_add_test (tc_chain, test_audio_in_one_buffer);
+  tcase_add_test (tc_chain, test_version_2_0);
+  tcase_add_test (tc_chain, test_version_2_0_caps_id_limit);
   tcase_add_test (tc_chain, test_streamheader);
 
   return s;
@@ -198,6 +198,122 @@ GST_START_TEST (test_audio)
 
 GST_END_TEST;
 
+/* the payload memory of a GDP buffer packet is the memory of the input
+ * buffer, and the header is a separate memory in front of it */
+GST_START_TEST (test_payload_no_copy)
+{
+  GstCaps *caps;
+  GstElement *gdppay;
+  GstBuffer *inbuffer, *outbuffer;
+  GstMemory *inmem;
+
+  gdppay = setup_gdppay ();
+
+  fail_unless (gst_element_set_state (gdppay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (4);
+  inmem = gst_memory_ref (gst_buffer_peek_memory (inbuffer, 0));
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, gdppay, caps, GST_FORMAT_TIME);
+
+  /* pushing gives away my reference */
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+
+  /* new_segment, caps and the buffer */
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  outbuffer = GST_BUFFER (g_list_last (buffers)->data);
+
+  fail_unless_equals_int (gst_buffer_n_memory (outbuffer), 2);
+  fail_unless_equals_int (gst_memory_get_sizes (gst_buffer_peek_memory
+          (outbuffer, 0), NULL, NULL), GST_DP_HEADER_LENGTH);
+  fail_unless (gst_buffer_peek_memory (outbuffer, 1) == inmem);
+
+  fail_unless (gst_element_set_state (gdppay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_memory_unref (inmem);
+  gst_caps_unref (caps);
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+  ASSERT_OBJECT_REFCOUNT (gdppay, "gdppay", 1);
+  cleanup_gdppay (gdppay);
+}
+
+GST_END_TEST;
+
+/* push 100 buffers of 10 ms of audio and return the number of bytes GDP
+ * added on top of the 4000 bytes of audio data */
+static gsize
+push_audio_stream (GstDPVersion version, guint batch_size)
+{
+  GstCaps *caps;
+  GstElement *gdppay;
+  GstBuffer *inbuffer;
+  GList *l;
+  gsize total = 0;
+  gint i;
+
+  gdppay = setup_gdppay ();
+  g_object_set (gdppay, "version", version, "batch-size", batch_size, NULL);
+
+  fail_unless (gst_element_set_state (gdppay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, gdppay, caps, GST_FORMAT_TIME);
+
+  /* 10 ms of stereo S16 at 1000 Hz is 40 bytes */
+  for (i = 0; i < 100; i++) {
+    inbuffer = gst_buffer_new_and_alloc (40);
+    GST_BUFFER_TIMESTAMP (inbuffer) = i * 10 * GST_MSECOND;
+    GST_BUFFER_DURATION (inbuffer) = 10 * GST_MSECOND;
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  for (l = buffers; l; l = l->next)
+    total += gst_buffer_get_size (GST_BUFFER (l->data));
+
+  fail_unless (gst_element_set_state (gdppay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_caps_unref (caps);
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+  ASSERT_OBJECT_REFCOUNT (gdppay, "gdppay", 1);
+  cleanup_gdppay (gdppay);
+
+  fail_unless (total > 100 * 40);
+  return total - 100 * 40;
+}
+
+/* version 2.0 with batching adds a fraction of the 1.0 overhead to a stream
+ * of small audio buffers */
+GST_START_TEST (test_audio_throughput)
+{
+  gsize overhead_1_0, overhead_2_0, overhead_2_0_batch;
+
+  overhead_1_0 = push_audio_stream (GST_DP_VERSION_1_0, 1);
+  overhead_2_0 = push_audio_stream (GST_DP_VERSION_2_0, 1);
+  overhead_2_0_batch = push_audio_stream (GST_DP_VERSION_2_0, 10);
+
+  GST_DEBUG ("GDP overhead for 100 buffers: 1.0 %" G_GSIZE_FORMAT
+      ", 2.0 %" G_GSIZE_FORMAT ", 2.0 in batches of 10 %" G_GSIZE_FORMAT,
+      overhead_1_0, overhead_2_0, overhead_2_0_batch);
+
+  /* at least the 62 byte header for each buffer */
+  fail_unless (overhead_1_0 >= 100 * GST_DP_HEADER_LENGTH);
+  fail_unless (overhead_2_0 * 2 < overhead_1_0);
+  fail_unless (overhead_2_0_batch < overhead_2_0);
+}
+
+GST_END_TEST;
+
 static GstStaticPadTemplate shsrctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -536,6 +652,8 @@ gdppay_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_audio);
+  tcase_add_test (tc_chain, test_payload_no_copy);
+  tcase_add_test (tc_chain, test_audio_throughput);
   tcase_add_test (tc_chain, test_first_no_caps);
   tcase_add_test (tc_chain, test_first_no_new_segment);
   tcase_add_test (tc_chain, test_streamheader);
@@ -0,0 +1,252 @@
+/* GStreamer
+ *
+ * unit test for the m3u8 playlist parser of hlsdemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#undef GST_CAT_DEFAULT
+#include "../../ext/hls/m3u8.c"
+
+GST_DEBUG_CATEGORY (fragmented_debug);
+
+#define PLAYLIST_URI "http://localhost/live/playlist.m3u8"
+
+/* a live window of the sequences 0 to 3 */
+static const gchar *LIVE_PLAYLIST = "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:10\n"
+    "#EXT-X-MEDIA-SEQUENCE:0\n"
+    "#EXTINF:10,Segment 0\n"
+    "0.ts\n"
+    "#EXTINF:10,Segment 1\n"
+    "1.ts\n"
+    "#EXTINF:9.5,Segment 2\n"
+    "2.ts\n"
+    "#EXTINF:10,Segment 3\n"
+    "3.ts\n";
+
+/* the window slid to the sequences 2 to 5 */
+static const gchar *SLID_PLAYLIST = "#EXTM3U\n"
+    "#EXT-X-VERSION:9\n"
+    "#EXT-X-TARGETDURATION:10\n"
+    "#EXT-X-MEDIA-SEQUENCE:2\n"
+    "#EXTINF:9.5,Segment 2\n"
+    "2.ts\n"
+    "#EXTINF:10,Segment 3\n"
+    "3.ts\n"
+    "#EXTINF:10,Segment 4\n"
+    "4.ts\n"
+    "#EXTINF:8.5,Segment 5\n"
+    "5.ts\n";
+
+/* the same window as a delta update that leaves out the known segments */
+static const gchar *SKIP_PLAYLIST = "#EXTM3U\n"
+    "#EXT-X-VERSION:9\n"
+    "#EXT-X-TARGETDURATION:10\n"
+    "#EXT-X-MEDIA-SEQUENCE:2\n"
+    "#EXT-X-SKIP:SKIPPED-SEGMENTS=2\n"
+    "#EXTINF:10,Segment 4\n"
+    "4.ts\n"
+    "#EXTINF:8.5,Segment 5\n"
+    "5.ts\n";
+
+/* a window far past the known one */
+static const gchar *JUMP_PLAYLIST = "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:10\n"
+    "#EXT-X-MEDIA-SEQUENCE:100\n"
+    "#EXTINF:10,Segment 100\n"
+    "100.ts\n"
+    "#EXTINF:10,Segment 101\n"
+    "101.ts\n";
+
+/* the window slid by one, with a discontinuity before the new segments */
+static const gchar *DISCONT_PLAYLIST = "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:10\n"
+    "#EXT-X-MEDIA-SEQUENCE:1\n"
+    "#EXTINF:10,Segment 1\n"
+    "1.ts\n"
+    "#EXTINF:9.5,Segment 2\n"
+    "2.ts\n"
+    "#EXTINF:10,Segment 3\n"
+    "3.ts\n"
+    "#EXT-X-DISCONTINUITY\n"
+    "#EXTINF:5,Other 0\n"
+    "http://localhost/other/0.ts\n"
+    "#EXTINF:5,Other 1\n"
+    "http://localhost/other/1.ts\n";
+
+static GstM3U8Client *
+load_playlist (const gchar * data)
+{
+  GstM3U8Client *client;
+
+  client = gst_m3u8_client_new (PLAYLIST_URI);
+  fail_unless (gst_m3u8_client_update (client, g_strdup (data)));
+  fail_unless (client->current != NULL);
+
+  return client;
+}
+
+static GstM3U8MediaFile *
+get_file (GstM3U8Client * client, guint idx)
+{
+  return g_ptr_array_index (client->current->files, idx);
+}
+
+/* the files of a playlist refreshed with a delta must be the ones of a
+ * full parse; timestamps only have to match relative to the first file,
+ * a refresh keeps the timestamps of the files it already had */
+static void
+compare_files (GstM3U8Client * delta, GstM3U8Client * full)
+{
+  GstClockTime delta_start, full_start;
+  guint i;
+
+  fail_unless_equals_int (delta->current->files->len,
+      full->current->files->len);
+  fail_unless (delta->current->files->len > 0);
+
+  delta_start = get_file (delta, 0)->timestamp;
+  full_start = get_file (full, 0)->timestamp;
+  fail_unless_equals_uint64 (full_start, 0);
+
+  for (i = 0; i < full->current->files->len; i++) {
+    GstM3U8MediaFile *d = get_file (delta, i);
+    GstM3U8MediaFile *f = get_file (full, i);
+
+    fail_unless_equals_int (d->sequence, f->sequence);
+    fail_unless_equals_string (d->uri, f->uri);
+    fail_unless_equals_string (d->title, f->title);
+    fail_unless_equals_uint64 (d->duration, f->duration);
+    fail_unless_equals_uint64 (d->timestamp - delta_start,
+        f->timestamp - full_start);
+  }
+
+  fail_unless_equals_uint64 (_get_file_position (delta->current->files,
+          delta->current->files->len), _get_file_position (full->current->files,
+          full->current->files->len));
+  fail_unless_equals_uint64 (delta->current->targetduration,
+      full->current->targetduration);
+}
+
+GST_START_TEST (test_live_refresh)
+{
+  GstM3U8Client *delta, *full;
+  GstM3U8MediaFile *kept;
+
+  delta = load_playlist (LIVE_PLAYLIST);
+  fail_unless_equals_int (delta->current->files->len, 4);
+  kept = get_file (delta, 2);
+
+  fail_unless (gst_m3u8_client_update (delta, g_strdup (SLID_PLAYLIST)));
+  full = load_playlist (SLID_PLAYLIST);
+  compare_files (delta, full);
+
+  /* the files still in the window are not parsed again */
+  fail_unless (get_file (delta, 0) == kept);
+  fail_unless_equals_int (get_file (delta, 0)->sequence, 2);
+
+  gst_m3u8_client_free (delta);
+  gst_m3u8_client_free (full);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_delta_update_skip)
+{
+  GstM3U8Client *delta, *full;
+  GstM3U8MediaFile *kept;
+
+  delta = load_playlist (LIVE_PLAYLIST);
+  kept = get_file (delta, 2);
+
+  fail_unless (gst_m3u8_client_update (delta, g_strdup (SKIP_PLAYLIST)));
+  full = load_playlist (SLID_PLAYLIST);
+  compare_files (delta, full);
+
+  /* the skipped segments are the ones we had */
+  fail_unless (get_file (delta, 0) == kept);
+  fail_unless_equals_string (get_file (delta, 1)->title, "Segment 3");
+  fail_unless_equals_int (get_file (delta, 2)->sequence, 4);
+
+  gst_m3u8_client_free (delta);
+  gst_m3u8_client_free (full);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_media_sequence_jump)
+{
+  GstM3U8Client *delta, *full;
+
+  delta = load_playlist (LIVE_PLAYLIST);
+
+  fail_unless (gst_m3u8_client_update (delta, g_strdup (JUMP_PLAYLIST)));
+  full = load_playlist (JUMP_PLAYLIST);
+  compare_files (delta, full);
+
+  /* nothing of the old window is kept, so timestamps start over */
+  fail_unless_equals_int (get_file (delta, 0)->sequence, 100);
+  fail_unless_equals_uint64 (get_file (delta, 0)->timestamp, 0);
+
+  gst_m3u8_client_free (delta);
+  gst_m3u8_client_free (full);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_discontinuity)
+{
+  GstM3U8Client *delta, *full;
+
+  delta = load_playlist (LIVE_PLAYLIST);
+
+  fail_unless (gst_m3u8_client_update (delta, g_strdup (DISCONT_PLAYLIST)));
+  full = load_playlist (DISCONT_PLAYLIST);
+  compare_files (delta, full);
+
+  fail_unless_equals_int (delta->current->files->len, 5);
+  fail_unless_equals_string (get_file (delta, 3)->uri,
+      "http://localhost/other/0.ts");
+  fail_unless_equals_int (get_file (delta, 4)->sequence, 5);
+
+  gst_m3u8_client_free (delta);
+  gst_m3u8_client_free (full);
+}
+
+GST_END_TEST;
+
+static Suite *
+hlsdemux_m3u8_suite (void)
+{
+  Suite *s = suite_create ("hlsdemux_m3u8");
+  TCase *tc_chain = tcase_create ("general");
+
+  GST_DEBUG_CATEGORY_INIT (fragmented_debug, "fragmented", 0,
+      "hlsdemux m3u8 test");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_live_refresh);
+  tcase_add_test (tc_chain, test_delta_update_skip);
+  tcase_add_test (tc_chain, test_media_sequence_jump);
+  tcase_add_test (tc_chain, test_discontinuity);
+
+  return s;
+}
+
+GST_CHECK_MAIN (hlsdemux_m3u8);
@@ -0,0 +1,110 @@
+/* GStreamer
+ *
+ * unit test for the hlssink playlist
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include "../../ext/hls/gstm3u8playlist.c"
+
+GST_DEBUG_CATEGORY (fragmented_debug);
+
+GST_START_TEST (test_playlist)
+{
+  GstM3U8Playlist *playlist;
+  gchar *text;
+
+  playlist = gst_m3u8_playlist_new (6, 5, FALSE);
+  fail_unless (gst_m3u8_playlist_add_entry (playlist, "seg0.ts", NULL, "",
+          2 * GST_SECOND, 0, FALSE));
+
+  text = gst_m3u8_playlist_render (playlist);
+  fail_unless_equals_string (text,
+      "#EXTM3U\n"
+      "#EXT-X-ALLOW-CACHE:NO\n"
+      "#EXT-X-MEDIA-SEQUENCE:0\n"
+      "#EXT-X-TARGETDURATION:2\n"
+      "\n"
+      "#EXTINF:2,\n"
+      "seg0.ts\n");
+  g_free (text);
+
+  gst_m3u8_playlist_free (playlist);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_playlist_parts)
+{
+  GstM3U8Playlist *playlist;
+  gchar *text;
+
+  playlist = gst_m3u8_playlist_new (6, 5, FALSE);
+  gst_m3u8_playlist_set_part_target (playlist, GST_SECOND);
+
+  /* two parts of the first segment, then the segment itself */
+  fail_unless (gst_m3u8_playlist_add_part (playlist, "seg0.ts", GST_SECOND,
+          0, 1000, TRUE));
+  fail_unless (gst_m3u8_playlist_add_part (playlist, "seg0.ts", GST_SECOND,
+          1000, 500, FALSE));
+  fail_unless (gst_m3u8_playlist_add_entry (playlist, "seg0.ts", NULL, "",
+          2 * GST_SECOND, 0, FALSE));
+  /* the first part of the segment being written */
+  fail_unless (gst_m3u8_playlist_add_part (playlist, "seg1.ts",
+          GST_SECOND / 2, 0, 700, TRUE));
+
+  text = gst_m3u8_playlist_render (playlist);
+  fail_unless_equals_string (text,
+      "#EXTM3U\n"
+      "#EXT-X-VERSION:9\n"
+      "#EXT-X-ALLOW-CACHE:NO\n"
+      "#EXT-X-MEDIA-SEQUENCE:0\n"
+      "#EXT-X-TARGETDURATION:2\n"
+      "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=3.000\n"
+      "#EXT-X-PART-INF:PART-TARGET=1.000\n"
+      "\n"
+      "#EXT-X-PART:DURATION=1.000,URI=\"seg0.ts\",BYTERANGE=\"1000@0\","
+      "INDEPENDENT=YES\n"
+      "#EXT-X-PART:DURATION=1.000,URI=\"seg0.ts\",BYTERANGE=\"500@1000\"\n"
+      "#EXTINF:2,\n"
+      "seg0.ts\n"
+      "#EXT-X-PART:DURATION=0.500,URI=\"seg1.ts\",BYTERANGE=\"700@0\","
+      "INDEPENDENT=YES\n");
+  g_free (text);
+
+  gst_m3u8_playlist_free (playlist);
+}
+
+GST_END_TEST;
+
+static Suite *
+hlssink_suite (void)
+{
+  Suite *s = suite_create ("hlssink");
+  TCase *tc_chain = tcase_create ("general");
+
+  GST_DEBUG_CATEGORY_INIT (fragmented_debug, "fragmented", 0, "fragmented");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_playlist);
+  tcase_add_test (tc_chain, test_playlist_parts);
+
+  return s;
+}
+
+GST_CHECK_MAIN (hlssink);
@@ -64,8 +64,10 @@ on_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
   }
 }
 
+/* probe, if not NULL, is added to the sink pad of the element named sink */
 static void
-run_test (const gchar * pipeline_string)
+run_test_full (const gchar * pipeline_string, GstPadProbeCallback probe,
+    gpointer probe_data)
 {
   GstElement *pipeline;
   GstBus *bus;
@@ -79,6 +81,18 @@ run_test (const gchar * pipeline_string)
   fail_unless (pipeline != NULL);
   g_object_set (G_OBJECT (pipeline), "async-handling", TRUE, NULL);
 
+  if (probe) {
+    GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    GstPad *pad;
+
+    fail_unless (sink != NULL);
+    pad = gst_element_get_static_pad (sink, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+        GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, probe, probe_data, NULL);
+    gst_object_unref (pad);
+    gst_object_unref (sink);
+  }
+
   loop = g_main_loop_new (NULL, FALSE);
 
   bus = gst_element_get_bus (pipeline);
@@ -107,6 +121,125 @@ run_test (const gchar * pipeline_string)
   gst_object_unref (bus);
 }
 
+static void
+run_test (const gchar * pipeline_string)
+{
+  run_test_full (pipeline_string, NULL, NULL);
+}
+
+/* The muxer output as it ends up in a file: the header partition is
+ * rewritten at the end after a new segment from offset 0 */
+typedef struct
+{
+  GByteArray *data;
+  guint64 position;
+} OutputFile;
+
+static GstPadProbeReturn
+output_file_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  OutputFile *file = user_data;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+    gsize size = gst_buffer_get_size (buf);
+
+    if (file->position + size > file->data->len)
+      g_byte_array_set_size (file->data, file->position + size);
+    gst_buffer_extract (buf, 0, file->data->data + file->position, size);
+    file->position += size;
+  } else if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) ==
+      GST_EVENT_SEGMENT) {
+    const GstSegment *segment;
+
+    gst_event_parse_segment (GST_PAD_PROBE_INFO_EVENT (info), &segment);
+    fail_unless_equals_int (segment->format, GST_FORMAT_BYTES);
+    file->position = segment->start;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static const guint8 partition_pack_key[] = {
+  0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01,
+  0x0d, 0x01, 0x02, 0x01, 0x01
+};
+
+static const guint8 index_table_segment_key[] = {
+  0x06, 0x0e, 0x2b, 0x34, 0x02, 0x53, 0x01, 0x01,
+  0x0d, 0x01, 0x02, 0x01, 0x01, 0x10, 0x01, 0x00
+};
+
+static const guint8 random_index_pack_key[] = {
+  0x06, 0x0e, 0x2b, 0x34, 0x02, 0x05, 0x01, 0x01,
+  0x0d, 0x01, 0x02, 0x01, 0x01, 0x11, 0x01, 0x00
+};
+
+/* Parses a KLV packet at offset, returns the offset of its value and sets
+ * length to the length of the value */
+static guint64
+parse_klv (const GByteArray * data, guint64 offset, guint64 * length)
+{
+  const guint8 *p;
+  guint i, n;
+
+  fail_unless (offset + 17 <= data->len);
+  p = data->data + offset + 16;
+  if (p[0] < 0x80) {
+    *length = p[0];
+    n = 0;
+  } else {
+    n = p[0] & 0x7f;
+    fail_unless (n > 0 && n <= 8 && offset + 17 + n <= data->len);
+    *length = 0;
+    for (i = 0; i < n; i++)
+      *length = (*length << 8) | p[1 + i];
+  }
+  fail_unless (offset + 17 + n + *length <= data->len);
+
+  return offset + 17 + n;
+}
+
+static gboolean
+is_partition_pack (const GByteArray * data, guint64 offset, guint8 kind)
+{
+  return offset + 16 <= data->len
+      && memcmp (data->data + offset, partition_pack_key, 13) == 0
+      && data->data[offset + 13] == kind;
+}
+
+/* Sums the index duration of an index table segment and checks that all
+ * its entries are flagged as random access points */
+static guint64
+check_index_table_segment (const guint8 * p, guint64 length)
+{
+  guint64 duration = 0;
+  guint64 pos = 0;
+
+  while (pos + 4 <= length) {
+    guint16 tag = GST_READ_UINT16_BE (p + pos);
+    guint16 size = GST_READ_UINT16_BE (p + pos + 2);
+    const guint8 *value = p + pos + 4;
+
+    fail_unless (pos + 4 + size <= length);
+    if (tag == 0x3f0d) {
+      duration = GST_READ_UINT64_BE (value);
+    } else if (tag == 0x3f0a) {
+      guint32 n_entries = GST_READ_UINT32_BE (value);
+      guint32 entry_size = GST_READ_UINT32_BE (value + 4);
+      guint32 i;
+
+      fail_unless (8 + n_entries * entry_size <= size);
+      /* raw video only has key frames */
+      for (i = 0; i < n_entries; i++)
+        fail_unless_equals_int (value[8 + i * entry_size + 2], 0x80);
+    }
+    pos += 4 + size;
+  }
+
+  return duration;
+}
+
 GST_START_TEST (test_mpeg2)
 {
   const gchar *mpeg2enc_name = get_mpeg2enc_element_name ();
@@ -142,6 +275,118 @@ GST_START_TEST (test_raw_video_raw_audio)
 
 GST_END_TEST;
 
+/* Walks all KLV packets of the muxer output and checks the number of body
+ * partitions and index table segments, the total index duration and the
+ * random index pack */
+static void
+check_partitions (OutputFile * file, guint expected_body,
+    guint expected_segments, guint64 expected_duration)
+{
+  guint64 offset, length, value, rip_offset = 0, index_duration = 0;
+  guint n_body = 0, n_footer = 0, n_segments = 0, n_rip, i;
+  GArray *partitions;
+
+  partitions = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  fail_unless (is_partition_pack (file->data, 0, 0x02));
+
+  for (offset = 0; offset < file->data->len; offset = value + length) {
+    const guint8 *key = file->data->data + offset;
+
+    value = parse_klv (file->data, offset, &length);
+
+    if (is_partition_pack (file->data, offset, 0x03)) {
+      n_body++;
+      g_array_append_val (partitions, offset);
+    } else if (is_partition_pack (file->data, offset, 0x04)) {
+      n_footer++;
+      g_array_append_val (partitions, offset);
+    } else if (is_partition_pack (file->data, offset, 0x02)) {
+      fail_unless_equals_int (offset, 0);
+      g_array_append_val (partitions, offset);
+    } else if (memcmp (key, index_table_segment_key, 16) == 0) {
+      n_segments++;
+      index_duration +=
+          check_index_table_segment (file->data->data + value, length);
+    } else if (memcmp (key, random_index_pack_key, 16) == 0) {
+      rip_offset = offset;
+      fail_unless_equals_int (value + length, file->data->len);
+    }
+  }
+
+  fail_unless_equals_int (n_body, expected_body);
+  fail_unless_equals_int (n_footer, 1);
+  fail_unless_equals_int (n_segments, expected_segments);
+  fail_unless_equals_int (index_duration, expected_duration);
+
+  /* the random index pack lists every partition */
+  fail_unless (rip_offset > 0);
+  value = parse_klv (file->data, rip_offset, &length);
+  n_rip = (length - 4) / 12;
+  fail_unless_equals_int (n_rip, partitions->len);
+  for (i = 0; i < n_rip; i++) {
+    guint64 rip_entry = GST_READ_UINT64_BE (file->data->data + value + i * 12 +
+        4);
+
+    fail_unless_equals_uint64 (rip_entry,
+        g_array_index (partitions, guint64, i));
+  }
+
+  g_array_free (partitions, TRUE);
+}
+
+GST_START_TEST (test_raw_video_raw_audio_partitions)
+{
+  gchar *pipeline;
+  OutputFile file;
+
+  file.data = g_byte_array_new ();
+  file.position = 0;
+
+  /* 10 seconds of 25 fps video and audio in 40ms buffers */
+  pipeline = g_strdup_printf ("videotestsrc num-buffers=250 ! "
+      "video/x-raw,format=(string)v308,width=320,height=240,framerate=25/1 ! "
+      "mxfmux name=mux partition-duration=1000000000 ! "
+      "fakesink name=sink  "
+      "audiotestsrc num-buffers=250 samplesperbuffer=1920 ! "
+      "audioconvert ! " "audio/x-raw,rate=48000,channels=2 ! " "mux. ");
+
+  run_test_full (pipeline, output_file_probe, &file);
+  g_free (pipeline);
+
+  /* a body partition every second, the first one without index, the other
+   * ones and the footer with the index of the previous second */
+  check_partitions (&file, 10, 10, 250);
+
+  g_byte_array_free (file.data, TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_raw_video_index_limit)
+{
+  gchar *pipeline;
+  OutputFile file;
+
+  file.data = g_byte_array_new ();
+  file.position = 0;
+
+  pipeline = g_strdup_printf ("videotestsrc num-buffers=4500 ! "
+      "video/x-raw,format=(string)v308,width=16,height=16,framerate=25/1 ! "
+      "mxfmux name=mux ! " "fakesink name=sink");
+
+  run_test_full (pipeline, output_file_probe, &file);
+  g_free (pipeline);
+
+  /* without partition duration a new body partition is only started once
+   * the index of the current one is full, after 4096 edit units */
+  check_partitions (&file, 2, 2, 4500);
+
+  g_byte_array_free (file.data, TRUE);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_raw_video_stride_transform)
 {
   gchar *pipeline;
@@ -255,6 +500,8 @@ mxfmux_suite (void)
 
   tcase_add_test (tc_chain, test_mpeg2);
   tcase_add_test (tc_chain, test_raw_video_raw_audio);
+  tcase_add_test (tc_chain, test_raw_video_raw_audio_partitions);
+  tcase_add_test (tc_chain, test_raw_video_index_limit);
   tcase_add_test (tc_chain, test_raw_video_stride_transform);
   tcase_add_test (tc_chain, test_jpeg2000_alaw);
   tcase_add_test (tc_chain, test_dnxhd_mp3);
@@ -0,0 +1,226 @@
+/* GStreamer
+ *
+ * unit test for watchdog
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* buffers the blocked branch passes before it blocks */
+#define BLOCK_AFTER 5
+
+static GMutex block_lock;
+static GCond block_cond;
+static gboolean released;
+
+/* lets the first @user_data buffers through, then blocks the streaming
+ * thread until released */
+static GstPadProbeReturn
+block_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  gint *count = user_data;
+
+  if ((*count)-- > 0)
+    return GST_PAD_PROBE_OK;
+
+  g_mutex_lock (&block_lock);
+  while (!released)
+    g_cond_wait (&block_cond, &block_lock);
+  g_mutex_unlock (&block_lock);
+
+  return GST_PAD_PROBE_DROP;
+}
+
+static void
+block_src (GstElement * pipeline, const gchar * name, gint * count)
+{
+  GstElement *src;
+  GstPad *pad;
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  fail_unless (src != NULL);
+  pad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, block_probe, count,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (src);
+}
+
+/* the stats the stall message has for the pad @pad_name of @element_name */
+static const GstStructure *
+find_pad_stats (const GstStructure * stall, const gchar * element_name,
+    const gchar * pad_name)
+{
+  const GValue *pads;
+  const GstStructure *found = NULL;
+  gchar *suffix;
+  guint i;
+
+  pads = gst_structure_get_value (stall, "pads");
+  fail_unless (pads != NULL);
+
+  suffix = g_strdup_printf (":%s.GstPad:%s", element_name, pad_name);
+  for (i = 0; i < gst_value_array_get_size (pads); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_array_get_value (pads, i));
+
+    if (g_str_has_suffix (gst_structure_get_string (s, "pad"), suffix))
+      found = s;
+  }
+  fail_unless (found != NULL, "no stats for %s", suffix);
+  g_free (suffix);
+
+  return found;
+}
+
+static void
+check_pad_stats (const GstStructure * stall, const gchar * element_name,
+    const gchar * pad_name, gboolean stalled)
+{
+  const GstStructure *s;
+  gboolean pad_stalled;
+  guint64 idle;
+  guint buffers;
+
+  s = find_pad_stats (stall, element_name, pad_name);
+  fail_unless (gst_structure_get_uint (s, "buffers", &buffers));
+  fail_unless (gst_structure_get_uint64 (s, "idle", &idle));
+  fail_unless (gst_structure_get_boolean (s, "stalled", &pad_stalled));
+  fail_unless_equals_int (pad_stalled, stalled);
+  fail_unless (buffers > 0);
+  fail_unless (GST_CLOCK_TIME_IS_VALID (idle));
+}
+
+/* of three live branches one runs, one blocks after a few buffers and one
+ * blocks before its first buffer; the watchdog is in the one that blocks
+ * after a few buffers */
+GST_START_TEST (test_stall_message)
+{
+  GstElement *pipeline, *watchdog;
+  GstBus *bus;
+  GstMessage *message;
+  GstStructure *stall, *stats;
+  const GstStructure *s;
+  gint blocked_count = BLOCK_AFTER, idle_count = 0;
+  gboolean stalled;
+  guint64 idle;
+  guint buffers, n_buffers;
+  gint timeout;
+
+  released = FALSE;
+
+  pipeline = gst_parse_launch ("audiotestsrc is-live=true "
+      "samplesperbuffer=441 name=blocked ! "
+      "watchdog name=wd timeout=300 instrument=true ! "
+      "fakesink sync=false name=blocked_sink "
+      "audiotestsrc is-live=true samplesperbuffer=441 name=running ! "
+      "fakesink sync=false name=running_sink "
+      "audiotestsrc is-live=true samplesperbuffer=441 name=idle ! "
+      "fakesink sync=false name=idle_sink", NULL);
+  fail_unless (pipeline != NULL);
+  block_src (pipeline, "blocked", &blocked_count);
+  block_src (pipeline, "idle", &idle_count);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  /* the stall message comes just before the error */
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_ELEMENT | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_ELEMENT);
+  stall = gst_structure_copy (gst_message_get_structure (message));
+  gst_message_unref (message);
+  fail_unless (gst_structure_has_name (stall, "watchdog-stall"));
+
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  gst_message_unref (message);
+
+  /* the pad in front of the watchdog stopped with the branch */
+  check_pad_stats (stall, "blocked", "src", TRUE);
+  s = find_pad_stats (stall, "blocked", "src");
+  fail_unless (gst_structure_get_uint (s, "buffers", &buffers));
+  fail_unless_equals_int (buffers, BLOCK_AFTER);
+
+  /* the other branch keeps running */
+  check_pad_stats (stall, "running", "src", FALSE);
+  check_pad_stats (stall, "running_sink", "sink", FALSE);
+
+  /* pads without buffers have no idle time and are not stalled */
+  s = find_pad_stats (stall, "idle", "src");
+  fail_unless (gst_structure_get_uint (s, "buffers", &buffers));
+  fail_unless_equals_int (buffers, 0);
+  fail_unless (gst_structure_get_uint64 (s, "idle", &idle));
+  fail_unless (!GST_CLOCK_TIME_IS_VALID (idle));
+  fail_unless (gst_structure_get_boolean (s, "stalled", &stalled));
+  fail_if (stalled);
+
+  fail_unless (gst_structure_get_int (stall, "timeout", &timeout));
+  fail_unless_equals_int (timeout, 300);
+  fail_unless (gst_structure_get_uint (stall, "buffers", &n_buffers));
+  fail_unless_equals_int (n_buffers, BLOCK_AFTER);
+
+  /* the stats property has the buffers that went through the watchdog */
+  watchdog = gst_bin_get_by_name (GST_BIN (pipeline), "wd");
+  g_object_get (watchdog, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats, "watchdog-stats"));
+  fail_unless (gst_structure_get_uint (stats, "buffers", &n_buffers));
+  fail_unless_equals_int (n_buffers, BLOCK_AFTER);
+  fail_unless (gst_structure_has_field_typed (stats, "gap-max",
+          G_TYPE_UINT64));
+  fail_unless (gst_structure_has_field_typed (stats, "latency-max",
+          G_TYPE_INT64));
+  gst_structure_free (stats);
+  gst_object_unref (watchdog);
+
+  gst_structure_free (stall);
+
+  /* let the blocked streaming threads go before shutting down */
+  g_mutex_lock (&block_lock);
+  released = TRUE;
+  g_cond_broadcast (&block_cond);
+  g_mutex_unlock (&block_lock);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static Suite *
+watchdog_suite (void)
+{
+  Suite *s = suite_create ("watchdog");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_stall_message);
+
+  return s;
+}
+
+GST_CHECK_MAIN (watchdog);